@@ -0,0 +1,497 @@
+/**
+ * @file BigInt.hh
+ * @author Martin
+ * @brief File containing the class representing an arbitrary precision signed integer
+*/
+#ifndef BIG_INT_H
+#define BIG_INT_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <stdexcept>
+#include <compare>
+#include <concepts>
+#include <algorithm>
+#include <utility>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+#include "ModArith.hh"
+
+/** Arbitrary precision signed integer, stored as a sign and a magnitude of 32-bit limbs */
+class BigInt {
+
+    private:
+	/** The magnitude, least significant limb first, without leading zero limbs (zero has no limbs at all) */
+	std::vector<uint32_t> m_limbs;
+	/** Whether the number is negative, never set for zero */
+	bool m_negative = false;
+
+	/** Removes leading zero limbs, and the sign of zero */
+	void trim(void) {
+	    while(!m_limbs.empty() && m_limbs.back() == 0) {
+		m_limbs.pop_back();
+	    }
+	    if(m_limbs.empty())
+		m_negative = false;
+	}
+
+	/** Compares two magnitudes, returns -1, 0 or 1 */
+	static int compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	    if(a.size() != b.size())
+		return a.size() < b.size() ? -1 : 1;
+	    for(size_t idx = a.size(); idx-- > 0;) {
+		if(a[idx] != b[idx])
+		    return a[idx] < b[idx] ? -1 : 1;
+	    }
+	    return 0;
+	}
+
+	/** Adds the magnitude b to the magnitude a (a += b) */
+	static void addMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	    if(a.size() < b.size())
+		a.resize(b.size(), 0);
+	    uint64_t carry = 0;
+	    for(size_t idx = 0; idx < a.size(); ++idx) {
+		if(idx >= b.size() && carry == 0)
+		    return;
+		uint64_t sum = static_cast<uint64_t>(a[idx]) + (idx < b.size() ? b[idx] : 0) + carry;
+		a[idx] = static_cast<uint32_t>(sum);
+		carry = sum >> 32;
+	    }
+	    if(carry != 0)
+		a.push_back(static_cast<uint32_t>(carry));
+	}
+
+	/** Subtracts the magnitude b from the magnitude a (a -= b), a must be at least as large as b */
+	static void subMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	    uint64_t borrow = 0;
+	    for(size_t idx = 0; idx < a.size(); ++idx) {
+		if(idx >= b.size() && borrow == 0)
+		    return;
+		uint64_t sub = static_cast<uint64_t>(idx < b.size() ? b[idx] : 0) + borrow;
+		borrow = a[idx] < sub ? 1 : 0;
+		a[idx] = static_cast<uint32_t>(static_cast<uint64_t>(a[idx]) - sub);
+	    }
+	}
+
+	/** Returns the product of two magnitudes (schoolbook multiplication) */
+	static std::vector<uint32_t> mulMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	    if(a.empty() || b.empty())
+		return {};
+	    std::vector<uint32_t> result (a.size() + b.size(), 0);
+	    for(size_t i = 0; i < a.size(); ++i) {
+		uint64_t ai = a[i];
+		if(ai == 0)
+		    continue;
+		uint64_t carry = 0;
+		for(size_t j = 0; j < b.size(); ++j) {
+		    /* (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1, so this never overflows */
+		    uint64_t t = ai * b[j] + result[i + j] + carry;
+		    result[i + j] = static_cast<uint32_t>(t);
+		    carry = t >> 32;
+		}
+		result[i + b.size()] = static_cast<uint32_t>(carry);
+	    }
+	    return result;
+	}
+
+	/** Multiplies a magnitude by a single limb and adds another (a = a * mul + add) */
+	static void mulAddSmall(std::vector<uint32_t>& a, uint32_t mul, uint32_t add) {
+	    uint64_t carry = add;
+	    for(uint32_t& limb : a) {
+		uint64_t t = static_cast<uint64_t>(limb) * mul + carry;
+		limb = static_cast<uint32_t>(t);
+		carry = t >> 32;
+	    }
+	    if(carry != 0)
+		a.push_back(static_cast<uint32_t>(carry));
+	}
+
+	/** Divides a magnitude by a single non-zero limb in place, returns the remainder */
+	static uint32_t divSmall(std::vector<uint32_t>& a, uint32_t divisor) {
+	    uint64_t remainder = 0;
+	    for(size_t idx = a.size(); idx-- > 0;) {
+		uint64_t cur = (remainder << 32) | a[idx];
+		a[idx] = static_cast<uint32_t>(cur / divisor);
+		remainder = cur % divisor;
+	    }
+	    while(!a.empty() && a.back() == 0) {
+		a.pop_back();
+	    }
+	    return static_cast<uint32_t>(remainder);
+	}
+
+	/** Divides the magnitude u by the non-zero magnitude v (Knuth, algorithm D), giving the quotient and remainder magnitudes */
+	static void divModMagnitude(const std::vector<uint32_t>& u, const std::vector<uint32_t>& v, std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder) {
+	    if(compareMagnitude(u, v) < 0) {
+		quotient.clear();
+		remainder = u;
+		return;
+	    }
+	    if(v.size() == 1) {
+		quotient = u;
+		uint32_t rem = divSmall(quotient, v[0]);
+		remainder.clear();
+		if(rem != 0)
+		    remainder.push_back(rem);
+		return;
+	    }
+	    size_t n = v.size();
+	    size_t m = u.size() - n;
+	    /* Normalize so the top limb of the divisor has its highest bit set, which keeps the quotient estimates off by at most two */
+	    int shift = std::countl_zero(v.back());
+	    std::vector<uint32_t> vn (n);
+	    std::vector<uint32_t> un (u.size() + 1);
+	    for(size_t idx = n - 1; idx > 0; --idx) {
+		vn[idx] = (v[idx] << shift) | (shift != 0 ? v[idx - 1] >> (32 - shift) : 0);
+	    }
+	    vn[0] = v[0] << shift;
+	    un[u.size()] = shift != 0 ? u.back() >> (32 - shift) : 0;
+	    for(size_t idx = u.size() - 1; idx > 0; --idx) {
+		un[idx] = (u[idx] << shift) | (shift != 0 ? u[idx - 1] >> (32 - shift) : 0);
+	    }
+	    un[0] = u[0] << shift;
+
+	    quotient.assign(m + 1, 0);
+	    constexpr uint64_t base = uint64_t{1} << 32;
+	    for(size_t j = m + 1; j-- > 0;) {
+		/* Estimate the quotient limb from the top two limbs, then correct it with the third */
+		uint64_t numerator = (static_cast<uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+		uint64_t qhat = numerator / vn[n - 1];
+		uint64_t rhat = numerator % vn[n - 1];
+		while(qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+		    --qhat;
+		    rhat += vn[n - 1];
+		    if(rhat >= base)
+			break;
+		}
+		/* Multiply and subtract */
+		int64_t borrow = 0;
+		for(size_t idx = 0; idx < n; ++idx) {
+		    uint64_t product = qhat * vn[idx];
+		    int64_t t = static_cast<int64_t>(un[idx + j]) - borrow - static_cast<int64_t>(product & 0xFFFFFFFFu);
+		    un[idx + j] = static_cast<uint32_t>(t);
+		    borrow = static_cast<int64_t>(product >> 32) - (t >> 32);
+		}
+		int64_t t = static_cast<int64_t>(un[j + n]) - borrow;
+		un[j + n] = static_cast<uint32_t>(t);
+		quotient[j] = static_cast<uint32_t>(qhat);
+		/* The estimate was one too large, add the divisor back */
+		if(t < 0) {
+		    --quotient[j];
+		    uint64_t carry = 0;
+		    for(size_t idx = 0; idx < n; ++idx) {
+			uint64_t sum = static_cast<uint64_t>(un[idx + j]) + vn[idx] + carry;
+			un[idx + j] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		    }
+		    un[j + n] += static_cast<uint32_t>(carry);
+		}
+	    }
+	    while(!quotient.empty() && quotient.back() == 0) {
+		quotient.pop_back();
+	    }
+	    /* Unnormalize the remainder */
+	    remainder.assign(n, 0);
+	    for(size_t idx = 0; idx < n; ++idx) {
+		remainder[idx] = (un[idx] >> shift) | (shift != 0 ? un[idx + 1] << (32 - shift) : 0);
+	    }
+	    while(!remainder.empty() && remainder.back() == 0) {
+		remainder.pop_back();
+	    }
+	}
+
+	/** Adds rhs, negated if requested, to this number */
+	BigInt& addSigned(const BigInt& rhs, bool negateRhs) {
+	    if(this == &rhs) {
+		BigInt copy = rhs;
+		return addSigned(copy, negateRhs);
+	    }
+	    bool rhsNegative = rhs.m_negative != negateRhs;
+	    if(m_negative == rhsNegative) {
+		addMagnitude(m_limbs, rhs.m_limbs);
+	    } else if(compareMagnitude(m_limbs, rhs.m_limbs) >= 0) {
+		subMagnitude(m_limbs, rhs.m_limbs);
+	    } else {
+		std::vector<uint32_t> result = rhs.m_limbs;
+		subMagnitude(result, m_limbs);
+		m_limbs = std::move(result);
+		m_negative = rhsNegative;
+	    }
+	    trim();
+	    return *this;
+	}
+
+    public:
+	/** Constructor creating a BigInt set to zero */
+	BigInt(void) = default;
+
+	/** Constructor creating a BigInt from any integer type */
+	template <std::integral I> requires (!std::same_as<I, bool>)
+	BigInt(I value) {
+	    uint64_t magnitude;
+	    if constexpr (std::is_signed_v<I>) {
+		m_negative = value < 0;
+		magnitude = m_negative ? uint64_t{0} - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+	    } else {
+		magnitude = value;
+	    }
+	    while(magnitude != 0) {
+		m_limbs.push_back(static_cast<uint32_t>(magnitude));
+		magnitude >>= 32;
+	    }
+	}
+
+	/** Constructor creating a BigInt from a string of decimal digits with an optional sign */
+	explicit BigInt(std::string_view number) {
+	    *this = BigInt::fromString(number);
+	}
+
+	/** Static member function that creates a BigInt from a string of decimal digits with an optional sign */
+	static BigInt fromString(std::string_view number) {
+	    BigInt result;
+	    bool negative = false;
+	    if(!number.empty() && (number[0] == '-' || number[0] == '+')) {
+		negative = number[0] == '-';
+		number.remove_prefix(1);
+	    }
+	    if(number.empty())
+		throw std::runtime_error {"BigInt Error: Invalid string format specified!"};
+	    /* Consume up to nine digits at a time, which fit into a single limb */
+	    while(!number.empty()) {
+		size_t count = std::min<size_t>(number.size(), 9);
+		uint32_t chunk = 0, scale = 1;
+		for(size_t idx = 0; idx < count; ++idx) {
+		    if(number[idx] < '0' || number[idx] > '9')
+			throw std::runtime_error {"BigInt Error: Invalid string format specified!"};
+		    chunk = chunk * 10 + static_cast<uint32_t>(number[idx] - '0');
+		    scale *= 10;
+		}
+		mulAddSmall(result.m_limbs, scale, chunk);
+		number.remove_prefix(count);
+	    }
+	    result.m_negative = negative;
+	    result.trim();
+	    return result;
+	}
+
+	/** Returns whether the number is zero */
+	bool isZero(void) const {
+	    return m_limbs.empty();
+	}
+
+	/** Returns whether the number is negative */
+	bool isNegative(void) const {
+	    return m_negative;
+	}
+
+	/** Returns -1, 0 or 1 depending on the sign of the number */
+	int sign(void) const {
+	    return m_limbs.empty() ? 0 : (m_negative ? -1 : 1);
+	}
+
+	/** Returns the number of bits of the magnitude */
+	size_t bitLength(void) const {
+	    if(m_limbs.empty())
+		return 0;
+	    return (m_limbs.size() * 32) - static_cast<size_t>(std::countl_zero(m_limbs.back()));
+	}
+
+	/** Returns the absolute value */
+	BigInt abs(void) const {
+	    BigInt result = *this;
+	    result.m_negative = false;
+	    return result;
+	}
+
+	/** Switches the sign of the number */
+	BigInt& negate(void) {
+	    if(!m_limbs.empty())
+		m_negative = !m_negative;
+	    return *this;
+	}
+
+	/** Returns whether the number fits into an int64_t */
+	bool fitsInt64(void) const {
+	    if(m_limbs.size() > 2)
+		return false;
+	    uint64_t magnitude = toMagnitude64();
+	    return magnitude <= (m_negative ? uint64_t{1} << 63 : (uint64_t{1} << 63) - 1);
+	}
+
+	/** Returns the number as an int64_t, throws if it doesn't fit */
+	int64_t toInt64(void) const {
+	    if(!fitsInt64())
+		throw std::runtime_error {"BigInt Error: Value out of range!"};
+	    uint64_t magnitude = toMagnitude64();
+	    return m_negative ? static_cast<int64_t>(uint64_t{0} - magnitude) : static_cast<int64_t>(magnitude);
+	}
+
+	/** Returns the lowest 64 bits of the magnitude */
+	uint64_t toMagnitude64(void) const {
+	    uint64_t magnitude = 0;
+	    if(m_limbs.size() > 0)
+		magnitude = m_limbs[0];
+	    if(m_limbs.size() > 1)
+		magnitude |= static_cast<uint64_t>(m_limbs[1]) << 32;
+	    return magnitude;
+	}
+
+	/** Returns the number modulo the given non-zero modulus, as a value in [0, modulus) */
+	uint64_t residue(uint64_t modulus) const {
+	    unsigned __int128 remainder = 0;
+	    for(size_t idx = m_limbs.size(); idx-- > 0;) {
+		remainder = ((remainder << 32) | m_limbs[idx]) % modulus;
+	    }
+	    uint64_t result = static_cast<uint64_t>(remainder);
+	    return (m_negative && result != 0) ? modulus - result : result;
+	}
+
+	/** Returns the nearest floating point representation of the number */
+	double toDouble(void) const {
+	    double result = 0.0;
+	    for(size_t idx = m_limbs.size(); idx-- > 0;) {
+		result = result * 4294967296.0 + m_limbs[idx];
+	    }
+	    return m_negative ? -result : result;
+	}
+
+	/** Returns the decimal string representation of the number */
+	std::string toString(void) const {
+	    std::string result;
+	    appendTo(result);
+	    return result;
+	}
+
+	/** Appends the decimal digits of the integer to out */
+	void appendTo(std::string& out) const {
+	    if(m_limbs.empty()) {
+		out += '0';
+		return;
+	    }
+	    /* Split off nine decimal digits at a time, least significant first */
+	    std::vector<uint32_t> magnitude = m_limbs;
+	    std::vector<uint32_t> chunks;
+	    while(!magnitude.empty()) {
+		chunks.push_back(divSmall(magnitude, 1000000000u));
+	    }
+	    char digits[16];
+	    if(m_negative)
+		out += '-';
+	    out.append(digits, std::to_chars(digits, digits + sizeof(digits), chunks.back()).ptr);
+	    for(size_t idx = chunks.size() - 1; idx-- > 0;) {
+		char* end = std::to_chars(digits, digits + sizeof(digits), chunks[idx]).ptr;
+		out.append(9 - static_cast<size_t>(end - digits), '0');
+		out.append(digits, end);
+	    }
+	}
+
+	/** Divides a by b, truncating towards zero like the built-in integers, giving the quotient and the remainder */
+	static void divMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+	    if(b.isZero())
+		throw std::runtime_error {"BigInt Error: Division by zero!"};
+	    bool quotientNegative = a.m_negative != b.m_negative;
+	    bool remainderNegative = a.m_negative;
+	    divModMagnitude(a.m_limbs, b.m_limbs, quotient.m_limbs, remainder.m_limbs);
+	    quotient.m_negative = quotientNegative;
+	    remainder.m_negative = remainderNegative;
+	    quotient.trim();
+	    remainder.trim();
+	}
+
+	/** Returns the greatest common divisor of the magnitudes of a and b.
+	  * Euclid's algorithm shrinks the operands until both fit into a word, the rest is done by the binary algorithm.
+	  */
+	friend BigInt gcd(BigInt a, BigInt b) {
+	    a.m_negative = false;
+	    b.m_negative = false;
+	    BigInt quotient, remainder;
+	    while(!b.isZero()) {
+		if(a.m_limbs.size() <= 2 && b.m_limbs.size() <= 2)
+		    return BigInt{ModArith::binaryGcd(a.toMagnitude64(), b.toMagnitude64())};
+		divMod(a, b, quotient, remainder);
+		a = std::move(b);
+		b = std::move(remainder);
+		remainder = BigInt{};
+	    }
+	    return a;
+	}
+
+	/* --- Comparison Operators --- */
+
+	friend bool operator==(const BigInt& lhs, const BigInt& rhs) = default;
+
+	friend std::strong_ordering operator<=>(const BigInt& lhs, const BigInt& rhs) {
+	    if(lhs.m_negative != rhs.m_negative)
+		return lhs.m_negative ? std::strong_ordering::less : std::strong_ordering::greater;
+	    int cmp = compareMagnitude(lhs.m_limbs, rhs.m_limbs);
+	    if(lhs.m_negative)
+		cmp = -cmp;
+	    return cmp < 0 ? std::strong_ordering::less : (cmp > 0 ? std::strong_ordering::greater : std::strong_ordering::equal);
+	}
+
+	/* --- Arithmetic Operators --- */
+
+	BigInt& operator+=(const BigInt& rhs) {
+	    return addSigned(rhs, false);
+	}
+
+	BigInt& operator-=(const BigInt& rhs) {
+	    return addSigned(rhs, true);
+	}
+
+	BigInt& operator*=(const BigInt& rhs) {
+	    m_limbs = mulMagnitude(m_limbs, rhs.m_limbs);
+	    m_negative = m_negative != rhs.m_negative;
+	    trim();
+	    return *this;
+	}
+
+	BigInt& operator/=(const BigInt& rhs) {
+	    BigInt quotient, remainder;
+	    divMod(*this, rhs, quotient, remainder);
+	    return *this = std::move(quotient);
+	}
+
+	BigInt& operator%=(const BigInt& rhs) {
+	    BigInt quotient, remainder;
+	    divMod(*this, rhs, quotient, remainder);
+	    return *this = std::move(remainder);
+	}
+
+	BigInt operator-(void) const {
+	    BigInt result = *this;
+	    return result.negate();
+	}
+
+	friend BigInt operator+(BigInt lhs, const BigInt& rhs) {
+	    lhs += rhs;
+	    return lhs;
+	}
+
+	friend BigInt operator-(BigInt lhs, const BigInt& rhs) {
+	    lhs -= rhs;
+	    return lhs;
+	}
+
+	friend BigInt operator*(BigInt lhs, const BigInt& rhs) {
+	    lhs *= rhs;
+	    return lhs;
+	}
+
+	friend BigInt operator/(BigInt lhs, const BigInt& rhs) {
+	    lhs /= rhs;
+	    return lhs;
+	}
+
+	friend BigInt operator%(BigInt lhs, const BigInt& rhs) {
+	    lhs %= rhs;
+	    return lhs;
+	}
+};
+
+#endif /* BIG_INT_H */
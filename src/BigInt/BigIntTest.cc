@@ -0,0 +1,246 @@
+/**
+ * @file BigIntTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the BigInt class
+*/
+
+#include "BigIntTest.hh"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+void constructorTest(void) {
+
+    /* Integer constructors */
+    BigInt i1;
+    BigInt i2 {42};
+    BigInt i3 {-42};
+    BigInt i4 {std::numeric_limits<int64_t>::min()};
+    BigInt i5 {std::numeric_limits<uint64_t>::max()};
+
+    assert(i1.isZero() && i1.sign() == 0 && i1.toString() == "0");
+    assert(i2.sign() == 1 && i2.toString() == "42");
+    assert(i3.isNegative() && i3.toString() == "-42");
+    assert(i4.toString() == "-9223372036854775808");
+    assert(i5.toString() == "18446744073709551615");
+
+    /* String constructors */
+    BigInt s1 {"123456789012345678901234567890"};
+    BigInt s2 {"-000000000000000000001"};
+    BigInt s3 {"+0"};
+
+    assert(s1.toString() == "123456789012345678901234567890");
+    assert(s2 == BigInt{-1});
+    assert(s3.isZero() && !s3.isNegative());
+
+    int caught = 0;
+    try {
+	BigInt bad {"12a"};
+    } catch(std::exception& e) {
+	++caught;
+    }
+    try {
+	BigInt bad {"-"};
+    } catch(std::exception& e) {
+	++caught;
+    }
+    assert(caught == 2);
+}
+
+void conversionTest(void) {
+
+    assert(BigInt{std::numeric_limits<int64_t>::max()}.fitsInt64());
+    assert(BigInt{std::numeric_limits<int64_t>::min()}.fitsInt64());
+    assert(!BigInt{std::numeric_limits<uint64_t>::max()}.fitsInt64());
+    assert(BigInt{std::numeric_limits<int64_t>::min()}.toInt64() == std::numeric_limits<int64_t>::min());
+    assert(BigInt{-12345}.toInt64() == -12345);
+    assert(BigInt{"-1000000000000"}.toDouble() == -1e12);
+    assert(BigInt{1}.bitLength() == 1 && BigInt{"4294967296"}.bitLength() == 33 && BigInt{}.bitLength() == 0);
+
+    bool caught = false;
+    try {
+	BigInt{"9223372036854775808"}.toInt64();
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void comparisonTest(void) {
+
+    BigInt a {"-100000000000000000000"};
+    BigInt b {-5};
+    BigInt c {7};
+    BigInt d {"100000000000000000000"};
+
+    assert(a < b && b < c && c < d);
+    assert(d > a && c >= c && b <= c);
+    assert(a != d && -a == d);
+    assert(c == 7 && b < 0 && 0 < c);
+}
+
+void arithmeticTest(void) {
+
+    BigInt a {"123456789012345678901234567890"};
+    BigInt b {"987654321098765432109876543210"};
+
+    assert((a + b).toString() == "1111111110111111111011111111100");
+    assert((a - b).toString() == "-864197532086419753208641975320");
+    assert((b - a).toString() == "864197532086419753208641975320");
+    assert((a * b).toString() == "121932631137021795226185032733622923332237463801111263526900");
+    assert((a * -b) == -(a * b));
+    assert(a - a == 0 && (a + -a).sign() == 0);
+
+    /* Carries across limbs */
+    BigInt max64 {std::numeric_limits<uint64_t>::max()};
+    assert((max64 + 1).toString() == "18446744073709551616");
+    assert((max64 + 1 - 1) == max64);
+
+    /* Self-assignment operators */
+    BigInt s {5};
+    s += s;
+    assert(s == 10);
+    s -= s;
+    assert(s.isZero());
+}
+
+void divisionTest(void) {
+
+    BigInt a {"121932631137021795226185032733622923332237463801111263526900"};
+    BigInt b {"987654321098765432109876543210"};
+
+    assert(a / b == BigInt{"123456789012345678901234567890"});
+    assert(a % b == 0);
+    assert((a + 17) % b == 17);
+
+    /* Truncation towards zero, the remainder takes the sign of the dividend */
+    assert(BigInt{-7} / BigInt{2} == -3 && BigInt{-7} % BigInt{2} == -1);
+    assert(BigInt{7} / BigInt{-2} == -3 && BigInt{7} % BigInt{-2} == 1);
+
+    /* Multi-limb divisors, exercising the quotient correction */
+    BigInt c {"340282366920938463463374607431768211455"};
+    BigInt d {"18446744073709551617"};
+    assert(c / d == BigInt{"18446744073709551615"});
+    assert(c % d == 0);
+    BigInt e {"79228162514264337593543950335"};
+    BigInt f {"4294967296"};
+    assert((e * f + 12345) / f == e && (e * f + 12345) % f == 12345);
+    BigInt q, r;
+    BigInt::divMod(b, e, q, r);
+    assert(q * e + r == b && r < e && r >= 0);
+
+    /* Pseudo-random operands of varying lengths must satisfy a = q * b + r with |r| < |b| */
+    uint64_t state = 88172645463325252u;
+    auto next = [&state]() {
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+    };
+    for(int round = 0; round < 200; ++round) {
+	BigInt x {next()}, y {next() >> (next() % 64)};
+	for(uint64_t limbs = next() % 6; limbs > 0; --limbs) {
+	    x = x * BigInt{next()} + BigInt{next()};
+	}
+	for(uint64_t limbs = next() % 4; limbs > 0; --limbs) {
+	    y = y * BigInt{next() >> (next() % 64)} + BigInt{next() % 3};
+	}
+	if(y.isZero())
+	    continue;
+	if(round % 2 == 1)
+	    x.negate();
+	BigInt::divMod(x, y, q, r);
+	assert(q * y + r == x);
+	assert(r.abs() < y.abs());
+	assert(r.isZero() || r.isNegative() == x.isNegative());
+    }
+
+    bool caught = false;
+    try {
+	a /= BigInt{};
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void gcdTest(void) {
+
+    assert(gcd(BigInt{12}, BigInt{-18}) == 6);
+    assert(gcd(BigInt{0}, BigInt{-5}) == 5);
+    assert(gcd(BigInt{0}, BigInt{0}) == 0);
+    BigInt p {"170141183460469231731687303715884105727"};
+    BigInt q {"2305843009213693951"};
+    assert(gcd(p * q * 6, q * 10) == q * 2);
+
+    /* Binary gcd on words */
+    assert(ModArith::binaryGcd(0, 7) == 7 && ModArith::binaryGcd(7, 0) == 7 && ModArith::binaryGcd(0, 0) == 0);
+    assert(ModArith::binaryGcd(48, 180) == 12 && ModArith::binaryGcd(uint64_t{1} << 63, uint64_t{3} << 40) == uint64_t{1} << 40);
+    assert(ModArith::binaryGcd(2305843009213693951u * 4, 2305843009213693951u * 6) == 2305843009213693951u * 2);
+
+    /* Lane-parallel gcd, over more pairs than one block of lanes */
+    uint64_t a[19], b[19], g[19];
+    for(uint64_t idx = 0; idx < 19; ++idx) {
+	a[idx] = (idx * 7919) % 97 * (uint64_t{1} << (idx % 5)) * 12;
+	b[idx] = (idx * 104729) % 89 * 18;
+    }
+    ModArith::binaryGcdLanes(a, b, g, 19);
+    for(size_t idx = 0; idx < 19; ++idx) {
+	assert(g[idx] == ModArith::binaryGcd(a[idx], b[idx]));
+    }
+}
+
+void modArithTest(void) {
+
+    /* Residues of negative numbers are non-negative */
+    assert(BigInt{-7}.residue(5) == 3 && BigInt{35}.residue(5) == 0);
+    assert(BigInt{"340282366920938463463374607431768211457"}.residue(uint64_t{1} << 62) == 1);
+
+    assert(ModArith::isPrime(2) && ModArith::isPrime(97) && !ModArith::isPrime(1) && !ModArith::isPrime(91));
+    /* Strong pseudoprime to several small bases */
+    assert(!ModArith::isPrime(3215031751u));
+    assert(ModArith::isPrime(2305843009213693951u));
+    assert(ModArith::prevPrime(100) == 97);
+    uint64_t p = ModArith::prevPrime(MOD_ARITH_PRIME_LIMIT);
+    assert(p == 4611686018427387847u);
+
+    assert(ModArith::mulMod(p - 1, p - 1, p) == 1);
+    assert(ModArith::subMod(1, 2, p) == p - 1 && ModArith::addMod(p - 1, 2, p) == 1);
+    uint64_t inverse = ModArith::invMod(123456789, p);
+    assert(ModArith::mulMod(123456789, inverse, p) == 1);
+    assert(ModArith::powMod(3, p - 1, p) == 1);
+
+    bool caught = false;
+    try {
+	ModArith::invMod(6, 9);
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+} /* anonymous */
+
+void bigIntTest(void) {
+
+    std::puts("--- BigInt TC Running ---");
+    constructorTest();
+    std::puts("-> Passed constructorTest()");
+    conversionTest();
+    std::puts("-> Passed conversionTest()");
+    comparisonTest();
+    std::puts("-> Passed comparisonTest()");
+    arithmeticTest();
+    std::puts("-> Passed arithmeticTest()");
+    divisionTest();
+    std::puts("-> Passed divisionTest()");
+    gcdTest();
+    std::puts("-> Passed gcdTest()");
+    modArithTest();
+    std::puts("-> Passed modArithTest()");
+
+    std::puts("--- BigInt Tests Passed ---");
+}
@@ -0,0 +1,18 @@
+/**
+ * @file BigIntTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the BigInt class
+*/
+#ifndef BIG_INT_TEST_H
+#define BIG_INT_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "BigInt.hh"
+#include "ModArith.hh"
+
+/** BigInt test function, collecting all test cases for the BigInt class */
+void bigIntTest(void);
+
+#endif /* BIG_INT_TEST_H */
@@ -0,0 +1,171 @@
+/**
+ * @file ModArith.hh
+ * @author Martin
+ * @brief File containing modular arithmetic on word-sized moduli, used by the multi-modular exact algorithms
+*/
+#ifndef MOD_ARITH_H
+#define MOD_ARITH_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <bit>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+/** Largest modulus used by the multi-modular algorithms, products of two residues still fit into 128 bits with room to spare */
+#define MOD_ARITH_PRIME_LIMIT (uint64_t{1} << 62)
+
+/** Number of independent gcd computations binaryGcdLanes advances together, in lock step */
+#define MOD_ARITH_GCD_LANES 8
+
+/** Namespace containing arithmetic modulo word-sized numbers */
+namespace ModArith {
+
+    /** Returns the greatest common divisor of a and b by Stein's binary algorithm, which only shifts and subtracts */
+    inline uint64_t binaryGcd(uint64_t a, uint64_t b) {
+	if(a == 0)
+	    return b;
+	if(b == 0)
+	    return a;
+	/* The common power of two is put back at the end */
+	int shift = std::countr_zero(a | b);
+	a >>= std::countr_zero(a);
+	do {
+	    b >>= std::countr_zero(b);
+	    if(a > b)
+		std::swap(a, b);
+	    b -= a;
+	} while(b != 0);
+	return a << shift;
+    }
+
+    /** Computes result[idx] = gcd(a[idx], b[idx]) for count pairs, advancing blocks of lanes through the binary algorithm together.
+      * Every step is the same branch-free shift, minimum and subtraction for all lanes of a block, so the compiler can map the lanes
+      * onto vector registers. A block finishes once its slowest lane does.
+      */
+    inline void binaryGcdLanes(const uint64_t* a, const uint64_t* b, uint64_t* result, size_t count) {
+	for(size_t base = 0; base < count; base += MOD_ARITH_GCD_LANES) {
+	    size_t lanes = std::min<size_t>(MOD_ARITH_GCD_LANES, count - base);
+	    uint64_t u[MOD_ARITH_GCD_LANES] = {};
+	    uint64_t v[MOD_ARITH_GCD_LANES] = {};
+	    int shift[MOD_ARITH_GCD_LANES] = {};
+	    for(size_t lane = 0; lane < lanes; ++lane) {
+		uint64_t x = a[base + lane], y = b[base + lane];
+		/* gcd(0, y) = y, which the loop gives by starting with u = y and v = 0 */
+		shift[lane] = std::countr_zero(x | y) & 63;
+		u[lane] = x != 0 ? x : y;
+		v[lane] = x != 0 ? y : 0;
+		u[lane] >>= std::countr_zero(u[lane]) & 63;
+	    }
+	    bool active = true;
+	    while(active) {
+		active = false;
+		for(size_t lane = 0; lane < MOD_ARITH_GCD_LANES; ++lane) {
+		    uint64_t w = v[lane] >> (std::countr_zero(v[lane]) & 63);
+		    uint64_t low = std::min(u[lane], w);
+		    uint64_t high = std::max(u[lane], w);
+		    u[lane] = v[lane] != 0 ? low : u[lane];
+		    v[lane] = v[lane] != 0 ? high - low : 0;
+		    active |= v[lane] != 0;
+		}
+	    }
+	    for(size_t lane = 0; lane < lanes; ++lane) {
+		result[base + lane] = u[lane] << shift[lane];
+	    }
+	}
+    }
+
+    /** Returns (a * b) mod m, for a and b already reduced mod m */
+    inline uint64_t mulMod(uint64_t a, uint64_t b, uint64_t m) {
+	return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) % m);
+    }
+
+    /** Returns (a + b) mod m, for a and b already reduced mod m */
+    inline uint64_t addMod(uint64_t a, uint64_t b, uint64_t m) {
+	uint64_t sum = a + b;
+	return sum >= m ? sum - m : sum;
+    }
+
+    /** Returns (a - b) mod m, for a and b already reduced mod m */
+    inline uint64_t subMod(uint64_t a, uint64_t b, uint64_t m) {
+	return a >= b ? a - b : a + (m - b);
+    }
+
+    /** Returns (base ^ exponent) mod m */
+    inline uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t m) {
+	uint64_t result = 1 % m;
+	base %= m;
+	while(exponent != 0) {
+	    if(exponent & 1)
+		result = mulMod(result, base, m);
+	    base = mulMod(base, base, m);
+	    exponent >>= 1;
+	}
+	return result;
+    }
+
+    /** Returns the inverse of a modulo m (extended Euclid), throws if a is not invertible */
+    inline uint64_t invMod(uint64_t a, uint64_t m) {
+	int64_t t = 0, newT = 1;
+	uint64_t r = m, newR = a % m;
+	while(newR != 0) {
+	    uint64_t q = r / newR;
+	    int64_t nextT = t - static_cast<int64_t>(q) * newT;
+	    t = newT;
+	    newT = nextT;
+	    uint64_t nextR = r - q * newR;
+	    r = newR;
+	    newR = nextR;
+	}
+	if(r != 1)
+	    throw std::runtime_error {"ModArith Error: Value has no inverse!"};
+	return t < 0 ? static_cast<uint64_t>(t + static_cast<int64_t>(m)) : static_cast<uint64_t>(t);
+    }
+
+    /** Deterministic Miller-Rabin primality test, exact for all 64-bit numbers */
+    inline bool isPrime(uint64_t n) {
+	if(n < 2)
+	    return false;
+	for(uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+	    if(n % p == 0)
+		return n == p;
+	}
+	uint64_t d = n - 1;
+	int s = 0;
+	while((d & 1) == 0) {
+	    d >>= 1;
+	    ++s;
+	}
+	/* These bases are sufficient for every n < 3.3 * 10^24 */
+	for(uint64_t a : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+	    uint64_t x = powMod(a, d, n);
+	    if(x == 1 || x == n - 1)
+		continue;
+	    bool composite = true;
+	    for(int r = 1; r < s && composite; ++r) {
+		x = mulMod(x, x, n);
+		composite = x != n - 1;
+	    }
+	    if(composite)
+		return false;
+	}
+	return true;
+    }
+
+    /** Returns the largest prime smaller than n */
+    inline uint64_t prevPrime(uint64_t n) {
+	if(n <= 3)
+	    throw std::runtime_error {"ModArith Error: No smaller prime available!"};
+	uint64_t candidate = n - 1;
+	if(candidate > 2 && (candidate & 1) == 0)
+	    --candidate;
+	while(!isPrime(candidate)) {
+	    candidate -= 2;
+	}
+	return candidate;
+    }
+
+} /* namespace ModArith */
+
+#endif /* MOD_ARITH_H */
@@ -0,0 +1,24 @@
+/**
+ * @file IOTestUtil.hh
+ * @author Martin
+ * @brief File containing the temporary file helper shared by the IO test cases
+*/
+#ifndef IO_TEST_UTIL_H
+#define IO_TEST_UTIL_H
+
+#include <string>
+#include <filesystem>
+
+#include <unistd.h>
+
+/** Namespace containing helpers of the IO test cases */
+namespace IOTestUtil {
+
+    /** Returns a path with the given extension for a temporary test file, unique to this process */
+    inline std::string tempPath(const char* name, const char* extension) {
+	return (std::filesystem::temp_directory_path() / (std::string{name} + "-" + std::to_string(getpid()) + extension)).string();
+    }
+
+} /* namespace IOTestUtil */
+
+#endif /* IO_TEST_UTIL_H */
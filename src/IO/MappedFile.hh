@@ -0,0 +1,97 @@
+/**
+ * @file MappedFile.hh
+ * @author Martin
+ * @brief File containing a read-only memory mapping of a whole file
+*/
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** Whole file mapped read-only into memory, unmapped when destroyed.
+  * Pages are read in by the system when first accessed, so opening even a large file is cheap.
+  */
+class MappedFile {
+
+    private:
+	/** The mapping, or null for an empty file */
+	void* m_mapping = nullptr;
+	/** The size of the mapping in bytes */
+	size_t m_size = 0;
+
+	/** Unmaps the file */
+	void unmap(void) {
+	    if(m_mapping != nullptr)
+		munmap(m_mapping, m_size);
+	    m_mapping = nullptr;
+	    m_size = 0;
+	}
+
+    public:
+	/** Constructor, maps the file at the given path, throws if it can't be opened */
+	explicit MappedFile(const std::string& path) {
+	    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	    if(fd < 0)
+		throw std::runtime_error {"File Error: Can't open " + path};
+	    struct stat info;
+	    if(fstat(fd, &info) != 0 || info.st_size < 0) {
+		::close(fd);
+		throw std::runtime_error {"File Error: Can't read the size of " + path};
+	    }
+	    /* Empty files can't be mapped, they stay without a mapping */
+	    size_t size = static_cast<size_t>(info.st_size);
+	    void* mapping = size == 0 ? nullptr : mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	    /* The mapping stays valid after the descriptor is closed */
+	    ::close(fd);
+	    if(mapping == MAP_FAILED)
+		throw std::runtime_error {"File Error: Can't map " + path};
+	    m_mapping = mapping;
+	    m_size = size;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/** Move constructor, takes over the mapping of other */
+	MappedFile(MappedFile&& other) noexcept : m_mapping{std::exchange(other.m_mapping, nullptr)}, m_size{std::exchange(other.m_size, 0)} {}
+
+	/** Move assignment, unmaps the current file and takes over the mapping of other */
+	MappedFile& operator=(MappedFile&& other) noexcept {
+	    if(this != &other) {
+		unmap();
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+	    }
+	    return *this;
+	}
+
+	/** Destructor, unmaps the file, pointers into it are invalid afterwards */
+	~MappedFile(void) {
+	    unmap();
+	}
+
+	/** Returns the first byte of the file */
+	const unsigned char* data(void) const {
+	    return static_cast<const unsigned char*>(m_mapping);
+	}
+
+	/** Returns the size of the file in bytes */
+	size_t size(void) const {
+	    return m_size;
+	}
+
+	/** Returns the contents of the file as text */
+	std::string_view text(void) const {
+	    return {static_cast<const char*>(m_mapping), m_size};
+	}
+};
+
+#endif /* MAPPED_FILE_H */
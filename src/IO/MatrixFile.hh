@@ -0,0 +1,247 @@
+/**
+ * @file MatrixFile.hh
+ * @author Martin
+ * @brief File containing the binary Matrix file format, written in one call and opened by memory mapping without copying
+*/
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "MappedFile.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Matrix/MatrixView.hh"
+
+/** Version of the binary Matrix file format written by MatrixFile */
+#define MATRIX_FILE_VERSION 1
+/** Alignment of the element data within a binary Matrix file, the mapping itself is page aligned */
+#define MATRIX_FILE_ALIGNMENT 64
+
+/** Order of the elements in a binary Matrix file */
+enum class MatrixFileOrder : uint32_t {
+    /** Row after row, each row contiguous */
+    RowMajor = 0,
+    /** Column after column, each column contiguous */
+    ColumnMajor = 1
+};
+
+/** Header at the start of a binary Matrix file, followed by the element data at dataOffset.
+  * The fixed byte-order mark rejects files written on a machine of different endianness.
+  */
+struct MatrixFileHeader {
+    /** Identifies the file format */
+    char magic[8];
+    /** byteOrderMark as stored by the writing machine */
+    uint32_t byteOrder;
+    /** MATRIX_FILE_VERSION of the writer */
+    uint32_t version;
+    /** Kind of number (1 unsigned integer, 2 signed integer, 3 floating point) in the upper bits, byte width in the lower byte */
+    uint32_t elementType;
+    /** Size of a single element in bytes */
+    uint32_t elementSize;
+    /** A MatrixFileOrder */
+    uint32_t order;
+    /** Alignment of the data offset */
+    uint32_t alignment;
+    /** Shape of the Matrix */
+    uint64_t cols;
+    uint64_t rows;
+    /** Position of the first element, from the start of the file */
+    uint64_t dataOffset;
+    /** Zero, reserved for later versions */
+    uint64_t reserved;
+
+    /** The magic bytes, "MTXBIN" followed by two zeros */
+    static constexpr char fileMagic[8] = {'M', 'T', 'X', 'B', 'I', 'N', '\0', '\0'};
+    /** Byte-order mark */
+    static constexpr uint32_t byteOrderMark = 0x01020304;
+
+    /** Whether the given bytes start with the magic bytes of a binary Matrix file */
+    static bool hasMagic(const unsigned char* file, size_t size) {
+	return size >= sizeof(fileMagic) && std::memcmp(file, fileMagic, sizeof(fileMagic)) == 0;
+    }
+
+    /** Returns the element type code of the given element type */
+    template <typename T>
+    static constexpr uint32_t typeCode(void) {
+	uint32_t kind = std::is_floating_point_v<T> ? 3 : (std::is_signed_v<T> ? 2 : 1);
+	return (kind << 8) | static_cast<uint32_t>(sizeof(T));
+    }
+};
+static_assert(sizeof(MatrixFileHeader) == 64 && MATRIX_FILE_ALIGNMENT % sizeof(MatrixFileHeader) == 0);
+
+/** Binary Matrix file opened by memory mapping, so the view of the Matrix lies directly over the file pages.
+  * Opening reads and validates only the header, elements are paged in by the system when first accessed, and nothing
+  * is parsed or copied. Only plain numbers can be stored, as their bytes are their values.
+  */
+template <typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+class MatrixFile {
+
+    private:
+	/** The mapped file */
+	MappedFile m_file;
+	/** The view of the elements within the mapping */
+	MatrixView<const T> m_view {nullptr, 0, 0, 0, 1};
+
+	/** Validates the header against the file size, returns the view of the elements */
+	static MatrixView<const T> checkHeader(const unsigned char* file, size_t size) {
+	    if(size < sizeof(MatrixFileHeader))
+		throw std::runtime_error {"File Error: File too small for a Matrix header"};
+	    MatrixFileHeader header;
+	    std::memcpy(&header, file, sizeof(header));
+	    if(std::memcmp(header.magic, MatrixFileHeader::fileMagic, sizeof(header.magic)) != 0)
+		throw std::runtime_error {"File Error: Not a binary Matrix file"};
+	    if(header.byteOrder != MatrixFileHeader::byteOrderMark)
+		throw std::runtime_error {"File Error: Matrix file written with a different byte order"};
+	    if(header.version != MATRIX_FILE_VERSION)
+		throw std::runtime_error {"File Error: Unsupported Matrix file version"};
+	    if(header.elementType != MatrixFileHeader::typeCode<T>() || header.elementSize != sizeof(T))
+		throw std::runtime_error {"File Error: Matrix file has a different element type"};
+	    if(header.order > static_cast<uint32_t>(MatrixFileOrder::ColumnMajor))
+		throw std::runtime_error {"File Error: Unknown storage order in Matrix file"};
+	    if(header.dataOffset < sizeof(MatrixFileHeader) || header.dataOffset % alignof(T) != 0)
+		throw std::runtime_error {"File Error: Misaligned data in Matrix file"};
+	    uint64_t count, bytes, end;
+	    if(__builtin_mul_overflow(header.cols, header.rows, &count) || __builtin_mul_overflow(count, sizeof(T), &bytes) ||
+	       __builtin_add_overflow(bytes, header.dataOffset, &end) || end > size)
+		throw std::runtime_error {"File Error: Matrix file is truncated"};
+	    const T* data = reinterpret_cast<const T*>(file + header.dataOffset);
+	    if(header.order == static_cast<uint32_t>(MatrixFileOrder::RowMajor))
+		return {data, header.cols, header.rows, header.cols, 1};
+	    return {data, header.cols, header.rows, 1, header.rows};
+	}
+
+    public:
+	/** Constructor, maps the binary Matrix file at the given path, throws if it can't be opened or doesn't hold a Matrix of T */
+	explicit MatrixFile(const std::string& path) : MatrixFile{MappedFile{path}} {}
+
+	/** Constructor, takes over an already mapped file, throws if it doesn't hold a Matrix of T */
+	explicit MatrixFile(MappedFile file) : m_file{std::move(file)} {
+	    m_view = checkHeader(m_file.data(), m_file.size());
+	}
+
+	MatrixFile(const MatrixFile&) = delete;
+	MatrixFile& operator=(const MatrixFile&) = delete;
+
+	/** Move constructor, takes over the mapping of other */
+	MatrixFile(MatrixFile&& other) noexcept : m_file{std::move(other.m_file)}, m_view{std::exchange(other.m_view, MatrixView<const T>{nullptr, 0, 0, 0, 1})} {}
+
+	/** Move assignment, unmaps the current file and takes over the mapping of other */
+	MatrixFile& operator=(MatrixFile&& other) noexcept {
+	    if(this != &other) {
+		m_file = std::move(other.m_file);
+		m_view = std::exchange(other.m_view, MatrixView<const T>{nullptr, 0, 0, 0, 1});
+	    }
+	    return *this;
+	}
+
+	size_t getRows(void) const {
+	    return m_view.getRows();
+	}
+
+	size_t getCols(void) const {
+	    return m_view.getCols();
+	}
+
+	/** Returns the read-only view of the Matrix in the file, valid while the file stays open */
+	MatrixView<const T> view(void) const {
+	    return m_view;
+	}
+
+	/** Writes a Matrix view into a binary Matrix file at the given path, replacing the file.
+	  * Contiguous data in the requested order is written with a single call, anything else a row or column at a time.
+	  */
+	static void write(const std::string& path, MatrixView<const T> m, MatrixFileOrder order = MatrixFileOrder::RowMajor) {
+	    MatrixFileHeader header {};
+	    std::memcpy(header.magic, MatrixFileHeader::fileMagic, sizeof(header.magic));
+	    header.byteOrder = MatrixFileHeader::byteOrderMark;
+	    header.version = MATRIX_FILE_VERSION;
+	    header.elementType = MatrixFileHeader::typeCode<T>();
+	    header.elementSize = sizeof(T);
+	    header.order = static_cast<uint32_t>(order);
+	    header.alignment = MATRIX_FILE_ALIGNMENT;
+	    header.cols = m.getCols();
+	    header.rows = m.getRows();
+	    header.dataOffset = MATRIX_FILE_ALIGNMENT;
+
+	    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file {std::fopen(path.c_str(), "wb"), &std::fclose};
+	    if(!file)
+		throw std::runtime_error {"File Error: Can't create " + path};
+	    bool written = std::fwrite(&header, sizeof(header), 1, file.get()) == 1;
+	    /* Pad the header up to the data offset */
+	    static constexpr unsigned char padding[MATRIX_FILE_ALIGNMENT] {};
+	    written = written && std::fwrite(padding, 1, MATRIX_FILE_ALIGNMENT - sizeof(header), file.get()) == MATRIX_FILE_ALIGNMENT - sizeof(header);
+
+	    bool rowMajor = order == MatrixFileOrder::RowMajor;
+	    /* Outer lines are rows in row-major order and columns in column-major order */
+	    size_t lines = rowMajor ? m.getRows() : m.getCols();
+	    size_t length = rowMajor ? m.getCols() : m.getRows();
+	    size_t lineStride = rowMajor ? m.getRowStride() : m.getColStride();
+	    size_t elementStride = rowMajor ? m.getColStride() : m.getRowStride();
+	    if(elementStride == 1 && lineStride == length) {
+		written = written && std::fwrite(m.data(), sizeof(T), lines * length, file.get()) == lines * length;
+	    } else {
+		std::vector<T> line (length);
+		for(size_t idx = 0; idx < lines && written; ++idx) {
+		    const T* source = m.data() + (idx * lineStride);
+		    for(size_t element = 0; element < length; ++element) {
+			line[element] = source[element * elementStride];
+		    }
+		    written = std::fwrite(line.data(), sizeof(T), length, file.get()) == length;
+		}
+	    }
+	    if(!written || std::fclose(file.release()) != 0)
+		throw std::runtime_error {"File Error: Can't write " + path};
+	}
+
+	/** Writes a mutable Matrix view into a binary Matrix file at the given path, replacing the file */
+	static void write(const std::string& path, MatrixView<T> m, MatrixFileOrder order = MatrixFileOrder::RowMajor) {
+	    write(path, MatrixView<const T>{m}, order);
+	}
+
+	/** Writes a Matrix into a binary Matrix file at the given path, replacing the file */
+	static void write(const std::string& path, const Matrix<T>& m, MatrixFileOrder order = MatrixFileOrder::RowMajor) {
+	    write(path, m.view(), order);
+	}
+};
+
+/** Opens a mapped binary Matrix file with the element type stored in its header, calling onView(view) with the view of its elements.
+  * Throws if the file isn't a binary Matrix file or stores a type that isn't supported.
+  */
+template <typename F>
+void visitMatrixFile(MappedFile file, F&& onView) {
+    if(file.size() < sizeof(MatrixFileHeader) || !MatrixFileHeader::hasMagic(file.data(), file.size()))
+	throw std::runtime_error {"File Error: Not a binary Matrix file"};
+    uint32_t elementType;
+    std::memcpy(&elementType, file.data() + offsetof(MatrixFileHeader, elementType), sizeof(elementType));
+    /* Every supported type, the header of the chosen one is validated in full by MatrixFile */
+    auto open = [&]<typename T>(void) {
+	MatrixFile<T> matrix {std::move(file)};
+	onView(matrix.view());
+    };
+    if(elementType == MatrixFileHeader::typeCode<double>())
+	open.template operator()<double>();
+    else if(elementType == MatrixFileHeader::typeCode<float>())
+	open.template operator()<float>();
+    else if(elementType == MatrixFileHeader::typeCode<int64_t>())
+	open.template operator()<int64_t>();
+    else if(elementType == MatrixFileHeader::typeCode<int32_t>())
+	open.template operator()<int32_t>();
+    else if(elementType == MatrixFileHeader::typeCode<uint64_t>())
+	open.template operator()<uint64_t>();
+    else if(elementType == MatrixFileHeader::typeCode<uint32_t>())
+	open.template operator()<uint32_t>();
+    else
+	throw std::runtime_error {"File Error: Unsupported element type in Matrix file"};
+}
+
+#endif /* MATRIX_FILE_H */
@@ -0,0 +1,151 @@
+/**
+ * @file MatrixFileTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the binary Matrix file format
+*/
+
+#include "MatrixFileTest.hh"
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <sstream>
+#include <limits>
+#include <cmath>
+#include <filesystem>
+
+#include "IOTestUtil.hh"
+
+namespace {
+
+void roundTripTest(void) {
+
+    std::string path = IOTestUtil::tempPath("matrix-file-double", ".mtx");
+    Matrix<double> m {7, 5};
+    for(size_t row = 0; row < 5; ++row) {
+	for(size_t col = 0; col < 7; ++col) {
+	    m.at(col, row) = static_cast<double>(row * 7 + col) / 4.0 - 3.0;
+	}
+    }
+
+    /* The view lies over the mapped file, aligned, and matches the written Matrix */
+    MatrixFile<double>::write(path, m);
+    assert(std::filesystem::file_size(path) == MATRIX_FILE_ALIGNMENT + (35 * sizeof(double)));
+    {
+	MatrixFile<double> file {path};
+	assert(file.getCols() == 7 && file.getRows() == 5);
+	assert(reinterpret_cast<uintptr_t>(file.view().data()) % MATRIX_FILE_ALIGNMENT == 0);
+	assert(Matrix<double>{file.view()} == m);
+
+	/* Moving keeps the mapping alive */
+	MatrixFile<double> moved {std::move(file)};
+	assert(moved.view().at(6, 4) == m.at(6, 4) && file.getRows() == 0);
+    }
+
+    /* Column-major files are viewed through strides */
+    MatrixFile<double>::write(path, m, MatrixFileOrder::ColumnMajor);
+    {
+	MatrixFile<double> file {path};
+	assert(file.view().getRowStride() == 1 && file.view().getColStride() == 5);
+	assert(Matrix<double>{file.view()} == m);
+    }
+
+    /* Strided views are written element by element */
+    MatrixFile<double>::write(path, m.view().subView(1, 1, 3, 2).transposed());
+    {
+	MatrixFile<double> file {path};
+	assert(file.getCols() == 2 && file.getRows() == 3);
+	assert(file.view().at(1, 2) == m.at(3, 2) && file.view().at(0, 0) == m.at(1, 1));
+    }
+
+    /* Integer elements and an empty Matrix */
+    Matrix<int64_t> ints {{-1, 2}, {INT64_MAX, INT64_MIN}};
+    MatrixFile<int64_t>::write(path, ints);
+    assert(Matrix<int64_t>{MatrixFile<int64_t>{path}.view()} == ints);
+    MatrixFile<int64_t>::write(path, Matrix<int64_t>{});
+    assert(MatrixFile<int64_t>{path}.getRows() == 0);
+    std::filesystem::remove(path);
+}
+
+void invalidTest(void) {
+
+    std::string path = IOTestUtil::tempPath("matrix-file-invalid", ".mtx");
+    auto fails = [&path](void) {
+	try {
+	    MatrixFile<double> file {path};
+	} catch(const std::exception& e) {
+	    return true;
+	}
+	return false;
+    };
+
+    /* Missing file, wrong element type */
+    std::filesystem::remove(path);
+    assert(fails());
+    MatrixFile<float>::write(path, Matrix<float>{{1.0f, 2.0f}});
+    assert(fails());
+
+    /* Truncated data and a damaged magic */
+    MatrixFile<double>::write(path, Matrix<double>{{1.0, 2.0}});
+    std::filesystem::resize_file(path, MATRIX_FILE_ALIGNMENT + sizeof(double));
+    assert(fails());
+    std::filesystem::resize_file(path, 10);
+    assert(fails());
+    MatrixFile<double>::write(path, Matrix<double>{{1.0, 2.0}});
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    std::fputc('X', file);
+    std::fclose(file);
+    assert(fails());
+    std::filesystem::remove(path);
+}
+
+void readerTest(void) {
+
+    /* The reader detects a binary file behind "@<path>", floating point elements become the shortest decimal they print as */
+    std::string path = IOTestUtil::tempPath("matrix-file-reader", ".mtx");
+    MatrixFile<double>::write(path, Matrix<double>{{0.1, -2.5}, {1e20, 3.0}});
+    std::istringstream input {"@" + path + "\nDONE\n@" + path + "\n"};
+    MatrixReader reader {input};
+    assert(reader.read() == (Matrix<Rational>{{"1/10", "-5/2"}, {"100000000000000000000", 3}}));
+    MatrixFile<int32_t>::write(path, Matrix<int32_t>{{INT32_MIN, 7}}, MatrixFileOrder::ColumnMajor);
+    assert(reader.read() == (Matrix<Rational>{{INT32_MIN, 7}}));
+
+    /* An unsupported element type or a non-finite element fails that matrix only */
+    MatrixFile<int16_t>::write(path, Matrix<int16_t>{{1, 2}});
+    MatrixFile<float>::write(path + ".nan", Matrix<float>{{1.0f, std::numeric_limits<float>::quiet_NaN()}});
+    std::istringstream invalid {"@" + path + "\nDONE\n@" + path + ".nan\nDONE\n1 2\n"};
+    MatrixReader invalidReader {invalid};
+    for(size_t idx = 0; idx < 2; ++idx) {
+	bool caught = false;
+	try {
+	    invalidReader.read();
+	} catch(const std::exception& e) {
+	    caught = true;
+	}
+	assert(caught);
+    }
+    assert(invalidReader.read() == (Matrix<Rational>{{1, 2}}));
+
+    /* The mapped view is factorized and solved with directly */
+    MatrixFile<double>::write(path, Matrix<double>{{2.0, 1.0, 3.0}, {4.0, 3.0, 5.0}});
+    MatrixFile<double> file {path};
+    LU<double> lu {file.view().subView(0, 0, 2, 2)};
+    Matrix<double> x = lu.solve(file.view().colView(2));
+    assert(x.getRows() == 2 && std::abs(x.at(0, 0) - 2.0) < 1e-12 && std::abs(x.at(0, 1) + 1.0) < 1e-12);
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".nan");
+}
+
+} /* anonymous */
+
+void matrixFileTest(void) {
+
+    std::puts("--- Matrix File TC Running ---");
+    roundTripTest();
+    std::puts("-> Passed roundTripTest()");
+    invalidTest();
+    std::puts("-> Passed invalidTest()");
+    readerTest();
+    std::puts("-> Passed readerTest()");
+    std::puts("--- Matrix File Tests Passed ---");
+}
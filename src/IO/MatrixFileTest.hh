@@ -0,0 +1,21 @@
+/**
+ * @file MatrixFileTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the binary Matrix file format
+*/
+#ifndef MATRIX_FILE_TEST_H
+#define MATRIX_FILE_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "MatrixFile.hh"
+#include "MatrixReader.hh"
+#include "../Matrix/MatrixLU.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Matrix/MatrixView.hh"
+
+/** Function containing test cases for the binary Matrix file format */
+void matrixFileTest(void);
+
+#endif /* MATRIX_FILE_TEST_H */
@@ -0,0 +1,219 @@
+/**
+ * @file MatrixLoader.hh
+ * @author Martin
+ * @brief File containing the parallel loader of large Matrix text files
+*/
+#ifndef MATRIX_LOADER_H
+#define MATRIX_LOADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <system_error>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <span>
+#include <spanstream>
+
+#include "MappedFile.hh"
+#include "MatrixMarket.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+#include "../Thread/ThreadPool.hh"
+
+/** Size in bytes of the pieces a text file is split into for parsing, each ends at a line break */
+#define MATRIX_LOADER_CHUNK_SIZE (256 * 1024)
+
+/** Namespace containing the parallel loader of Matrix text files.
+  * Files are in the format of MatrixReader, one row per line with the numbers separated by spaces or tabs, up to a
+  * DONE line or the end of the file. The file is memory mapped and split into chunks at line breaks, each chunk first
+  * counts its rows, then after the Matrix is allocated at its final size, parses them straight into its own row range.
+  * Both passes run in parallel over the chunks.
+  */
+namespace MatrixLoader {
+
+    /** Lines of one chunk of the file */
+    struct Chunk {
+	/** The text of the chunk, whole lines only */
+	std::string_view text;
+	/** The number of non-empty lines, which are the rows of the chunk */
+	size_t rows = 0;
+	/** The number of line breaks, for the line numbers of errors */
+	size_t lines = 0;
+	/** Whether the chunk contains the end of matrix marker, the text then ends before it */
+	bool done = false;
+	/** Index of the first row and number of the first line of the chunk */
+	size_t firstRow = 0;
+	size_t firstLine = 0;
+    };
+
+    /** Whether a character separates numbers */
+    inline bool isSeparator(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    /** Returns a line without the leading and trailing separators */
+    inline std::string_view trim(std::string_view line) {
+	while(!line.empty() && isSeparator(line.front())) {
+	    line.remove_prefix(1);
+	}
+	while(!line.empty() && isSeparator(line.back())) {
+	    line.remove_suffix(1);
+	}
+	return line;
+    }
+
+    /** Splits the next line off the front of text */
+    inline std::string_view nextLine(std::string_view& text) {
+	size_t end = text.find('\n');
+	std::string_view line = text.substr(0, end);
+	text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+	return line;
+    }
+
+    /** Parses a number of the text format, a decimal or a fraction of integers */
+    template <typename T>
+    T parseNumber(std::string_view token) {
+	if constexpr (std::is_same_v<T, Rational>) {
+	    return Rational::parse(token);
+	} else {
+	    /* Parsed straight into the floating point type, from_chars doesn't take a leading plus */
+	    std::string_view digits = token.starts_with('+') ? token.substr(1) : token;
+	    const char* last = digits.data() + digits.size();
+	    T value {}, denominator {1};
+	    std::from_chars_result result = std::from_chars(digits.data(), last, value);
+	    const char* end = result.ptr;
+	    if(result.ec == std::errc{} && end != last && *end == '/' && end + 1 != last && end[1] != '-' && end[1] != '+')
+		result = std::from_chars(end + 1, last, denominator);
+	    if(digits.empty() || result.ec != std::errc{} || result.ptr != last)
+		throw std::runtime_error {"Invalid number \"" + std::string{token} + "\""};
+	    if(denominator == 0)
+		throw std::runtime_error {"Rational Error: Division by zero"};
+	    return value / denominator;
+	}
+    }
+
+    /** Counts the rows and lines of a chunk, cutting its text at the end of matrix marker */
+    inline void scanChunk(Chunk& chunk) {
+	std::string_view rest = chunk.text;
+	while(!rest.empty()) {
+	    std::string_view remaining = rest;
+	    std::string_view line = trim(nextLine(rest));
+	    if(line == "DONE" || line == "done") {
+		chunk.text = chunk.text.substr(0, chunk.text.size() - remaining.size());
+		chunk.done = true;
+		return;
+	    }
+	    chunk.rows += !line.empty();
+	}
+	chunk.lines = static_cast<size_t>(std::count(chunk.text.begin(), chunk.text.end(), '\n'));
+    }
+
+    /** Parses the rows of a chunk into its row range of m, throws naming the line of an invalid number or row */
+    template <typename T>
+    void parseChunk(const Chunk& chunk, Matrix<T>& m) {
+	std::string_view rest = chunk.text;
+	size_t row = chunk.firstRow, lineNumber = chunk.firstLine;
+	while(!rest.empty()) {
+	    std::string_view line = trim(nextLine(rest));
+	    ++lineNumber;
+	    if(line.empty())
+		continue;
+	    try {
+		size_t col = 0;
+		while(!line.empty()) {
+		    size_t end = 0;
+		    while(end < line.size() && !isSeparator(line[end])) {
+			++end;
+		    }
+		    if(col == m.getCols())
+			throw std::runtime_error {"Matrix Error: Appended row has the wrong number of columns"};
+		    m.atUnchecked(col++, row) = parseNumber<T>(line.substr(0, end));
+		    line = trim(line.substr(end));
+		}
+		if(col != m.getCols())
+		    throw std::runtime_error {"Matrix Error: Appended row has the wrong number of columns"};
+	    } catch(const std::exception& e) {
+		throw std::runtime_error {"Reader Error: Line " + std::to_string(lineNumber) + ": " + e.what()};
+	    }
+	    ++row;
+	}
+    }
+
+    /** Returns the number of numbers on the first non-empty line of text */
+    inline size_t countColumns(std::string_view text) {
+	while(!text.empty()) {
+	    std::string_view line = trim(nextLine(text));
+	    if(line.empty())
+		continue;
+	    size_t cols = 0;
+	    for(size_t idx = 0; idx < line.size(); ++idx) {
+		cols += !isSeparator(line[idx]) && (idx == 0 || isSeparator(line[idx - 1]));
+	    }
+	    return cols;
+	}
+	return 0;
+    }
+
+    /** Parses Matrix text, splitting it into chunks of about chunkSize bytes parsed in parallel */
+    template <typename T> requires (std::is_same_v<T, Rational> || std::is_floating_point_v<T>)
+    Matrix<T> parse(std::string_view text, size_t chunkSize = MATRIX_LOADER_CHUNK_SIZE) {
+	/* Files in the Matrix Market format are read by its reader, without copying the text */
+	if(MatrixMarket::isBanner(trim(text.substr(0, text.find('\n'))))) {
+	    std::ispanstream input {std::span<const char>{text.data(), text.size()}};
+	    return MatrixMarket::readDense<T>(input);
+	}
+
+	/* Chunks end after the first line break past their size */
+	std::vector<Chunk> chunks;
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	for(size_t begin = 0; begin < text.size();) {
+	    size_t end = text.find('\n', std::min(begin + chunkSize, text.size()) - 1);
+	    end = end == std::string_view::npos ? text.size() : end + 1;
+	    chunks.push_back(Chunk{.text = text.substr(begin, end - begin)});
+	    begin = end;
+	}
+
+	/* Pre-scan, counting the rows of each chunk */
+	ThreadPool::global().parallelFor(0, chunks.size(), 1, [&chunks](size_t first, size_t last) {
+	    for(size_t idx = first; idx < last; ++idx) {
+		scanChunk(chunks[idx]);
+	    }
+	});
+	size_t rows = 0, lines = 0;
+	for(size_t idx = 0; idx < chunks.size(); ++idx) {
+	    chunks[idx].firstRow = rows;
+	    chunks[idx].firstLine = lines;
+	    rows += chunks[idx].rows;
+	    lines += chunks[idx].lines;
+	    /* Everything after the end of matrix marker is ignored */
+	    if(chunks[idx].done) {
+		chunks.resize(idx + 1);
+		break;
+	    }
+	}
+	if(rows == 0)
+	    return Matrix<T>{};
+
+	/* Every chunk parses into its own rows of the preallocated Matrix */
+	Matrix<T> result {countColumns(text), rows};
+	ThreadPool::global().parallelFor(0, chunks.size(), 1, [&chunks, &result](size_t first, size_t last) {
+	    for(size_t idx = first; idx < last; ++idx) {
+		parseChunk(chunks[idx], result);
+	    }
+	});
+	return result;
+    }
+
+    /** Loads the Matrix in the text file at the given path, mapping the file and parsing it in parallel */
+    template <typename T> requires (std::is_same_v<T, Rational> || std::is_floating_point_v<T>)
+    Matrix<T> load(const std::string& path, size_t chunkSize = MATRIX_LOADER_CHUNK_SIZE) {
+	MappedFile file {path};
+	return parse<T>(file.text(), chunkSize);
+    }
+
+} /* namespace MatrixLoader */
+
+#endif /* MATRIX_LOADER_H */
@@ -0,0 +1,135 @@
+/**
+ * @file MatrixLoaderTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the parallel Matrix text loader
+*/
+
+#include "MatrixLoaderTest.hh"
+
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <filesystem>
+
+#include "MatrixReader.hh"
+#include "IOTestUtil.hh"
+
+namespace {
+
+void parseTest(void) {
+
+    /* Chunks of any size give the same Matrix as the streaming reader */
+    std::string text;
+    for(int row = 0; row < 40; ++row) {
+	for(int col = 0; col < 7; ++col) {
+	    text += std::to_string(row * 7 - col) + (col % 2 ? "/3" : ".5") + (col == 6 ? "" : (row % 3 ? " " : " \t "));
+	}
+	text += row % 5 ? "\n" : "\r\n\n";
+    }
+    std::istringstream input {text};
+    Matrix<Rational> expected = MatrixReader{input}.read();
+    for(size_t chunkSize : {size_t{1}, size_t{7}, size_t{64}, size_t{1000}, text.size()}) {
+	assert(MatrixLoader::parse<Rational>(text, chunkSize) == expected);
+    }
+
+    /* The Matrix ends at the end of matrix marker */
+    assert(MatrixLoader::parse<Rational>("\n1 2\n\n3 4\n done\n5 6\n", 4) == (Matrix<Rational>{{1, 2}, {3, 4}}));
+    assert(MatrixLoader::parse<Rational>("DONE\n1 2\n", 2).getRows() == 0);
+    assert(MatrixLoader::parse<Rational>("", 2).getRows() == 0);
+}
+
+void doubleTest(void) {
+
+    /* Floating point matrices take the same format */
+    Matrix<double> m = MatrixLoader::parse<double>("1 -1/4 +2.5\n3e2 0 1/8", 3);
+    assert(m == (Matrix<double>{{1, -0.25, 2.5}, {300, 0, 0.125}}));
+
+    /* And the Matrix Market format */
+    Matrix<double> market = MatrixLoader::parse<double>("%%MatrixMarket matrix array real general\n1 2\n0.5\n-2\n");
+    assert(market == (Matrix<double>{{0.5, -2}}));
+}
+
+void errorTest(void) {
+
+    /* Errors name the line in the whole text, whichever chunk it is in */
+    auto failsAt = [](const char* text, const std::string& line) {
+	for(size_t chunkSize : {size_t{1}, size_t{5}, size_t{100}}) {
+	    bool caught = false;
+	    try {
+		MatrixLoader::parse<double>(text, chunkSize);
+	    } catch(const std::exception& e) {
+		caught = std::string{e.what()}.starts_with("Reader Error: Line " + line + ":");
+	    }
+	    if(!caught)
+		return false;
+	}
+	return true;
+    };
+    assert(failsAt("1 2\n3 4\n\n5 x\n", "4"));
+    assert(failsAt("1 2\n3 4\n5 6 7\n", "3"));
+    assert(failsAt("1 2\n\n\n3\n", "4"));
+    assert(failsAt("1 2\n1/0 1\n", "2"));
+    assert(failsAt("1 2\n1/-2 1\n", "2"));
+}
+
+void loadTest(void) {
+
+    /* Files are mapped and parsed, or named in the input of the streaming reader */
+    std::string path = IOTestUtil::tempPath("matrix-loader", ".txt");
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    assert(file != nullptr);
+    std::fputs("1/2 2\n-3 4.25\n", file);
+    std::fclose(file);
+    Matrix<Rational> expected {{"1/2", 2}, {-3, "17/4"}};
+    assert(MatrixLoader::load<Rational>(path) == expected);
+
+    std::istringstream input {"@" + path + "\nDONE\n1\n"};
+    MatrixReader reader {input};
+    assert(reader.read() == expected);
+    assert(reader.read() == Matrix<Rational>{{1}});
+
+    /* Only the rest of a failed matrix is skipped, the next one is still read */
+    std::istringstream extra {"@" + path + "\n5 6\nDONE\n7 8\nDONE\n@" + path + ".missing\nDONE\n9 10\n"};
+    MatrixReader extraReader {extra};
+    for(const Matrix<Rational>& next : {Matrix<Rational>{{7, 8}}, Matrix<Rational>{{9, 10}}}) {
+	bool failed = false;
+	try {
+	    extraReader.read();
+	} catch(const std::exception& e) {
+	    failed = true;
+	}
+	assert(failed);
+	assert(extraReader.read() == next);
+    }
+    std::filesystem::remove(path);
+
+    /* Empty and missing files */
+    file = std::fopen(path.c_str(), "w");
+    assert(file != nullptr);
+    std::fclose(file);
+    assert(MatrixLoader::load<double>(path).getRows() == 0);
+    std::filesystem::remove(path);
+    bool caught = false;
+    try {
+	MatrixLoader::load<double>(path);
+    } catch(const std::exception& e) {
+	caught = std::string{e.what()}.starts_with("File Error: Can't open");
+    }
+    assert(caught);
+}
+
+} /* anonymous */
+
+void matrixLoaderTest(void) {
+
+    std::puts("--- Matrix Loader TC Running ---");
+    parseTest();
+    std::puts("-> Passed parseTest()");
+    doubleTest();
+    std::puts("-> Passed doubleTest()");
+    errorTest();
+    std::puts("-> Passed errorTest()");
+    loadTest();
+    std::puts("-> Passed loadTest()");
+    std::puts("--- Matrix Loader Tests Passed ---");
+}
@@ -0,0 +1,19 @@
+/**
+ * @file MatrixLoaderTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the parallel Matrix text loader
+*/
+#ifndef MATRIX_LOADER_TEST_H
+#define MATRIX_LOADER_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "MatrixLoader.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the parallel Matrix text loader */
+void matrixLoaderTest(void);
+
+#endif /* MATRIX_LOADER_TEST_H */
@@ -0,0 +1,495 @@
+/**
+ * @file MatrixMarket.hh
+ * @author Martin
+ * @brief File containing the streaming reader and writer of the Matrix Market exchange format (.mtx)
+*/
+#ifndef MATRIX_MARKET_H
+#define MATRIX_MARKET_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <system_error>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+
+#include "../Matrix/Matrix.hh"
+#include "../Matrix/MatrixView.hh"
+#include "../Rational/Rational.hh"
+
+/** Largest decimal exponent accepted in a real entry read into a Rational */
+#define MATRIX_MARKET_MAX_EXPONENT 4096
+
+/** Namespace containing the Matrix Market reader and writer.
+  * Both the array (dense, column after column) and the coordinate (sparse, one "row column value" triplet per line)
+  * formats are supported, with real, integer and pattern entries, general, symmetric and skew-symmetric storage.
+  * Entries are parsed as they are read, with nothing of the input kept beside a single line. As an extension,
+  * the field "rational" holds exact fractions like "-3/7", which is what Rational matrices with non-integer entries are written as.
+  */
+namespace MatrixMarket {
+
+    /** Layout of the entries */
+    enum class Format {
+	/** Every entry, column after column */
+	Array,
+	/** Only the stored entries, as 1-based (row, column, value) triplets */
+	Coordinate
+    };
+
+    /** Type of the entries */
+    enum class Field {
+	Real,
+	Integer,
+	/** Exact fractions, an extension of the format */
+	Rational,
+	/** No values, every stored entry is one */
+	Pattern
+    };
+
+    /** Which entries are stored */
+    enum class Symmetry {
+	/** All of them */
+	General,
+	/** Only those on and below the diagonal, mirrored above it */
+	Symmetric,
+	/** Only those below the diagonal, mirrored above it with the opposite sign */
+	SkewSymmetric
+    };
+
+    /** Banner and size line of a Matrix Market file */
+    struct Header {
+	Format format = Format::Array;
+	Field field = Field::Real;
+	Symmetry symmetry = Symmetry::General;
+	size_t rows = 0;
+	size_t cols = 0;
+	/** The number of stored entries, (rows x columns) in the array format */
+	size_t entries = 0;
+    };
+
+    /** Sparse Matrix as a list of its non-zero entries, in the order they were read (coordinate or COO format) */
+    template <typename T>
+    struct Coordinates {
+	size_t rows = 0;
+	size_t cols = 0;
+	/** 0-based row and column of each entry */
+	std::vector<size_t> rowIndices;
+	std::vector<size_t> colIndices;
+	std::vector<T> values;
+    };
+
+    /** Whether a line of the file starts with the Matrix Market banner */
+    inline bool isBanner(std::string_view line) {
+	return line.starts_with("%%MatrixMarket");
+    }
+
+    /** Splits the next whitespace separated token off the front of text */
+    inline std::string_view nextToken(std::string_view& text) {
+	size_t begin = text.find_first_not_of(" \t\r");
+	if(begin == std::string_view::npos) {
+	    text = {};
+	    return {};
+	}
+	size_t end = text.find_first_of(" \t\r", begin);
+	std::string_view token = text.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+	text = end == std::string_view::npos ? std::string_view{} : text.substr(end);
+	return token;
+    }
+
+    /** Parses an unsigned integer token, throws if it isn't one */
+    inline size_t parseIndex(std::string_view token) {
+	size_t value = 0;
+	auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+	if(token.empty() || error != std::errc{} || end != token.data() + token.size())
+	    throw std::runtime_error {"Invalid index or size \"" + std::string{token} + "\""};
+	return value;
+    }
+
+    /** Parses an entry token into the element type */
+    template <typename T>
+    T parseValue(std::string_view token) {
+	if constexpr (std::is_same_v<T, Rational>) {
+	    /* Decimals with an optional exponent, scaled exactly */
+	    size_t exponentAt = token.find_first_of("eE");
+	    Rational value = Rational::parse(token.substr(0, exponentAt));
+	    if(exponentAt == std::string_view::npos)
+		return value;
+	    std::string_view exponentToken = token.substr(exponentAt + 1);
+	    if(exponentToken.starts_with('+'))
+		exponentToken.remove_prefix(1);
+	    int exponent = 0;
+	    auto [end, error] = std::from_chars(exponentToken.data(), exponentToken.data() + exponentToken.size(), exponent);
+	    if(exponentToken.empty() || error != std::errc{} || end != exponentToken.data() + exponentToken.size() ||
+	       exponent > MATRIX_MARKET_MAX_EXPONENT || exponent < -MATRIX_MARKET_MAX_EXPONENT)
+		throw std::runtime_error {"Invalid exponent in \"" + std::string{token} + "\""};
+	    Rational scale {1};
+	    for(int idx = 0; idx < (exponent < 0 ? -exponent : exponent); ++idx) {
+		scale *= Rational{10};
+	    }
+	    return exponent < 0 ? value / scale : value * scale;
+	} else {
+	    /* from_chars doesn't take a leading plus */
+	    std::string_view digits = token.starts_with('+') ? token.substr(1) : token;
+	    T value {};
+	    auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+	    if(digits.empty() || error != std::errc{} || end != digits.data() + digits.size())
+		throw std::runtime_error {"Invalid entry \"" + std::string{token} + "\""};
+	    return value;
+	}
+    }
+
+    /** Appends the text of an entry to out */
+    template <typename T>
+    void formatValue(const T& value, std::string& out) {
+	if constexpr (std::is_same_v<T, Rational>) {
+	    out += value.toString();
+	} else {
+	    char buffer[64];
+	    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	    out.append(buffer, end);
+	}
+    }
+
+    /** Returns the field Matrix Market field of values of the given element type, for Rational the one fitting the values */
+    template <typename T>
+    Field fieldOf(MatrixView<const T> m) {
+	if constexpr (std::is_same_v<T, Rational>) {
+	    for(size_t row = 0; row < m.getRows(); ++row) {
+		for(size_t col = 0; col < m.getCols(); ++col) {
+		    if(m.atUnchecked(col, row).getBigDenominator() != 1)
+			return Field::Rational;
+		}
+	    }
+	    return Field::Integer;
+	} else {
+	    return std::is_integral_v<T> ? Field::Integer : Field::Real;
+	}
+    }
+
+    /** Reads a Matrix Market file from a stream, a line at a time.
+      * The banner and the size line are read when the reader is created, the entries by one of the read functions.
+      */
+    class Reader {
+
+	private:
+	    /** The stream the file is read from */
+	    std::istream& m_input;
+	    /** The current line, reused for every line */
+	    std::string m_line;
+	    /** The number of lines read so far, for error messages */
+	    size_t m_lineNumber = 0;
+	    /** The banner and the sizes */
+	    Header m_header;
+	    /** Whether a line with the end of matrix marker of MatrixReader (DONE or done) was read */
+	    bool m_endMarker = false;
+
+	    /** Throws an error naming the current line */
+	    [[noreturn]] void fail(const std::string& message) const {
+		throw std::runtime_error {"MatrixMarket Error: Line " + std::to_string(m_lineNumber) + ": " + message};
+	    }
+
+	    /** Reads the next line that isn't a comment or empty into m_line, returns its content.
+	      * Throws at the end of the stream, and at an end of matrix marker, which is never an entry, without reading past it.
+	      */
+	    std::string_view nextDataLine(void) {
+		while(std::getline(m_input, m_line)) {
+		    ++m_lineNumber;
+		    std::string_view line {m_line};
+		    size_t begin = line.find_first_not_of(" \t\r");
+		    if(begin == std::string_view::npos || line[begin] == '%')
+			continue;
+		    line = line.substr(begin, line.find_last_not_of(" \t\r") + 1 - begin);
+		    if(line == "DONE" || line == "done") {
+			m_endMarker = true;
+			fail("Unexpected end of Matrix, fewer entries than its size line gives");
+		    }
+		    return line;
+		}
+		fail("Unexpected end of input");
+	    }
+
+	    /** Parses the banner "%%MatrixMarket matrix <format> <field> <symmetry>", case-insensitively */
+	    void parseBanner(std::string_view line) {
+		std::string lower {line};
+		for(char& c : lower) {
+		    if(c >= 'A' && c <= 'Z')
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+		std::string_view rest {lower};
+		if(nextToken(rest) != "%%matrixmarket" || nextToken(rest) != "matrix")
+		    fail("Expected a \"%%MatrixMarket matrix\" banner");
+		std::string_view format = nextToken(rest), field = nextToken(rest), symmetry = nextToken(rest);
+		if(format == "array")
+		    m_header.format = Format::Array;
+		else if(format == "coordinate")
+		    m_header.format = Format::Coordinate;
+		else
+		    fail("Unsupported format \"" + std::string{format} + "\"");
+		if(field == "real" || field == "double")
+		    m_header.field = Field::Real;
+		else if(field == "integer")
+		    m_header.field = Field::Integer;
+		else if(field == "rational")
+		    m_header.field = Field::Rational;
+		else if(field == "pattern" && m_header.format == Format::Coordinate)
+		    m_header.field = Field::Pattern;
+		else
+		    fail("Unsupported field \"" + std::string{field} + "\"");
+		if(symmetry == "general")
+		    m_header.symmetry = Symmetry::General;
+		else if(symmetry == "symmetric")
+		    m_header.symmetry = Symmetry::Symmetric;
+		else if(symmetry == "skew-symmetric")
+		    m_header.symmetry = Symmetry::SkewSymmetric;
+		else
+		    fail("Unsupported symmetry \"" + std::string{symmetry} + "\"");
+	    }
+
+	    /** Parses the size line, "rows columns" for arrays and "rows columns entries" for coordinates */
+	    void parseSize(void) {
+		std::string_view line = nextDataLine();
+		try {
+		    m_header.rows = parseIndex(nextToken(line));
+		    m_header.cols = parseIndex(nextToken(line));
+		    if(m_header.format == Format::Coordinate)
+			m_header.entries = parseIndex(nextToken(line));
+		} catch(const std::exception& e) {
+		    fail(e.what());
+		}
+		if(!nextToken(line).empty())
+		    fail("Unexpected text after the sizes");
+		if(m_header.symmetry != Symmetry::General && m_header.rows != m_header.cols)
+		    fail("A symmetric Matrix must be square");
+		if(m_header.format == Format::Array) {
+		    /* Only the lower triangle of a symmetric array is stored, without the diagonal if skew-symmetric */
+		    size_t n = m_header.rows;
+		    if(m_header.symmetry == Symmetry::General)
+			m_header.entries = m_header.rows * m_header.cols;
+		    else
+			m_header.entries = m_header.symmetry == Symmetry::Symmetric ? n * (n + 1) / 2 : n * (n - (n > 0)) / 2;
+		}
+	    }
+
+	public:
+	    /** Constructor, reads the banner and the size line from the stream */
+	    explicit Reader(std::istream& input) : m_input{input} {
+		if(!std::getline(m_input, m_line))
+		    fail("Missing banner");
+		++m_lineNumber;
+		parseBanner(m_line);
+		parseSize();
+	    }
+
+	    /** Constructor for a stream whose banner line was already read (and is given), reads the size line */
+	    Reader(std::istream& input, std::string_view banner, size_t lineNumber = 1) : m_input{input}, m_lineNumber{lineNumber} {
+		readHeader(banner);
+	    }
+
+	    /** Constructor for a stream whose banner line was already read, without reading anything, the header is then read by readHeader */
+	    Reader(std::istream& input, size_t lineNumber) : m_input{input}, m_lineNumber{lineNumber} {}
+
+	    /** Parses the given banner line and reads the size line */
+	    void readHeader(std::string_view banner) {
+		parseBanner(banner);
+		parseSize();
+	    }
+
+	    /** Returns the banner and the sizes */
+	    const Header& getHeader(void) const {
+		return m_header;
+	    }
+
+	    /** Returns the number of lines read so far */
+	    size_t getLineNumber(void) const {
+		return m_lineNumber;
+	    }
+
+	    /** Whether reading stopped at an end of matrix marker (DONE or done), which then was already read */
+	    bool isAtEndMarker(void) const {
+		return m_endMarker;
+	    }
+
+	    /** Reads every stored entry, calling onEntry(row, column, value) with 0-based indices for each of them.
+	      * Entries mirrored by the symmetry are passed as well, zeros of the array format are skipped.
+	      */
+	    template <typename T, typename F>
+	    void forEachEntry(F&& onEntry) {
+		size_t col = 0, row = 0;
+		bool symmetric = m_header.symmetry != Symmetry::General;
+		bool skew = m_header.symmetry == Symmetry::SkewSymmetric;
+		/* The first stored row of each column of an array, below the diagonal for skew-symmetric storage */
+		auto firstRow = [&](size_t column) { return symmetric ? column + (skew ? 1 : 0) : 0; };
+		row = firstRow(0);
+		for(size_t entry = 0; entry < m_header.entries; ++entry) {
+		    std::string_view line = nextDataLine();
+		    T value {};
+		    try {
+			if(m_header.format == Format::Coordinate) {
+			    size_t i = parseIndex(nextToken(line)), j = parseIndex(nextToken(line));
+			    if(i == 0 || j == 0 || i > m_header.rows || j > m_header.cols)
+				throw std::runtime_error {"Entry position out of bounds"};
+			    if(symmetric && (j > i || (skew && i == j)))
+				throw std::runtime_error {"Entry above the diagonal of a symmetric Matrix"};
+			    row = i - 1;
+			    col = j - 1;
+			}
+			value = m_header.field == Field::Pattern ? T{1} : parseValue<T>(nextToken(line));
+		    } catch(const std::exception& e) {
+			fail(e.what());
+		    }
+		    if(!nextToken(line).empty())
+			fail("Unexpected text after the entry");
+		    if(m_header.format == Format::Coordinate || value != T{0}) {
+			if(symmetric && row != col)
+			    onEntry(col, row, skew ? T{0} - value : value);
+			onEntry(row, col, std::move(value));
+		    }
+		    /* Arrays are stored column after column */
+		    if(m_header.format == Format::Array && ++row == m_header.rows) {
+			++col;
+			row = firstRow(col);
+		    }
+		}
+	    }
+
+	    /** Reads the entries into a dense Matrix, allocated once at the size given in the header */
+	    template <typename T>
+	    Matrix<T> readDense(void) {
+		Matrix<T> result {m_header.cols, m_header.rows};
+		forEachEntry<T>([&result](size_t row, size_t col, T&& value) {
+		    result.atUnchecked(col, row) = std::move(value);
+		});
+		return result;
+	    }
+
+	    /** Reads the entries into a coordinate list, without a dense copy ever existing */
+	    template <typename T>
+	    Coordinates<T> readCoordinates(void) {
+		Coordinates<T> result;
+		result.rows = m_header.rows;
+		result.cols = m_header.cols;
+		size_t expected = m_header.format == Format::Coordinate ? m_header.entries * (m_header.symmetry == Symmetry::General ? 1 : 2) : 0;
+		result.rowIndices.reserve(expected);
+		result.colIndices.reserve(expected);
+		result.values.reserve(expected);
+		forEachEntry<T>([&result](size_t row, size_t col, T&& value) {
+		    result.rowIndices.push_back(row);
+		    result.colIndices.push_back(col);
+		    result.values.push_back(std::move(value));
+		});
+		return result;
+	    }
+    };
+
+    /** Reads a dense Matrix from a Matrix Market stream */
+    template <typename T>
+    Matrix<T> readDense(std::istream& input) {
+	return Reader{input}.readDense<T>();
+    }
+
+    /** Reads a coordinate list from a Matrix Market stream */
+    template <typename T>
+    Coordinates<T> readCoordinates(std::istream& input) {
+	return Reader{input}.readCoordinates<T>();
+    }
+
+    /** Writes the banner line */
+    inline void writeBanner(std::ostream& output, Format format, Field field) {
+	static constexpr const char* fields[] = {"real", "integer", "rational", "pattern"};
+	output << "%%MatrixMarket matrix " << (format == Format::Array ? "array " : "coordinate ") << fields[static_cast<int>(field)] << " general\n";
+    }
+
+    /** Writes a Matrix view in the array format, every entry column after column */
+    template <typename T>
+    void writeArray(std::ostream& output, MatrixView<const T> m) {
+	writeBanner(output, Format::Array, fieldOf(m));
+	output << m.getRows() << ' ' << m.getCols() << '\n';
+	std::string line;
+	for(size_t col = 0; col < m.getCols(); ++col) {
+	    for(size_t row = 0; row < m.getRows(); ++row) {
+		line.clear();
+		formatValue(m.atUnchecked(col, row), line);
+		line += '\n';
+		output.write(line.data(), static_cast<std::streamsize>(line.size()));
+	    }
+	}
+	if(!output)
+	    throw std::runtime_error {"MatrixMarket Error: Writing failed"};
+    }
+
+    template <typename T>
+    void writeArray(std::ostream& output, const Matrix<T>& m) {
+	writeArray(output, m.view());
+    }
+
+    /** Writes a Matrix view in the coordinate format, only the non-zero entries, row after row */
+    template <typename T>
+    void writeCoordinates(std::ostream& output, MatrixView<const T> m) {
+	size_t entries = 0;
+	for(size_t row = 0; row < m.getRows(); ++row) {
+	    for(size_t col = 0; col < m.getCols(); ++col) {
+		entries += m.atUnchecked(col, row) != T{0};
+	    }
+	}
+	writeBanner(output, Format::Coordinate, fieldOf(m));
+	output << m.getRows() << ' ' << m.getCols() << ' ' << entries << '\n';
+	std::string line;
+	for(size_t row = 0; row < m.getRows(); ++row) {
+	    for(size_t col = 0; col < m.getCols(); ++col) {
+		const T& value = m.atUnchecked(col, row);
+		if(value == T{0})
+		    continue;
+		line.clear();
+		line += std::to_string(row + 1);
+		line += ' ';
+		line += std::to_string(col + 1);
+		line += ' ';
+		formatValue(value, line);
+		line += '\n';
+		output.write(line.data(), static_cast<std::streamsize>(line.size()));
+	    }
+	}
+	if(!output)
+	    throw std::runtime_error {"MatrixMarket Error: Writing failed"};
+    }
+
+    template <typename T>
+    void writeCoordinates(std::ostream& output, const Matrix<T>& m) {
+	writeCoordinates(output, m.view());
+    }
+
+    /** Writes a coordinate list in the coordinate format */
+    template <typename T>
+    void writeCoordinates(std::ostream& output, const Coordinates<T>& m) {
+	Field field = std::is_integral_v<T> ? Field::Integer : Field::Real;
+	if constexpr (std::is_same_v<T, Rational>) {
+	    field = Field::Integer;
+	    for(const Rational& value : m.values) {
+		if(value.getBigDenominator() != 1)
+		    field = Field::Rational;
+	    }
+	}
+	writeBanner(output, Format::Coordinate, field);
+	output << m.rows << ' ' << m.cols << ' ' << m.values.size() << '\n';
+	std::string line;
+	for(size_t entry = 0; entry < m.values.size(); ++entry) {
+	    line.clear();
+	    line += std::to_string(m.rowIndices[entry] + 1);
+	    line += ' ';
+	    line += std::to_string(m.colIndices[entry] + 1);
+	    line += ' ';
+	    formatValue(m.values[entry], line);
+	    line += '\n';
+	    output.write(line.data(), static_cast<std::streamsize>(line.size()));
+	}
+	if(!output)
+	    throw std::runtime_error {"MatrixMarket Error: Writing failed"};
+    }
+
+} /* namespace MatrixMarket */
+
+#endif /* MATRIX_MARKET_H */
@@ -0,0 +1,134 @@
+/**
+ * @file MatrixMarketTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the Matrix Market reader and writer
+*/
+
+#include "MatrixMarketTest.hh"
+
+#include <sstream>
+#include <string>
+
+#include "MatrixReader.hh"
+
+namespace {
+
+void readArrayTest(void) {
+
+    /* Arrays are stored column after column, comments and empty lines are skipped */
+    std::istringstream input {"%%MatrixMarket matrix array real general\n% comment\n\n2 3\n1\n0.5\n-2\n0\n1.5e1\n3E-1\n"};
+    Matrix<Rational> m1 = MatrixMarket::readDense<Rational>(input);
+    assert(m1 == (Matrix<Rational>{{1, -2, 15}, {"1/2", 0, "3/10"}}));
+
+    /* Only the lower triangle of a symmetric array is stored */
+    std::istringstream symmetric {"%%MatrixMarket matrix array integer symmetric\n3 3\n1\n2\n3\n4\n5\n6\n"};
+    Matrix<int> m2 = MatrixMarket::readDense<int>(symmetric);
+    assert(m2 == (Matrix<int>{{1, 2, 3}, {2, 4, 5}, {3, 5, 6}}));
+
+    /* Without the diagonal for skew-symmetric storage */
+    std::istringstream skew {"%%MatrixMarket matrix array real skew-symmetric\n3 3\n1\n2\n3\n"};
+    Matrix<double> m3 = MatrixMarket::readDense<double>(skew);
+    assert(m3 == (Matrix<double>{{0, -1, -2}, {1, 0, -3}, {2, 3, 0}}));
+}
+
+void readCoordinateTest(void) {
+
+    /* Entries in any order, the rest is zero */
+    std::string text {"%%MatrixMarket matrix coordinate rational symmetric\n3 3 3\n3 1 -1/2\n1 1 4\n2 2 +7\n"};
+    std::istringstream input {text};
+    Matrix<Rational> m1 = MatrixMarket::readDense<Rational>(input);
+    assert(m1 == (Matrix<Rational>{{4, 0, "-1/2"}, {0, 7, 0}, {"-1/2", 0, 0}}));
+
+    /* The same entries as a coordinate list, with the mirrored one added */
+    std::istringstream again {text};
+    MatrixMarket::Coordinates<Rational> c = MatrixMarket::readCoordinates<Rational>(again);
+    assert(c.rows == 3 && c.cols == 3 && c.values.size() == 4);
+    assert(c.rowIndices[0] == 0 && c.colIndices[0] == 2 && c.values[0] == Rational{"-1/2"});
+    assert(c.rowIndices[1] == 2 && c.colIndices[1] == 0 && c.values[1] == Rational{"-1/2"});
+    assert(c.rowIndices[3] == 1 && c.colIndices[3] == 1 && c.values[3] == 7);
+
+    /* Pattern entries are all one */
+    std::istringstream pattern {"%%MatrixMarket matrix coordinate pattern general\n2 2 2\n1 2\n2 1\n"};
+    assert(MatrixMarket::readDense<int>(pattern) == (Matrix<int>{{0, 1}, {1, 0}}));
+}
+
+void writeTest(void) {
+
+    /* Integer entries are written with the integer field, fractions with the rational one */
+    Matrix<Rational> m {{1, 0, "2/3"}, {0, -4, 0}};
+    std::ostringstream array, coordinates;
+    MatrixMarket::writeArray(array, m);
+    assert(array.str() == "%%MatrixMarket matrix array rational general\n2 3\n1\n0\n0\n-4\n2/3\n0\n");
+    MatrixMarket::writeCoordinates(coordinates, m);
+    assert(coordinates.str() == "%%MatrixMarket matrix coordinate rational general\n2 3 3\n1 1 1\n1 3 2/3\n2 2 -4\n");
+
+    /* Both read back into the same matrix */
+    std::istringstream arrayInput {array.str()}, coordinateInput {coordinates.str()};
+    assert(MatrixMarket::readDense<Rational>(arrayInput) == m);
+    assert(MatrixMarket::readDense<Rational>(coordinateInput) == m);
+
+    std::ostringstream real;
+    MatrixMarket::writeArray(real, Matrix<double>{{0.5, 2}});
+    assert(real.str() == "%%MatrixMarket matrix array real general\n1 2\n0.5\n2\n");
+}
+
+void errorTest(void) {
+
+    /* Errors name the line */
+    auto failsAt = [](const std::string& text, const std::string& line) {
+	std::istringstream input {text};
+	try {
+	    MatrixMarket::readDense<Rational>(input);
+	} catch(const std::exception& e) {
+	    return std::string{e.what()}.starts_with("MatrixMarket Error: Line " + line + ":");
+	}
+	return false;
+    };
+    assert(failsAt("%%MatrixMarket matrix array complex general\n1 1\n1 0\n", "1"));
+    assert(failsAt("%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n", "3"));
+    assert(failsAt("%%MatrixMarket matrix coordinate real symmetric\n2 2 1\n1 2 1\n", "3"));
+    assert(failsAt("%%MatrixMarket matrix array real general\n2 1\n1\n", "3"));
+    assert(failsAt("%%MatrixMarket matrix array real general\n1 1\n1x\n", "3"));
+    assert(failsAt("%%MatrixMarket matrix array real general\n1 1\n1e99999\n", "3"));
+}
+
+void readerTest(void) {
+
+    /* The plain text reader switches to the Matrix Market format at a banner */
+    std::istringstream input {"%%MatrixMarket matrix coordinate integer general\n1 2 1\n1 2 5\ndone\n1 2\nDONE\n"};
+    MatrixReader reader {input};
+    assert(reader.read() == (Matrix<Rational>{{0, 5}}));
+    assert(reader.getLineNumber() == 4);
+    assert(reader.read() == (Matrix<Rational>{{1, 2}}));
+
+    /* An entry list cut short by the end marker ends its matrix there, the next one is still read */
+    std::istringstream shortInput {"%%MatrixMarket matrix coordinate integer general\n2 2 3\n1 1 1\n2 2 1\nDONE\n1 2\n3 4\nDONE\n5 6\nDONE\n"};
+    MatrixReader shortReader {shortInput};
+    bool failed = false;
+    try {
+	shortReader.read();
+    } catch(const std::exception& e) {
+	failed = std::string{e.what()}.find("Line 5") != std::string::npos;
+    }
+    assert(failed);
+    assert(shortReader.read() == (Matrix<Rational>{{1, 2}, {3, 4}}));
+    assert(shortReader.read() == (Matrix<Rational>{{5, 6}}));
+}
+
+} /* anonymous */
+
+void matrixMarketTest(void) {
+
+    std::puts("--- Matrix Market TC Running ---");
+    readArrayTest();
+    std::puts("-> Passed readArrayTest()");
+    readCoordinateTest();
+    std::puts("-> Passed readCoordinateTest()");
+    writeTest();
+    std::puts("-> Passed writeTest()");
+    errorTest();
+    std::puts("-> Passed errorTest()");
+    readerTest();
+    std::puts("-> Passed readerTest()");
+    std::puts("--- Matrix Market Tests Passed ---");
+}
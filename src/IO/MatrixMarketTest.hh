@@ -0,0 +1,19 @@
+/**
+ * @file MatrixMarketTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the Matrix Market reader and writer
+*/
+#ifndef MATRIX_MARKET_TEST_H
+#define MATRIX_MARKET_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "MatrixMarket.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the Matrix Market reader and writer */
+void matrixMarketTest(void);
+
+#endif /* MATRIX_MARKET_TEST_H */
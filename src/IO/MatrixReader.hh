@@ -0,0 +1,200 @@
+/**
+ * @file MatrixReader.hh
+ * @author Martin
+ * @brief File containing the streaming reader of Rational matrices in the plain text format, one row per line
+*/
+#ifndef MATRIX_READER_H
+#define MATRIX_READER_H
+
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
+
+#include "MatrixMarket.hh"
+#include "MatrixLoader.hh"
+#include "MatrixFile.hh"
+#include "MappedFile.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Size of the buffer a floating point element of a binary Matrix file is printed to, enough for the fixed form of any double */
+#define MATRIX_READER_NUMBER_BUFFER 512
+
+/** Reads Rational matrices from a text stream, one row per line with the numbers separated by spaces or tabs.
+  * A matrix ends at a line containing only DONE (or done), or at the end of the stream, and empty lines are skipped.
+  * A matrix starting with a "%%MatrixMarket" banner is read in the Matrix Market format instead, and a matrix given
+  * as a line "@<path>" is loaded from that file, by MatrixFile if it is a binary Matrix file and by MatrixLoader otherwise.
+  * Rows are parsed as they arrive and appended to the matrix, the reader keeps only a single line and a single row
+  * in memory beside it, reusing both for every line, so even large piped inputs are read in one pass.
+  */
+class MatrixReader {
+
+    private:
+	/** The stream the matrices are read from */
+	std::istream& m_input;
+	/** The current line, reused for every line */
+	std::string m_line;
+	/** The numbers of the current row, reused for every row */
+	std::vector<Rational> m_row;
+	/** The number of lines read so far, for error messages */
+	size_t m_lineNumber = 0;
+
+	/** Whether the character separates numbers, a trailing carriage return of Windows line endings included */
+	static bool isSeparator(char c) {
+	    return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	/** Reads the next line into m_line, returns false at the end of the stream or at the end of matrix marker */
+	bool nextLine(void) {
+	    if(!std::getline(m_input, m_line))
+		return false;
+	    ++m_lineNumber;
+	    std::string_view line = trimmed();
+	    return line != "DONE" && line != "done";
+	}
+
+	/** Returns the current line without the leading and trailing separators */
+	std::string_view trimmed(void) const {
+	    std::string_view line {m_line};
+	    while(!line.empty() && isSeparator(line.front())) {
+		line.remove_prefix(1);
+	    }
+	    while(!line.empty() && isSeparator(line.back())) {
+		line.remove_suffix(1);
+	    }
+	    return line;
+	}
+
+	/** Parses the current line into m_row */
+	void parseLine(void) {
+	    m_row.clear();
+	    std::string_view line = trimmed();
+	    while(!line.empty()) {
+		size_t end = 0;
+		while(end < line.size() && !isSeparator(line[end])) {
+		    ++end;
+		}
+		m_row.push_back(Rational::parse(line.substr(0, end)));
+		line.remove_prefix(end);
+		while(!line.empty() && isSeparator(line.front())) {
+		    line.remove_prefix(1);
+		}
+	    }
+	}
+
+	/** Skips the rest of the current matrix, which must only contain empty lines after a matrix given by its first line */
+	void finishMatrix(void) {
+	    while(nextLine()) {
+		if(!trimmed().empty()) {
+		    size_t line = m_lineNumber;
+		    while(nextLine()) {}
+		    throw std::runtime_error {"Reader Error: Line " + std::to_string(line) + ": Unexpected text after the Matrix"};
+		}
+	    }
+	}
+
+	/** Reads a Matrix Market matrix whose banner is the current line, skipping the rest of the matrix on errors */
+	Matrix<Rational> readMatrixMarket(void) {
+	    MatrixMarket::Reader reader {m_input, m_lineNumber};
+	    Matrix<Rational> result;
+	    try {
+		reader.readHeader(trimmed());
+		result = reader.readDense<Rational>();
+	    } catch(const std::exception&) {
+		m_lineNumber = reader.getLineNumber();
+		/* A matrix cut short by its end marker is over already, skipping would swallow the next one */
+		if(!reader.isAtEndMarker())
+		    while(nextLine()) {}
+		throw;
+	    }
+	    m_lineNumber = reader.getLineNumber();
+	    finishMatrix();
+	    return result;
+	}
+
+	/** Converts an element of a binary Matrix file, floating point values exactly to the shortest decimal that reads back to them */
+	template <typename T>
+	static Rational toRational(T value) {
+	    if constexpr (std::is_floating_point_v<T>) {
+		if(!std::isfinite(value))
+		    throw std::runtime_error {"Reader Error: Infinite or NaN element in the Matrix file"};
+		char buffer[MATRIX_READER_NUMBER_BUFFER];
+		std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed);
+		return Rational::parse(std::string_view{buffer, result.ptr});
+	    } else {
+		return Rational{value};
+	    }
+	}
+
+	/** Loads the matrix in the file named by the current line, "@<path>", skipping the rest of the matrix on errors */
+	Matrix<Rational> readFile(void) {
+	    std::string path {trimmed().substr(1)};
+	    Matrix<Rational> result;
+	    try {
+		MappedFile file {path};
+		if(MatrixFileHeader::hasMagic(file.data(), file.size())) {
+		    visitMatrixFile(std::move(file), [&result](auto view) {
+			result = Matrix<Rational>{view.getCols(), view.getRows()};
+			for(size_t row = 0; row < view.getRows(); ++row) {
+			    for(size_t col = 0; col < view.getCols(); ++col) {
+				result.at(col, row) = toRational(view.atUnchecked(col, row));
+			    }
+			}
+		    });
+		} else {
+		    result = MatrixLoader::parse<Rational>(file.text());
+		}
+	    } catch(const std::exception&) {
+		while(nextLine()) {}
+		throw;
+	    }
+	    finishMatrix();
+	    return result;
+	}
+
+    public:
+	/** Constructor, reads from the given stream, which has to outlive the reader */
+	explicit MatrixReader(std::istream& input) : m_input{input} {}
+
+	/** Whether the end of the stream was reached, a matrix read without rows is then not a matrix at all */
+	bool isAtEnd(void) const {
+	    return m_input.eof();
+	}
+
+	/** Returns the number of lines read so far */
+	size_t getLineNumber(void) const {
+	    return m_lineNumber;
+	}
+
+	/** Reads the next matrix, up to the end of matrix marker or the end of the stream.
+	  * On an invalid number or a row of the wrong length, the rest of the matrix is skipped before throwing,
+	  * so the next call starts at the next matrix.
+	  */
+	Matrix<Rational> read(void) {
+	    Matrix<Rational> result;
+	    while(nextLine()) {
+		if(trimmed().empty())
+		    continue;
+		if(result.getRows() == 0 && MatrixMarket::isBanner(trimmed()))
+		    return readMatrixMarket();
+		if(result.getRows() == 0 && trimmed().starts_with('@'))
+		    return readFile();
+		try {
+		    parseLine();
+		    result.appendRow(m_row);
+		} catch(const std::exception& e) {
+		    size_t line = m_lineNumber;
+		    while(nextLine()) {}
+		    throw std::runtime_error {"Reader Error: Line " + std::to_string(line) + ": " + e.what()};
+		}
+	    }
+	    return result;
+	}
+};
+
+#endif /* MATRIX_READER_H */
@@ -0,0 +1,81 @@
+/**
+ * @file MatrixReaderTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the streaming Matrix reader
+*/
+
+#include "MatrixReaderTest.hh"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+void readTest(void) {
+
+    /* Rows end at DONE, empty lines and extra separators are skipped */
+    std::istringstream input {"1 1/2  -3\n\n\t0.25 2 7/3 \r\n  DONE\n4 5\n6 7\n"};
+    MatrixReader reader {input};
+    Matrix<Rational> m1 = reader.read();
+    assert(m1 == (Matrix<Rational>{{1, "1/2", -3}, {"1/4", 2, "7/3"}}));
+    assert(reader.getLineNumber() == 4);
+
+    /* The next matrix starts after the marker and ends with the stream */
+    Matrix<Rational> m2 = reader.read();
+    assert(m2 == (Matrix<Rational>{{4, 5}, {6, 7}}));
+    Matrix<Rational> m3 = reader.read();
+    assert(m3.getRows() == 0 && m3.getCols() == 0);
+}
+
+void errorTest(void) {
+
+    /* Errors name the line, and the rest of the broken matrix is skipped */
+    std::istringstream input {"1 2\n3 x\n5 6\ndone\n1 2\n3\ndone\n8\n"};
+    MatrixReader reader {input};
+    bool caught = false;
+    try {
+	reader.read();
+    } catch(const std::exception& e) {
+	caught = std::string{e.what()}.starts_with("Reader Error: Line 2:");
+    }
+    assert(caught);
+    caught = false;
+    try {
+	reader.read();
+    } catch(const std::exception& e) {
+	caught = std::string{e.what()}.starts_with("Reader Error: Line 6:");
+    }
+    assert(caught);
+    assert(reader.read() == Matrix<Rational>{{8}});
+}
+
+void largeTest(void) {
+
+    /* Many rows are appended one by one */
+    std::string text;
+    for(int row = 0; row < 500; ++row) {
+	for(int col = 0; col < 20; ++col) {
+	    text += std::to_string(row * 20 + col) + "/7 ";
+	}
+	text += "\n";
+    }
+    std::istringstream input {text};
+    MatrixReader reader {input};
+    Matrix<Rational> m = reader.read();
+    assert(m.getRows() == 500 && m.getCols() == 20);
+    assert(m.at(19, 499) == Rational(9999, 7) && m.at(7, 0) == 1);
+}
+
+} /* anonymous */
+
+void matrixReaderTest(void) {
+
+    std::puts("--- Matrix Reader TC Running ---");
+    readTest();
+    std::puts("-> Passed readTest()");
+    errorTest();
+    std::puts("-> Passed errorTest()");
+    largeTest();
+    std::puts("-> Passed largeTest()");
+    std::puts("--- Matrix Reader Tests Passed ---");
+}
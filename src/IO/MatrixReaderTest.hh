@@ -0,0 +1,19 @@
+/**
+ * @file MatrixReaderTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the streaming Matrix reader
+*/
+#ifndef MATRIX_READER_TEST_H
+#define MATRIX_READER_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "MatrixReader.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the streaming Matrix reader */
+void matrixReaderTest(void);
+
+#endif /* MATRIX_READER_TEST_H */
@@ -0,0 +1,220 @@
+/**
+ * @file MatrixWriter.hh
+ * @author Martin
+ * @brief File containing the buffered writer formatting matrices as plain text, CSV or JSON
+*/
+#ifndef MATRIX_WRITER_H
+#define MATRIX_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdio>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../Matrix/Matrix.hh"
+#include "../Matrix/MatrixView.hh"
+#include "../Rational/Rational.hh"
+#include "../BigInt/BigInt.hh"
+
+/** Size in bytes the output buffer of a MatrixWriter is flushed at */
+#define MATRIX_WRITER_BUFFER_SIZE (64 * 1024)
+
+/** Text format of written matrices */
+enum class MatrixFormat {
+    /** Rows between bars with tab separated elements, as shown to the user */
+    Plain,
+    /** One line per row with comma separated elements */
+    CSV,
+    /** An array of row arrays on a single line, Rational elements as strings like "-1/2", other numbers as numbers */
+    JSON
+};
+
+/** Writes matrices and text into a reused buffer, which is written to a file only once it is full or flushed.
+  * Elements are formatted directly into the buffer, by to_chars for plain numbers and appendTo for Rationals and BigInts,
+  * or by a given visitor, so no string is created per element.
+  */
+class MatrixWriter {
+
+    private:
+	/** The file the buffer is flushed to */
+	std::FILE* m_file;
+	/** The format of written matrices */
+	MatrixFormat m_format;
+	/** The text not yet written to the file */
+	std::string m_buffer;
+
+	/** Writes the buffer to the file, throws if writing fails */
+	void writeBuffer(void) {
+	    bool written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+	    m_buffer.clear();
+	    if(!written)
+		throw std::runtime_error {"Writer Error: Writing the output failed"};
+	}
+
+	/** Writes the buffer to the file once it reached its flushing size */
+	MatrixWriter& flushIfFull(void) {
+	    if(m_buffer.size() >= MATRIX_WRITER_BUFFER_SIZE)
+		writeBuffer();
+	    return *this;
+	}
+
+    public:
+	/** Appends the text of a single element to out */
+	template <typename T>
+	static void appendElement(std::string& out, const T& value) {
+	    if constexpr (std::is_same_v<T, Rational> || std::is_same_v<T, BigInt>) {
+		value.appendTo(out);
+	    } else {
+		static_assert(std::is_arithmetic_v<T>, "MatrixWriter can only format numbers without a visitor");
+		char buffer[64];
+		out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+	    }
+	}
+
+	/** Appends a Matrix view to out in the given format, calling element(out, value) to append each element */
+	template <typename T, typename F>
+	static void append(std::string& out, MatrixView<const T> m, MatrixFormat format, const F& element) {
+	    switch(format) {
+		case MatrixFormat::Plain:
+		    for(size_t row = 0; row < m.getRows(); ++row) {
+			out += "| ";
+			for(size_t col = 0; col < m.getCols(); ++col) {
+			    element(out, m.atUnchecked(col, row));
+			    out += '\t';
+			}
+			out += "|\n";
+		    }
+		    break;
+		case MatrixFormat::CSV:
+		    for(size_t row = 0; row < m.getRows(); ++row) {
+			for(size_t col = 0; col < m.getCols(); ++col) {
+			    if(col != 0)
+				out += ',';
+			    element(out, m.atUnchecked(col, row));
+			}
+			out += '\n';
+		    }
+		    break;
+		case MatrixFormat::JSON:
+		    out += '[';
+		    for(size_t row = 0; row < m.getRows(); ++row) {
+			out += row == 0 ? "[" : ",[";
+			for(size_t col = 0; col < m.getCols(); ++col) {
+			    if(col != 0)
+				out += ',';
+			    const T& value = m.atUnchecked(col, row);
+			    /* Fractions aren't JSON numbers, and neither are infinities and NaN */
+			    if constexpr (std::is_same_v<T, Rational>) {
+				out += '"';
+				element(out, value);
+				out += '"';
+			    } else if constexpr (std::is_floating_point_v<T>) {
+				if(std::isfinite(value))
+				    element(out, value);
+				else
+				    out += "null";
+			    } else {
+				element(out, value);
+			    }
+			}
+			out += ']';
+		    }
+		    out += "]\n";
+		    break;
+	    }
+	}
+
+	template <typename T, typename F> requires (!std::is_const_v<T>)
+	static void append(std::string& out, MatrixView<T> m, MatrixFormat format, const F& element) {
+	    append(out, MatrixView<const T>{m}, format, element);
+	}
+
+	/** Appends a Matrix view to out in the given format */
+	template <typename T>
+	static void append(std::string& out, MatrixView<const T> m, MatrixFormat format) {
+	    append(out, m, format, [](std::string& text, const T& value) { appendElement(text, value); });
+	}
+	template <typename T> requires (!std::is_const_v<T>)
+	static void append(std::string& out, MatrixView<T> m, MatrixFormat format) {
+	    append(out, MatrixView<const T>{m}, format);
+	}
+	template <typename T>
+	static void append(std::string& out, const Matrix<T>& m, MatrixFormat format) {
+	    append(out, m.view(), format);
+	}
+
+	/** Parses the name of a format (plain, csv or json), throws if it is none */
+	static MatrixFormat parseFormat(std::string_view name) {
+	    if(name == "plain")
+		return MatrixFormat::Plain;
+	    if(name == "csv")
+		return MatrixFormat::CSV;
+	    if(name == "json")
+		return MatrixFormat::JSON;
+	    throw std::runtime_error {"Writer Error: Unknown format \"" + std::string{name} + "\""};
+	}
+
+	/* --- Buffered output --- */
+
+	/** Constructor, writes to the given file in the given format */
+	explicit MatrixWriter(std::FILE* file, MatrixFormat format = MatrixFormat::Plain) : m_file{file}, m_format{format} {
+	    m_buffer.reserve(MATRIX_WRITER_BUFFER_SIZE);
+	}
+
+	MatrixWriter(const MatrixWriter&) = delete;
+	MatrixWriter& operator=(const MatrixWriter&) = delete;
+
+	/** Destructor, writes out what is left in the buffer */
+	~MatrixWriter(void) {
+	    if(!m_buffer.empty())
+		std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+	}
+
+	MatrixFormat getFormat(void) const {
+	    return m_format;
+	}
+
+	void setFormat(MatrixFormat format) {
+	    m_format = format;
+	}
+
+	/** Writes text as it is */
+	MatrixWriter& write(std::string_view text) {
+	    m_buffer += text;
+	    return flushIfFull();
+	}
+
+	/** Writes a Matrix view in the format of the writer */
+	template <typename T>
+	MatrixWriter& write(MatrixView<const T> m) {
+	    append(m_buffer, m, m_format);
+	    return flushIfFull();
+	}
+	template <typename T> requires (!std::is_const_v<T>)
+	MatrixWriter& write(MatrixView<T> m) {
+	    return write(MatrixView<const T>{m});
+	}
+	template <typename T>
+	MatrixWriter& write(const Matrix<T>& m) {
+	    return write(m.view());
+	}
+
+	/** Writes a Matrix view in the format of the writer, calling element(out, value) to append each element to out */
+	template <typename T, typename F>
+	MatrixWriter& write(MatrixView<const T> m, const F& element) {
+	    append(m_buffer, m, m_format, element);
+	    return flushIfFull();
+	}
+
+	/** Writes the buffer to the file and flushes the file, throws if writing fails */
+	void flush(void) {
+	    writeBuffer();
+	    if(std::fflush(m_file) != 0)
+		throw std::runtime_error {"Writer Error: Writing the output failed"};
+	}
+};
+
+#endif /* MATRIX_WRITER_H */
@@ -0,0 +1,96 @@
+/**
+ * @file MatrixWriterTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the buffered Matrix writer
+*/
+
+#include "MatrixWriterTest.hh"
+
+#include <string>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+void formatTest(void) {
+
+    /* The plain format is the one of Matrix::print */
+    Matrix<Rational> m {{1, "-1/2", 0}, {"7/3", 4, "-5"}};
+    std::string plain;
+    MatrixWriter::append(plain, m, MatrixFormat::Plain);
+    assert(plain == m.print([](const Rational& r) { return r.toString(); }));
+    assert(plain == "| 1\t-1/2\t0\t|\n| 7/3\t4\t-5\t|\n");
+
+    std::string csv, json;
+    MatrixWriter::append(csv, m, MatrixFormat::CSV);
+    assert(csv == "1,-1/2,0\n7/3,4,-5\n");
+    MatrixWriter::append(json, m, MatrixFormat::JSON);
+    assert(json == "[[\"1\",\"-1/2\",\"0\"],[\"7/3\",\"4\",\"-5\"]]\n");
+
+    /* Plain numbers are JSON numbers, except for infinities and NaN */
+    Matrix<double> d {{0.25, -3}, {std::numeric_limits<double>::infinity(), 1e100}};
+    json.clear();
+    MatrixWriter::append(json, d, MatrixFormat::JSON);
+    assert(json == "[[0.25,-3],[null,1e+100]]\n");
+    csv.clear();
+    MatrixWriter::append(csv, Matrix<int>{{-1, 2}}, MatrixFormat::CSV);
+    assert(csv == "-1,2\n");
+
+    /* Big numbers are written the same as by toString */
+    Rational big = Rational{"123456789012345678901234567890/7"} * Rational{"-1/11"};
+    std::string text;
+    MatrixWriter::appendElement(text, big);
+    assert(text == big.toString() && text == "-17636684144620811271604938270/11");
+    text.clear();
+    MatrixWriter::appendElement(text, BigInt{"-1000000000000000000000000000001"});
+    assert(text == "-1000000000000000000000000000001");
+}
+
+void visitorTest(void) {
+
+    /* Elements can be formatted by a visitor, here of a transposed view */
+    Matrix<int> m {{1, 2}, {3, 4}};
+    std::string out;
+    MatrixWriter::append(out, m.view().transposed(), MatrixFormat::CSV, [](std::string& text, int value) { text += std::string(static_cast<size_t>(value), '*'); });
+    assert(out == "*,***\n**,****\n");
+}
+
+void bufferTest(void) {
+
+    /* Text and matrices reach the file in order, only once flushed or full */
+    std::FILE* file = std::tmpfile();
+    assert(file != nullptr);
+    {
+	MatrixWriter writer {file, MatrixFormat::CSV};
+	writer.write("A:\n").write(Matrix<Rational>{{"1/2", 3}});
+	assert(std::ftell(file) == 0);
+	writer.flush();
+	assert(std::ftell(file) == 9);
+	writer.setFormat(MatrixFormat::JSON);
+	Matrix<int> large {1000, 20, 12345};
+	writer.write(large);
+	assert(std::ftell(file) > 9);
+	writer.write("end\n");
+    }
+    std::string content (static_cast<size_t>(std::ftell(file)), '\0');
+    std::rewind(file);
+    assert(std::fread(content.data(), 1, content.size(), file) == content.size());
+    std::fclose(file);
+    assert(content.starts_with("A:\n1/2,3\n[[12345,12345,"));
+    assert(content.ends_with("12345]]\nend\n"));
+    assert(content.size() == 9 + 1 + 20 * (2 + 1000 * 5 + 999) + 19 + 2 + 4);
+}
+
+} /* anonymous */
+
+void matrixWriterTest(void) {
+
+    std::puts("--- Matrix Writer TC Running ---");
+    formatTest();
+    std::puts("-> Passed formatTest()");
+    visitorTest();
+    std::puts("-> Passed visitorTest()");
+    bufferTest();
+    std::puts("-> Passed bufferTest()");
+    std::puts("--- Matrix Writer Tests Passed ---");
+}
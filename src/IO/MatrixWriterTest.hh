@@ -0,0 +1,20 @@
+/**
+ * @file MatrixWriterTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the buffered Matrix writer
+*/
+#ifndef MATRIX_WRITER_TEST_H
+#define MATRIX_WRITER_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "MatrixWriter.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Matrix/MatrixView.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the buffered Matrix writer */
+void matrixWriterTest(void);
+
+#endif /* MATRIX_WRITER_TEST_H */
@@ -11,7 +11,48 @@
 #include <memory>
 #include <cstdint>
 #include <initializer_list>
-#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <span>
+#include <cstring>
+
+#include "MatrixKernel.hh"
+#include "../Thread/ThreadPool.hh"
+
+/** Minimum number of elements before element-wise Matrix operations are split across the global thread pool */
+#define MATRIX_PARALLEL_GRAIN 16384
+
+/** Tag base of the lazy element-wise expression nodes (see MatrixExpr.hh) and views (see MatrixView.hh), which can be evaluated into a Matrix */
+struct MatrixExprTag {};
+
+/** Memory layout of a block of Matrix elements, used to detect expressions that read an assignment target at other positions */
+struct MatrixLayout {
+    /** Address of the element at (0, 0) */
+    const void* origin;
+    /** Address range spanned by the elements */
+    const void* begin;
+    const void* end;
+    /** Distances between vertically and horizontally adjacent elements */
+    size_t rowStride;
+    size_t colStride;
+
+    /** Returns the layout of (columns x rows) elements starting at data, with the given strides */
+    template <typename T>
+    static MatrixLayout of(const T* data, size_t columns, size_t rows, size_t rowStride, size_t colStride) {
+	const T* end = (columns == 0 || rows == 0) ? data : data + ((rows - 1) * rowStride) + ((columns - 1) * colStride) + 1;
+	return {data, data, end, rowStride, colStride};
+    }
+
+    /** Whether a source with the given layout overlaps this target while addressing its elements differently */
+    bool conflicts(const MatrixLayout& source) const {
+	std::less<const void*> less;
+	bool overlap = less(source.begin, end) && less(begin, source.end);
+	return overlap && !(source.origin == origin && source.rowStride == rowStride && source.colStride == colStride);
+    }
+};
+
+template <typename T>
+class MatrixView;
 
 /** Class representing an N by M matrix of any object */
 template <typename T>
@@ -24,6 +65,8 @@ class Matrix {
 	size_t m_rows;
 	/** The data stored in the matrix, represented as a contiguous block of rows */
 	std::unique_ptr<T[]> m_data;
+	/** The number of elements allocated in the data block, at least (columns x rows), the rest is room for appended rows */
+	size_t m_capacity = 0;
 
 	/** Calculates a flat index for the data array from a pair of (column, row) coords */
 	size_t getFlatIndex(size_t column, size_t row) const {
@@ -38,13 +81,43 @@ class Matrix {
 		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
 	}
 
+	/** Evaluates an expression element by element into the given buffer, splitting it across the thread pool for large matrices */
+	template <typename E>
+	static void evaluateInto(T* data, const E& expr) {
+	    ThreadPool::global().parallelFor(0, expr.getCols() * expr.getRows(), MATRIX_PARALLEL_GRAIN, [data, &expr](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] = expr[idx];
+		}
+	    });
+	}
+
+	/** Validates that an expression has the same shape as this Matrix */
+	template <typename E>
+	void checkShape(const E& expr, const char* error) const {
+	    if(m_rows != expr.getRows() || m_cols != expr.getCols())
+		throw std::runtime_error {error};
+	}
+
     public:
+	/** The type of the elements, used by the expression templates */
+	using value_type = T;
+
+	/** Copies count elements between non-overlapping buffers, as a single memcpy for trivially copyable types */
+	static void copyElements(const T* source, size_t count, T* target) {
+	    if constexpr (std::is_trivially_copyable_v<T>) {
+		if(count > 0)
+		    std::memcpy(target, source, count * sizeof(T));
+	    } else {
+		std::copy_n(source, count, target);
+	    }
+	}
+
 	/** Constructor, creates a matrix of shape (columns x rows) */
-	Matrix(size_t columns, size_t rows) : m_cols{columns}, m_rows{rows} {
+	Matrix(size_t columns, size_t rows) : m_cols{columns}, m_rows{rows}, m_capacity{columns * rows} {
 	    m_data = std::make_unique<T[]>(m_cols * m_rows);
 	}
 	/** Constructor, creates a matrix of shape (columns x rows) and populates it with the given value */
-	Matrix(size_t columns, size_t rows, const T& value) : m_cols{columns}, m_rows{rows} {
+	Matrix(size_t columns, size_t rows, const T& value) : m_cols{columns}, m_rows{rows}, m_capacity{columns * rows} {
 	    m_data = std::make_unique_for_overwrite<T[]>(m_cols * m_rows);
 	    /* Populating the array */
 	    for(size_t idx = 0; idx < (m_cols * m_rows); ++idx) {
@@ -63,6 +136,7 @@ class Matrix {
 		}
 		/* Initialize and populate Matrix data */
 		m_data = std::make_unique_for_overwrite<T[]>(m_cols * m_rows);
+		m_capacity = m_cols * m_rows;
 		size_t idx = 0;
 		for(auto row : list) {
 		    for(auto element : row) {
@@ -78,8 +152,21 @@ class Matrix {
 	    }
 	}
 	/** Copy constructor */
-	Matrix(const Matrix<T>& other) {
-	    *this = other;
+	Matrix(const Matrix<T>& other) : m_cols{other.m_cols}, m_rows{other.m_rows}, m_capacity{other.m_cols * other.m_rows} {
+	    m_data = std::make_unique_for_overwrite<T[]>(m_cols * m_rows);
+	    copyElements(other.m_data.get(), m_cols * m_rows, m_data.get());
+	}
+	/** Move constructor, takes over the data of other and leaves it as an empty Matrix */
+	Matrix(Matrix<T>&& other) noexcept : m_cols{other.m_cols}, m_rows{other.m_rows}, m_data{std::move(other.m_data)}, m_capacity{other.m_capacity} {
+	    other.m_cols = 0;
+	    other.m_rows = 0;
+	    other.m_capacity = 0;
+	}
+	/** Constructor, evaluates a lazy element-wise expression in a single pass over memory */
+	template <typename E> requires std::is_base_of_v<MatrixExprTag, E>
+	Matrix(const E& expr) : m_cols{expr.getCols()}, m_rows{expr.getRows()}, m_capacity{expr.getCols() * expr.getRows()} {
+	    m_data = std::make_unique_for_overwrite<T[]>(m_cols * m_rows);
+	    evaluateInto(m_data.get(), expr);
 	}
 	/** Empty constructor */
 	Matrix(void) {
@@ -99,31 +186,131 @@ class Matrix {
 	void resize(size_t newCols, size_t newRows) {
 	    /* Allocating new data block */
 	    std::unique_ptr<T[]> newData = std::make_unique<T[]>(newCols * newRows);
-	    /* Copying old data to new block */
+	    /* Moving old data to new block, the kept part of each row at once */
+	    size_t keptCols = std::min(m_cols, newCols);
 	    for(size_t row = 0; (row < m_rows && row < newRows); ++row) {
-		for(size_t col = 0; (col < m_cols && col < newCols); ++col) {
-		    newData[Matrix::getFlatIndex(col, row, newCols, newRows)] = m_data[getFlatIndex(col, row)];
-		}
+		T* source = m_data.get() + (row * m_cols);
+		if constexpr (std::is_trivially_copyable_v<T>)
+		    copyElements(source, keptCols, newData.get() + (row * newCols));
+		else
+		    std::move(source, source + keptCols, newData.get() + (row * newCols));
 	    }
 	    /* Overwriting existing data with new data */
 	    m_cols = newCols;
 	    m_rows = newRows;
 	    m_data = std::move(newData);
+	    m_capacity = newCols * newRows;
+	}
+
+	/** Reserves room for the given number of rows of the current width, so appending rows up to it doesn't reallocate */
+	void reserveRows(size_t rows) {
+	    if(rows * m_cols <= m_capacity)
+		return;
+	    std::unique_ptr<T[]> newData = std::make_unique<T[]>(rows * m_cols);
+	    if constexpr (std::is_trivially_copyable_v<T>)
+		copyElements(m_data.get(), m_cols * m_rows, newData.get());
+	    else
+		std::move(m_data.get(), m_data.get() + (m_cols * m_rows), newData.get());
+	    m_data = std::move(newData);
+	    m_capacity = rows * m_cols;
+	}
+
+	/** Appends a row to the bottom of the Matrix, moving the given elements in. The first row of a Matrix without rows sets its width.
+	  * The data block grows geometrically, so appending n rows one by one takes amortized linear time.
+	  */
+	void appendRow(std::span<T> row) {
+	    if(m_rows == 0)
+		m_cols = row.size();
+	    else if(row.size() != m_cols)
+		throw std::runtime_error {"Matrix Error: Appended row has the wrong number of columns"};
+	    if((m_rows + 1) * m_cols > m_capacity)
+		reserveRows(std::max<size_t>(2 * m_rows, 4));
+	    std::move(row.begin(), row.end(), m_data.get() + (m_rows * m_cols));
+	    ++m_rows;
 	}
 
 	/** Prints the Matrix instance in a fancy way, using the provided toString function to convert each element */
-	std::string print(const std::function<std::string(T)>& toString) const {
+	template <typename F>
+	std::string print(const F& toString) const {
 	    std::string result;
 	    for(size_t row = 0; row < m_rows; ++row) {
 		result += "| ";
 		for(size_t column = 0; column < m_cols; ++column) {
-		    result += toString((this->at(column, row))) + "\t";
+		    result += toString(atUnchecked(column, row));
+		    result += '\t';
 		}
 		result += "|\n";
 	    }
 	    return result;
 	}
 
+	/** Returns the memory layout of the Matrix, for alias detection in expressions */
+	MatrixLayout layout(void) const {
+	    return MatrixLayout::of(m_data.get(), m_cols, m_rows, m_cols, 1);
+	}
+
+	/* --- Views --- */
+
+	/** Returns a view of the whole Matrix */
+	MatrixView<T> view(void) {
+	    return {m_data.get(), m_cols, m_rows, m_cols, 1};
+	}
+
+	/** Returns a read-only view of the whole Matrix */
+	MatrixView<const T> view(void) const {
+	    return {m_data.get(), m_cols, m_rows, m_cols, 1};
+	}
+
+	/** Returns a view of the (columns x rows) block starting at (column, row) */
+	MatrixView<T> subView(size_t column, size_t row, size_t columns, size_t rows) {
+	    return view().subView(column, row, columns, rows);
+	}
+
+	/** Returns a read-only view of the (columns x rows) block starting at (column, row) */
+	MatrixView<const T> subView(size_t column, size_t row, size_t columns, size_t rows) const {
+	    return view().subView(column, row, columns, rows);
+	}
+
+	/** Returns a view of the given row */
+	MatrixView<T> rowView(size_t row) {
+	    return view().rowView(row);
+	}
+
+	/** Returns a read-only view of the given row */
+	MatrixView<const T> rowView(size_t row) const {
+	    return view().rowView(row);
+	}
+
+	/** Returns a view of the given column */
+	MatrixView<T> colView(size_t column) {
+	    return view().colView(column);
+	}
+
+	/** Returns a read-only view of the given column */
+	MatrixView<const T> colView(size_t column) const {
+	    return view().colView(column);
+	}
+
+	/** Returns a lazily transposed view of the Matrix */
+	MatrixView<T> transposed(void) {
+	    return view().transposed();
+	}
+
+	/** Returns a lazily transposed read-only view of the Matrix */
+	MatrixView<const T> transposed(void) const {
+	    return view().transposed();
+	}
+
+	/** Returns a pointer to the contiguous row-major data block */
+	T* data(void) {
+	    return m_data.get();
+	}
+
+	/** Returns a pointer to the contiguous row-major data block */
+	const T* data(void) const {
+	    return m_data.get();
+	}
+
 	T& at(size_t column, size_t row) {
 	    return m_data[getFlatIndex(column, row)];
 	}
@@ -132,6 +319,30 @@ class Matrix {
 	    return m_data[getFlatIndex(column, row)];
 	}
 
+	/** Element access without the bounds check, the caller guarantees that (column, row) lies inside the Matrix */
+	T& atUnchecked(size_t column, size_t row) {
+	    return m_data[(row * m_cols) + column];
+	}
+
+	/** Element access without the bounds check, the caller guarantees that (column, row) lies inside the Matrix */
+	const T& atUnchecked(size_t column, size_t row) const {
+	    return m_data[(row * m_cols) + column];
+	}
+
+	/** Returns the given row as a contiguous span, checking only the row index */
+	std::span<T> rowSpan(size_t row) {
+	    if(row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return {m_data.get() + (row * m_cols), m_cols};
+	}
+
+	/** Returns the given row as a contiguous span, checking only the row index */
+	std::span<const T> rowSpan(size_t row) const {
+	    if(row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return {m_data.get() + (row * m_cols), m_cols};
+	}
+
 	/* --- Operators --- */
 
 	Matrix& operator=(const Matrix& other) {
@@ -140,13 +351,49 @@ class Matrix {
 		return *this;
 	    }
 
+	    /* Reuse the existing data block if the element count matches, otherwise allocate a new one */
+	    if(this->m_cols * this->m_rows != other.m_cols * other.m_rows) {
+		this->m_data = std::make_unique_for_overwrite<T[]>(other.m_cols * other.m_rows);
+		this->m_capacity = other.m_cols * other.m_rows;
+	    }
 	    /* Copy rows, columns and data from other, then return self */
 	    this->m_rows = other.m_rows;
 	    this->m_cols = other.m_cols;
-	    this->m_data = std::make_unique<T[]>(this->m_cols * this->m_rows);
-	    for(size_t i = 0; i < this->m_cols * this->m_rows; ++i) {
-		this->m_data[i] = other.m_data[i];
+	    copyElements(other.m_data.get(), this->m_cols * this->m_rows, this->m_data.get());
+	    return *this;
+	}
+
+	Matrix& operator=(Matrix&& other) noexcept {
+	    /* Guard self-assignment */
+	    if(this == &other) {
+		return *this;
 	    }
+
+	    /* Take over the data of other, leaving it as an empty Matrix */
+	    this->m_rows = other.m_rows;
+	    this->m_cols = other.m_cols;
+	    this->m_data = std::move(other.m_data);
+	    this->m_capacity = other.m_capacity;
+	    other.m_rows = 0;
+	    other.m_cols = 0;
+	    other.m_capacity = 0;
+	    return *this;
+	}
+
+	/** Assigns a lazy element-wise expression, evaluating it in a single pass */
+	template <typename E> requires std::is_base_of_v<MatrixExprTag, E>
+	Matrix& operator=(const E& expr) {
+	    if(m_cols * m_rows == expr.getCols() * expr.getRows() && !expr.conflicts(layout())) {
+		/* Element-wise expressions only read the same index they write, so evaluating in place is safe unless a view reads this Matrix differently */
+		evaluateInto(m_data.get(), expr);
+	    } else {
+		std::unique_ptr<T[]> newData = std::make_unique_for_overwrite<T[]>(expr.getCols() * expr.getRows());
+		evaluateInto(newData.get(), expr);
+		m_data = std::move(newData);
+		m_capacity = expr.getCols() * expr.getRows();
+	    }
+	    m_cols = expr.getCols();
+	    m_rows = expr.getRows();
 	    return *this;
 	}
 
@@ -175,76 +422,130 @@ class Matrix {
 	    if(this->getRows() != rhs.getRows() || this->getCols() != rhs.getCols()) {
 		throw std::runtime_error {"Matrix Error: Can't add Matrices of different dimensions"};
 	    }
-	    /* Performing addition */
-	    for(size_t row = 0; row < this->getRows(); ++row) {
-		for(size_t col = 0; col < this->getCols(); ++col) {
-		    this->at(col, row) += rhs.at(col, row);
+	    /* Performing addition, element-wise over the flat buffers, split across the thread pool for large matrices */
+	    T* data = m_data.get();
+	    const T* other = rhs.m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [data, other](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] += other[idx];
 		}
-	    }
+	    });
 	    return *this;
 	}
 
-	friend Matrix<T> operator+(Matrix<T> lhs, const Matrix<T>& rhs) {
-	    lhs += rhs;
-	    return lhs;
-	}
-
-	friend Matrix<T> operator*(const Matrix<T>& lhs, const Matrix<T>& rhs) {
-	    /* Validating that multiplication can be done */
-	    if(lhs.getCols() != rhs.getRows()) {
-		throw std::runtime_error {"Matrix Error: Can't multiply Matrices of incompatible dimensions"};
+	Matrix<T>& operator-=(const Matrix<T>& rhs) {
+	    /* Validating that subtraction can be done */
+	    if(this->getRows() != rhs.getRows() || this->getCols() != rhs.getCols()) {
+		throw std::runtime_error {"Matrix Error: Can't subtract Matrices of different dimensions"};
 	    }
-	    /* Make a new Matrix of the correct dimensions, multiply */
-	    Matrix<T> result {rhs.getCols(), lhs.getRows()};
-	    for(size_t row = 0; row < result.getRows(); ++row) {
-		for(size_t col = 0; col < result.getCols(); ++col) {
-		    /* Do the dot product */
-		    for(size_t idx = 0; idx < lhs.getCols(); ++idx) {
-			result.at(col, row) += lhs.at(idx, row) * rhs.at(col, idx);
-		    }
+	    /* Performing subtraction in place */
+	    T* data = m_data.get();
+	    const T* other = rhs.m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [data, other](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] -= other[idx];
 		}
-	    }
-	    return result;
+	    });
+	    return *this;
 	}
 
-	friend Matrix<T> operator*(const T& lhs, const Matrix<T>& rhs) {
-	    Matrix<T> result {rhs.getCols(), rhs.getRows()};
-	    for(size_t row = 0; row < rhs.getRows(); ++row) {
-		for(size_t col = 0; col < rhs.getCols(); ++col) {
-		    result.at(col, row) = lhs * rhs.at(col, row);
+	/** Adds a lazy element-wise expression in place, in a single pass */
+	template <typename E> requires std::is_base_of_v<MatrixExprTag, E>
+	Matrix<T>& operator+=(const E& expr) {
+	    checkShape(expr, "Matrix Error: Can't add Matrices of different dimensions");
+	    if(expr.conflicts(layout()))
+		return *this += Matrix<T>{expr};
+	    T* data = m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [data, &expr](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] += expr[idx];
 		}
-	    }
-	    return result;
+	    });
+	    return *this;
 	}
 
-	friend Matrix<T> operator*(const Matrix<T>& lhs, const T& rhs) {
-	    Matrix<T> result {lhs.getCols(), lhs.getRows()};
-	    for(size_t row = 0; row < lhs.getRows(); ++row) {
-		for(size_t col = 0; col < lhs.getCols(); ++col) {
-		    result.at(col, row) = lhs.at(col, row) * rhs;
+	/** Subtracts a lazy element-wise expression in place, in a single pass */
+	template <typename E> requires std::is_base_of_v<MatrixExprTag, E>
+	Matrix<T>& operator-=(const E& expr) {
+	    checkShape(expr, "Matrix Error: Can't subtract Matrices of different dimensions");
+	    if(expr.conflicts(layout()))
+		return *this -= Matrix<T>{expr};
+	    T* data = m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [data, &expr](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] -= expr[idx];
 		}
-	    }
-	    return result;
+	    });
+	    return *this;
 	}
 
-	Matrix<T> operator*=(const Matrix<T>& rhs) {
-	    *this = *this * rhs;
+	/** Multiplies every element by the given scalar, in place */
+	Matrix<T>& operator*=(const T& rhs) {
+	    T* data = m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [&rhs, data](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] *= rhs;
+		}
+	    });
 	    return *this;
 	}
 
-	Matrix<T>& operator-=(const Matrix<T>& rhs) {
-	    *this += (-1 * rhs);
+	/** Divides every element by the given scalar, in place */
+	Matrix<T>& operator/=(const T& rhs) {
+	    T* data = m_data.get();
+	    ThreadPool::global().parallelFor(0, m_cols * m_rows, MATRIX_PARALLEL_GRAIN, [&rhs, data](size_t begin, size_t end) {
+		for(size_t idx = begin; idx < end; ++idx) {
+		    data[idx] /= rhs;
+		}
+	    });
 	    return *this;
 	}
 
-	friend Matrix<T> operator-(Matrix<T> lhs, const Matrix<T>& rhs) {
-	    lhs -= rhs;
-	    return lhs;
+	friend Matrix<T> operator*(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+	    return multiply(lhs.view(), rhs.view());
 	}
 
+	Matrix<T>& operator*=(const Matrix<T>& rhs) {
+	    /* The product needs a new data block anyway, move it in instead of copying */
+	    *this = *this * rhs;
+	    return *this;
+	}
 
 	/* --- Static members --- */
 
+	/** Returns the product of two (possibly strided or transposed) views, used by all Matrix multiplication operators */
+	static Matrix<T> multiply(MatrixView<const T> lhs, MatrixView<const T> rhs) {
+	    /* Validating that multiplication can be done */
+	    if(lhs.getCols() != rhs.getRows()) {
+		throw std::runtime_error {"Matrix Error: Can't multiply Matrices of incompatible dimensions"};
+	    }
+	    /* Make a new Matrix of the correct dimensions, multiply */
+	    Matrix<T> result {rhs.getCols(), lhs.getRows()};
+	    /* Arithmetic types use the packed, cache-blocked kernel, which reads the views through their strides */
+	    if constexpr (MatrixKernel::isKernelType<T>) {
+		MatrixKernel::parallelGemm(lhs.getRows(), rhs.getCols(), lhs.getCols(),
+					   lhs.data(), lhs.getRowStride(), lhs.getColStride(),
+					   rhs.data(), rhs.getRowStride(), rhs.getColStride(),
+					   result.m_data.get(), result.getCols(), 1);
+		return result;
+	    }
+	    /* Other types do the dot products directly, with the rows of the result split across the thread pool */
+	    size_t work = std::max<size_t>(result.getCols() * lhs.getCols(), 1);
+	    ThreadPool::global().parallelFor(0, result.getRows(), (MATRIX_PARALLEL_GRAIN / 16 + work - 1) / work, [&](size_t begin, size_t end) {
+		for(size_t row = begin; row < end; ++row) {
+		    for(size_t col = 0; col < result.getCols(); ++col) {
+			/* Do the dot product */
+			T sum {};
+			for(size_t idx = 0; idx < lhs.getCols(); ++idx) {
+			    sum += lhs.atUnchecked(idx, row) * rhs.atUnchecked(col, idx);
+			}
+			result.atUnchecked(col, row) = sum;
+		    }
+		}
+	    });
+	    return result;
+	}
+
 	/** Convenience function, returns the Identity matrix I_n of the given size n */
 	static Matrix<T> identity(size_t n) {
 	    Matrix<T> m {n, n, 0};
@@ -255,4 +556,8 @@ class Matrix {
 	}
 };
 
+/* Views and lazy element-wise arithmetic (+, -, unary -, scalar *) are provided by their own headers */
+#include "MatrixView.hh"
+#include "MatrixExpr.hh"
+
 #endif /* MATRIX_H */
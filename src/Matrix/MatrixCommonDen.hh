@@ -0,0 +1,260 @@
+/**
+ * @file MatrixCommonDen.hh
+ * @author Martin
+ * @brief File containing the common-denominator storage of a Rational Matrix, each row an integer vector over one shared denominator
+*/
+#ifndef MATRIX_COMMON_DEN_H
+#define MATRIX_COMMON_DEN_H
+
+#include <vector>
+#include <span>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+#include "../BigInt/BigInt.hh"
+#include "../Thread/ThreadPool.hh"
+
+/** Rational Matrix stored row by row as integer numerators over one positive denominator shared by the whole row.
+  * Row operations then only multiply and subtract integers, and instead of simplifying every element on its own,
+  * a row is brought into lowest terms by a single pass taking the gcd of its content and its denominator.
+  */
+class MatrixCommonDen {
+
+    private:
+	/** The integer numerators of every row */
+	Matrix<BigInt> m_num;
+	/** The positive denominator of each row */
+	std::vector<BigInt> m_den;
+
+    public:
+	/** Constructor, creates a zero matrix of shape (columns x rows) */
+	MatrixCommonDen(size_t columns, size_t rows) : m_num{columns, rows}, m_den(rows, BigInt{1}) {}
+
+	/** Returns the common-denominator copy of a Rational Matrix, each row scaled by the lcm of its denominators */
+	static MatrixCommonDen from(const Matrix<Rational>& m) {
+	    MatrixCommonDen result {m.getCols(), m.getRows()};
+	    for(size_t row = 0; row < m.getRows(); ++row) {
+		BigInt& scale = result.m_den[row];
+		for(size_t col = 0; col < m.getCols(); ++col) {
+		    BigInt den = m.atUnchecked(col, row).getBigDenominator();
+		    if(den != 1)
+			scale = scale / gcd(scale, den) * den;
+		}
+		for(size_t col = 0; col < m.getCols(); ++col) {
+		    const Rational& entry = m.atUnchecked(col, row);
+		    if(entry == 0)
+			continue;
+		    BigInt value = entry.getBigNumerator() * (scale / entry.getBigDenominator());
+		    result.m_num.atUnchecked(col, row) = entry.isNegative() ? value.negate() : value;
+		}
+	    }
+	    return result;
+	}
+
+	/** Writes the elements back into a Rational Matrix of the same shape */
+	void copyTo(Matrix<Rational>& m) const {
+	    if(m.getCols() != getCols() || m.getRows() != getRows())
+		throw std::runtime_error {"Matrix Error: Can't copy into a Matrix of different dimensions"};
+	    for(size_t row = 0; row < getRows(); ++row) {
+		for(size_t col = 0; col < getCols(); ++col) {
+		    const BigInt& entry = m_num.atUnchecked(col, row);
+		    m.atUnchecked(col, row) = entry.isZero() ? Rational{} : Rational{entry, m_den[row]};
+		}
+	    }
+	}
+
+	size_t getRows(void) const {
+	    return m_num.getRows();
+	}
+
+	size_t getCols(void) const {
+	    return m_num.getCols();
+	}
+
+	/** Returns the element at (column, row) as a Rational */
+	Rational at(size_t column, size_t row) const {
+	    const BigInt& entry = m_num.at(column, row);
+	    return entry.isZero() ? Rational{} : Rational{entry, m_den[row]};
+	}
+
+	/** Returns the numerators of the given row */
+	std::span<BigInt> numerators(size_t row) {
+	    if(row >= getRows())
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return m_num.rowSpan(row);
+	}
+	std::span<const BigInt> numerators(size_t row) const {
+	    if(row >= getRows())
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return m_num.rowSpan(row);
+	}
+
+	/** Returns the denominator of the given row */
+	BigInt& denominator(size_t row) {
+	    if(row >= getRows())
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return m_den[row];
+	}
+	const BigInt& denominator(size_t row) const {
+	    if(row >= getRows())
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return m_den[row];
+	}
+
+	/** Brings a row into lowest terms, dividing the numerators and the denominator by their common gcd.
+	  * The gcd pass stops as soon as it reaches one, which for most rows is after the first few entries.
+	  */
+	void normalize(size_t row) {
+	    std::span<BigInt> num = numerators(row);
+	    BigInt& den = m_den[row];
+	    BigInt divisor = den;
+	    for(const BigInt& entry : num) {
+		if(divisor == 1)
+		    return;
+		if(!entry.isZero())
+		    divisor = gcd(divisor, entry);
+	    }
+	    for(BigInt& entry : num) {
+		if(!entry.isZero())
+		    entry /= divisor;
+	    }
+	    den /= divisor;
+	}
+};
+
+
+/** Namespace containing basic Matrix row operations */
+namespace MatrixRowOps {
+
+    /** Integer axpy on rows given as spans of equal length, target = a * target - b * source */
+    inline void rowAxpy(std::span<BigInt> target, const BigInt& a, const BigInt& b, std::span<const BigInt> source) {
+	if(target.size() != source.size())
+	    throw std::runtime_error {"Matrix Error: Can't combine rows of different lengths"};
+	bool scale = a != 1;
+	for(size_t idx = 0; idx < target.size(); ++idx) {
+	    if(scale && !target[idx].isZero())
+		target[idx] *= a;
+	    if(!source[idx].isZero())
+		target[idx] -= b * source[idx];
+	}
+    }
+
+    /** Substitutes a multiple of row2 from row1 (row1 -= multiple * row2) of a common-denominator Matrix.
+      * With x = v1 / d1 and y = v2 / d2, x - (p / q) * y is (a * v1 - b * v2) / lcm(d1, q * d2) for the integer
+      * factors a = lcm / d1 and b = p * lcm / (q * d2), so the row is updated by one integer axpy.
+      */
+    inline void rowSub(MatrixCommonDen& m, size_t row1Idx, const Rational& multiple, size_t row2Idx) {
+	if(multiple == 0)
+	    return;
+	BigInt& d1 = m.denominator(row1Idx);
+	BigInt e = multiple.getBigDenominator() * m.denominator(row2Idx);
+	BigInt g = gcd(d1, e);
+	BigInt a = e / g;
+	BigInt b = multiple.getBigNumerator() * (d1 / g);
+	if(multiple.isNegative())
+	    b.negate();
+	rowAxpy(m.numerators(row1Idx), a, b, m.numerators(row2Idx));
+	d1 *= a;
+	m.normalize(row1Idx);
+    }
+
+    /** Clears the entry at the given column of a row of a common-denominator Matrix with a pivot row, which must be non-zero there.
+      * With the entries u of the row and w of the pivot row, g = gcd(u, w), the row becomes ((w / g) * row - (u / g) * pivot row),
+      * the pivot row's denominator cancels out and the row's denominator is only scaled by w / g.
+      */
+    inline void rowEliminate(MatrixCommonDen& m, size_t rowIdx, size_t pivotRowIdx, size_t col) {
+	const BigInt& u = m.numerators(rowIdx)[col];
+	const BigInt& w = m.numerators(pivotRowIdx)[col];
+	if(u.isZero())
+	    return;
+	if(w.isZero())
+	    throw std::runtime_error {"Matrix Error: Can't eliminate with a zero pivot"};
+	BigInt g = gcd(u, w);
+	BigInt a = w / g;
+	BigInt b = u / g;
+	/* Negating both factors negates the numerators, which keeps the denominator positive */
+	if(a.isNegative()) {
+	    a.negate();
+	    b.negate();
+	}
+	rowAxpy(m.numerators(rowIdx), a, b, m.numerators(pivotRowIdx));
+	m.denominator(rowIdx) *= a;
+	m.normalize(rowIdx);
+    }
+
+    /** Divides a row of a common-denominator Matrix by a non-zero Rational, v / d / (p / q) = (q * v) / (p * d) */
+    inline void rowDiv(MatrixCommonDen& m, size_t rowIdx, const Rational& divisor) {
+	if(divisor == 0)
+	    throw std::runtime_error {"Rational Error: Zero has no inverse element"};
+	BigInt scale = divisor.getBigDenominator();
+	if(divisor.isNegative())
+	    scale.negate();
+	for(BigInt& entry : m.numerators(rowIdx)) {
+	    if(!entry.isZero())
+		entry *= scale;
+	}
+	m.denominator(rowIdx) *= divisor.getBigNumerator();
+	m.normalize(rowIdx);
+    }
+
+    /** Swaps two rows of a common-denominator Matrix */
+    inline void rowSwap(MatrixCommonDen& m, size_t row1Idx, size_t row2Idx) {
+	if(row1Idx == row2Idx)
+	    return;
+	std::span<BigInt> num1 = m.numerators(row1Idx), num2 = m.numerators(row2Idx);
+	std::swap_ranges(num1.begin(), num1.end(), num2.begin());
+	std::swap(m.denominator(row1Idx), m.denominator(row2Idx));
+    }
+
+} /* namespace MatrixRowOps */
+
+
+/** Namespace containing Matrix Reduction functions */
+namespace MatrixReduce {
+
+    /** Gauss-Jordan elimination of a common-denominator Matrix, in place, returns the pivot column of each pivot row.
+      * Without reduced only the entries below each pivot are eliminated (REF), with reduced the entries above as well (RREF).
+      * Row operations don't depend on the scale of the pivot row, so pivots are only normalized to one at the very end.
+      */
+    inline std::vector<size_t> reduceCommonDen(MatrixCommonDen& m, bool reduced) {
+	std::vector<size_t> pivotCols;
+	for(size_t col = 0; col < m.getCols() && pivotCols.size() < m.getRows(); ++col) {
+	    size_t pivotRow = pivotCols.size();
+	    /* Find the first row with a non-zero entry in this column */
+	    size_t rowIdx = pivotRow;
+	    while(rowIdx < m.getRows() && m.numerators(rowIdx)[col].isZero()) {
+		++rowIdx;
+	    }
+	    if(rowIdx == m.getRows())
+		continue;
+	    MatrixRowOps::rowSwap(m, rowIdx, pivotRow);
+	    /* Rows are independent of each other, so they are updated in parallel */
+	    ThreadPool::global().parallelFor(reduced ? 0 : pivotRow + 1, m.getRows(), 4, [&](size_t first, size_t last) {
+		for(size_t row = first; row < last; ++row) {
+		    if(row != pivotRow)
+			MatrixRowOps::rowEliminate(m, row, pivotRow, col);
+		}
+	    });
+	    pivotCols.push_back(col);
+	}
+	/* Dividing a pivot row by its pivot v / d leaves the numerators over the pivot's numerator */
+	for(size_t row = 0; row < pivotCols.size(); ++row) {
+	    BigInt pivot = m.numerators(row)[pivotCols[row]];
+	    if(pivot.isNegative()) {
+		pivot.negate();
+		for(BigInt& entry : m.numerators(row)) {
+		    entry.negate();
+		}
+	    }
+	    m.denominator(row) = std::move(pivot);
+	    m.normalize(row);
+	}
+	return pivotCols;
+    }
+
+} /* namespace MatrixReduce */
+
+#endif /* MATRIX_COMMON_DEN_H */
@@ -0,0 +1,153 @@
+/**
+ * @file MatrixCommonDenTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the common-denominator Rational Matrix
+*/
+
+#include "MatrixCommonDenTest.hh"
+
+#include <vector>
+#include <cstdint>
+
+namespace {
+
+/** Whether a row of the numerators and its denominator are the given integers */
+bool rowIs(const MatrixCommonDen& m, size_t row, std::vector<int64_t> numerators, int64_t denominator) {
+    if(m.denominator(row) != denominator)
+	return false;
+    for(size_t col = 0; col < numerators.size(); ++col) {
+	if(m.numerators(row)[col] != numerators[col])
+	    return false;
+    }
+    return true;
+}
+
+void lcmTest(void) {
+
+    /* Every row is brought to the lcm of its own denominators, a zero row keeps the denominator one */
+    Matrix<Rational> m1 {{"1/2", "-3/4", 0}, {5, "-7/9", "11/6"}, {0, 0, 0}};
+    MatrixCommonDen rows = MatrixCommonDen::from(m1);
+    assert(rows.getCols() == 3 && rows.getRows() == 3);
+    assert(rowIs(rows, 0, {2, -3, 0}, 4));
+    assert(rowIs(rows, 1, {90, -14, 33}, 18));
+    assert(rowIs(rows, 2, {0, 0, 0}, 1));
+    assert(rows.at(1, 1) == Rational("-7/9") && rows.at(2, 0) == 0);
+    Matrix<Rational> m2 {3, 3};
+    rows.copyTo(m2);
+    assert(m2 == m1);
+
+    bool caught = false;
+    try {
+	rows.at(3, 0);
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void normalizeTest(void) {
+
+    /* The numerators and the denominator are divided by their common gcd, whatever the signs of the numerators */
+    MatrixCommonDen rows {3, 3};
+    rows.numerators(0)[0] = 6;
+    rows.numerators(0)[1] = -9;
+    rows.denominator(0) = 12;
+    rows.normalize(0);
+    assert(rowIs(rows, 0, {2, -3, 0}, 4));
+
+    /* A row already in lowest terms is left as it is, even if some of its entries share a factor with the denominator */
+    rows.numerators(1)[0] = 4;
+    rows.numerators(1)[1] = 3;
+    rows.numerators(1)[2] = 8;
+    rows.denominator(1) = 6;
+    rows.normalize(1);
+    assert(rowIs(rows, 1, {4, 3, 8}, 6));
+
+    /* The zero row goes back to the denominator one */
+    rows.denominator(2) = 35;
+    rows.normalize(2);
+    assert(rowIs(rows, 2, {0, 0, 0}, 1));
+}
+
+void denominatorTest(void) {
+
+    /* Eliminating with a pivot row only scales the row's denominator by w / gcd(u, w), the pivot row's cancels out:
+       (1/2, 3/4) - 3/4 * (2/3, 1/6) = (0, 5/8) */
+    MatrixCommonDen rows = MatrixCommonDen::from(Matrix<Rational>{{"1/2", "3/4"}, {"2/3", "1/6"}});
+    assert(rowIs(rows, 0, {2, 3}, 4) && rowIs(rows, 1, {4, 1}, 6));
+    MatrixRowOps::rowEliminate(rows, 0, 1, 0);
+    assert(rowIs(rows, 0, {0, 5}, 8) && rowIs(rows, 1, {4, 1}, 6));
+
+    /* A negative pivot numerator keeps the denominator positive: (1/2, 3/4) + 3/4 * (-2/3, 1/6) = (0, 7/8) */
+    rows = MatrixCommonDen::from(Matrix<Rational>{{"1/2", "3/4"}, {"-2/3", "1/6"}});
+    MatrixRowOps::rowEliminate(rows, 0, 1, 0);
+    assert(rowIs(rows, 0, {0, 7}, 8));
+
+    /* Substituting a multiple brings the row to lcm(d1, q * d2): 1/2 - 1/3 * 1/5 = 13/30 */
+    rows = MatrixCommonDen::from(Matrix<Rational>{{"1/2", 1}, {"1/5", 0}});
+    MatrixRowOps::rowSub(rows, 0, Rational{"1/3"}, 1);
+    assert(rowIs(rows, 0, {13, 30}, 30));
+
+    /* Dividing scales the numerators by q and the denominator by |p|, then normalizes: (3/5, 6/5) / (-3/2) = (-2/5, -4/5) */
+    rows = MatrixCommonDen::from(Matrix<Rational>{{"3/5", "6/5"}});
+    MatrixRowOps::rowDiv(rows, 0, Rational{"-3/2"});
+    assert(rowIs(rows, 0, {-2, -4}, 5));
+
+    bool caught = false;
+    try {
+	MatrixCommonDen zero {2, 2};
+	MatrixRowOps::rowDiv(zero, 0, Rational{});
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+    caught = false;
+    try {
+	MatrixCommonDen pivot = MatrixCommonDen::from(Matrix<Rational>{{1, 2}, {0, 1}});
+	MatrixRowOps::rowEliminate(pivot, 0, 1, 0);
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void reduceCommonDenTest(void) {
+
+    /* Pivots are only normalized at the end, the pivot columns are returned and rank deficient rows end up zero */
+    MatrixCommonDen rows = MatrixCommonDen::from(Matrix<Rational>{{2, "1/2", "1/3", 4}, {4, 1, "2/3", 8}, {0, "1/5", 1, 0}});
+    std::vector<size_t> pivots = MatrixReduce::reduceCommonDen(rows, true);
+    assert(pivots == (std::vector<size_t>{0, 1}));
+    assert(rowIs(rows, 0, {12, 0, -13, 24}, 12));
+    assert(rowIs(rows, 1, {0, 1, 5, 0}, 1));
+    assert(rowIs(rows, 2, {0, 0, 0, 0}, 1));
+
+    /* Hilbert-like systems, whose row denominators grow far beyond 64 bits, give the same result as the Rational elimination */
+    for(size_t n = 2; n <= 10; n += 4) {
+	Matrix<Rational> h {n + 1, n};
+	for(size_t row = 0; row < n; ++row) {
+	    for(size_t col = 0; col <= n; ++col) {
+		h.at(col, row) = col == n ? Rational{row + 1} : Rational{1, (row + 1) * (col + 1) * 1000003 + row + col};
+	    }
+	}
+	Matrix<Rational> standard = h;
+	assert(MatrixReduce::toRREF(standard));
+	assert(MatrixReduce::toRREF(h, MatrixReduce::Mode::CommonDenominator));
+	assert(h == standard);
+    }
+}
+
+} /* anonymous */
+
+void matrixCommonDenTest(void) {
+
+    std::puts("--- Matrix Common Denominator TC Running ---");
+    lcmTest();
+    std::puts("-> Passed lcmTest()");
+    normalizeTest();
+    std::puts("-> Passed normalizeTest()");
+    denominatorTest();
+    std::puts("-> Passed denominatorTest()");
+    reduceCommonDenTest();
+    std::puts("-> Passed reduceCommonDenTest()");
+    std::puts("--- Matrix Common Denominator Tests Passed ---");
+}
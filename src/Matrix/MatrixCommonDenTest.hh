@@ -0,0 +1,21 @@
+/**
+ * @file MatrixCommonDenTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the common-denominator Rational Matrix
+*/
+#ifndef MATRIX_COMMON_DEN_TEST_H
+#define MATRIX_COMMON_DEN_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "Matrix.hh"
+#include "MatrixUtil.hh"
+#include "MatrixCommonDen.hh"
+#include "MatrixExact.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the common-denominator Rational Matrix and its integer row operations */
+void matrixCommonDenTest(void);
+
+#endif /* MATRIX_COMMON_DEN_TEST_H */
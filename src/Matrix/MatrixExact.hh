@@ -0,0 +1,558 @@
+/**
+ * @file MatrixExact.hh
+ * @author Martin
+ * @brief File containing the exact (integer based) reduction algorithms for Rational matrices
+*/
+#ifndef MATRIX_EXACT_H
+#define MATRIX_EXACT_H
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <cmath>
+
+#include "Matrix.hh"
+#include "MatrixUtil.hh"
+#include "MatrixSoA.hh"
+#include "MatrixCommonDen.hh"
+#include "SparseMatrix.hh"
+#include "../Rational/Rational.hh"
+#include "../BigInt/BigInt.hh"
+#include "../BigInt/ModArith.hh"
+#include "../Thread/ThreadPool.hh"
+
+/** Namespace containing Matrix Reduction functions */
+namespace MatrixReduce {
+
+    /** Elimination algorithm used to reduce a Rational Matrix */
+    enum class Mode {
+	/** Gaussian elimination with Rational row operations */
+	Standard,
+	/** Fraction-free (Bareiss) elimination over integers, converting to Rationals only at the end */
+	FractionFree,
+	/** Elimination modulo several word-sized primes in parallel, rebuilt by Chinese remaindering and rational reconstruction (RREF only) */
+	Modular,
+	/** Gaussian elimination on a structure-of-arrays copy with batched whole-row operations, finished with Rational row operations once a value outgrows 64 bits */
+	Batched,
+	/** Gaussian elimination on rows of integers over one shared denominator, with integer row operations and one gcd pass per row */
+	CommonDenominator,
+	/** Gauss-Jordan elimination on a compressed sparse row copy, touching only non-zeros and picking the pivot rows with the fewest */
+	Sparse
+    };
+
+    /** Fraction-free (Bareiss) elimination of an integer Matrix view, in place, returns the pivot column of each pivot row.
+      * Every entry of the result is a minor of the input, so all divisions are exact and the coefficients stay bounded.
+      * Without reduced only the entries below each pivot are eliminated (REF), with reduced the entries above as well (RREF),
+      * in which case all pivots end up equal. Pivots are not normalized to one.
+      */
+    template <typename T>
+    std::vector<size_t> fractionFree(MatrixView<T> m, bool reduced = false) {
+	std::vector<size_t> pivotCols;
+	/* The previous pivot, the exact divisor of the next elimination step */
+	T previous {1};
+	for(size_t col = 0; col < m.getCols() && pivotCols.size() < m.getRows(); ++col) {
+	    size_t pivotRow = pivotCols.size();
+	    /* Find a non-zero pivot, skip the column if there is none */
+	    size_t rowIdx = pivotRow;
+	    while(rowIdx < m.getRows() && m.atUnchecked(col, rowIdx) == 0) {
+		++rowIdx;
+	    }
+	    if(rowIdx == m.getRows())
+		continue;
+	    MatrixRowOps::rowSwap(m, rowIdx, pivotRow);
+	    const T pivot = m.atUnchecked(col, pivotRow);
+
+	    /* a[r][c] = (pivot * a[r][c] - a[r][col] * a[pivotRow][c]) / previous, for every row other than the pivot row */
+	    auto eliminate = [&](size_t first, size_t last) {
+		for(size_t row = first; row < last; ++row) {
+		    if(row == pivotRow)
+			continue;
+		    T factor = m.atUnchecked(col, row);
+		    /* Rows below the pivot are zero left of the column, rows above can have entries anywhere */
+		    for(size_t c = (row < pivotRow ? 0 : col + 1); c < m.getCols(); ++c) {
+			if(c == col)
+			    continue;
+			T& entry = m.atUnchecked(c, row);
+			const T& pivotEntry = m.atUnchecked(c, pivotRow);
+			bool subtract = factor != 0 && pivotEntry != 0;
+			if(entry == 0 && !subtract)
+			    continue;
+			T value = pivot * entry;
+			if(subtract)
+			    value -= factor * pivotEntry;
+			if(previous != 1)
+			    value /= previous;
+			entry = std::move(value);
+		    }
+		    m.atUnchecked(col, row) = T{0};
+		}
+	    };
+	    /* Rows are independent of each other, so they are updated in parallel */
+	    ThreadPool::global().parallelFor(reduced ? 0 : pivotRow + 1, m.getRows(), 4, eliminate);
+
+	    previous = pivot;
+	    pivotCols.push_back(col);
+	}
+	return pivotCols;
+    }
+
+    /** Converts a Rational Matrix into an integer Matrix with the same row space, scaling each row by the lcm of its denominators */
+    inline Matrix<BigInt> toIntegerRows(const Matrix<Rational>& m) {
+	Matrix<BigInt> result {m.getCols(), m.getRows()};
+	for(size_t row = 0; row < m.getRows(); ++row) {
+	    BigInt scale {1};
+	    for(size_t col = 0; col < m.getCols(); ++col) {
+		BigInt den = m.atUnchecked(col, row).getBigDenominator();
+		if(den != 1)
+		    scale = scale / gcd(scale, den) * den;
+	    }
+	    for(size_t col = 0; col < m.getCols(); ++col) {
+		const Rational& entry = m.atUnchecked(col, row);
+		BigInt value = entry.getBigNumerator() * (scale / entry.getBigDenominator());
+		result.atUnchecked(col, row) = entry.isNegative() ? value.negate() : value;
+	    }
+	}
+	return result;
+    }
+
+    /** Writes the integer rows back into a Rational Matrix, dividing each pivot row by its pivot so the pivots become one */
+    inline void fromIntegerRows(const Matrix<BigInt>& ints, const std::vector<size_t>& pivotCols, Matrix<Rational>& m) {
+	for(size_t row = 0; row < m.getRows(); ++row) {
+	    if(row >= pivotCols.size()) {
+		/* Rows past the last pivot are eliminated completely */
+		m.rowView(row).fill(Rational{});
+		continue;
+	    }
+	    const BigInt& pivot = ints.atUnchecked(pivotCols[row], row);
+	    for(size_t col = 0; col < m.getCols(); ++col) {
+		const BigInt& entry = ints.atUnchecked(col, row);
+		m.atUnchecked(col, row) = entry.isZero() ? Rational{} : Rational{entry, pivot};
+	    }
+	}
+    }
+
+    /** Reduces an integer Matrix to RREF modulo the prime p in place (entries already reduced mod p), returns the pivot columns */
+    inline std::vector<size_t> modularRREF(Matrix<uint64_t>& m, uint64_t p) {
+	std::vector<size_t> pivotCols;
+	for(size_t col = 0; col < m.getCols() && pivotCols.size() < m.getRows(); ++col) {
+	    size_t pivotRow = pivotCols.size();
+	    size_t rowIdx = pivotRow;
+	    while(rowIdx < m.getRows() && m.atUnchecked(col, rowIdx) == 0) {
+		++rowIdx;
+	    }
+	    if(rowIdx == m.getRows())
+		continue;
+	    MatrixRowOps::rowSwap(m, rowIdx, pivotRow);
+	    /* Normalize the pivot to one, the row is zero left of the column */
+	    std::span<uint64_t> pivot = m.rowSpan(pivotRow).subspan(col);
+	    uint64_t inverse = ModArith::invMod(pivot[0], p);
+	    for(uint64_t& entry : pivot) {
+		entry = ModArith::mulMod(entry, inverse, p);
+	    }
+	    /* Clear the column in every other row */
+	    for(size_t row = 0; row < m.getRows(); ++row) {
+		uint64_t factor = m.atUnchecked(col, row);
+		if(row == pivotRow || factor == 0)
+		    continue;
+		std::span<uint64_t> target = m.rowSpan(row).subspan(col);
+		for(size_t idx = 0; idx < target.size(); ++idx) {
+		    if(pivot[idx] != 0)
+			target[idx] = ModArith::subMod(target[idx], ModArith::mulMod(factor, pivot[idx], p), p);
+		}
+	    }
+	    pivotCols.push_back(col);
+	}
+	return pivotCols;
+    }
+
+    /** Rational reconstruction, finds num / den with |num| and den below 2^bound that is congruent to u modulo the modulus */
+    inline std::optional<std::pair<BigInt, BigInt>> reconstructRational(const BigInt& u, const BigInt& modulus, size_t bound) {
+	/* Half-extended Euclid on (modulus, u), stopping at the first remainder below the bound */
+	BigInt r0 = modulus, r1 = u;
+	BigInt s0 {0}, s1 {1};
+	BigInt quotient, remainder;
+	while(r1.bitLength() > bound) {
+	    BigInt::divMod(r0, r1, quotient, remainder);
+	    r0 = std::move(r1);
+	    r1 = std::move(remainder);
+	    BigInt next = s0 - quotient * s1;
+	    s0 = std::move(s1);
+	    s1 = std::move(next);
+	}
+	if(s1.isZero() || s1.bitLength() > bound || gcd(r1, s1) != 1)
+	    return std::nullopt;
+	if(s1.isNegative()) {
+	    r1.negate();
+	    s1.negate();
+	}
+	return std::make_pair(std::move(r1), std::move(s1));
+    }
+
+    /** Rebuilds every residue modulo the modulus as a fraction in lowest terms, returns false if any of them can't be rebuilt yet.
+      * The denominator found so far is tried first, as entries of the same result mostly share a denominator.
+      */
+    inline bool reconstructAll(const std::vector<BigInt>& residues, const BigInt& modulus, std::vector<std::pair<BigInt, BigInt>>& result) {
+	size_t bound = (modulus.bitLength() - 2) / 2;
+	result.assign(residues.size(), {});
+	BigInt denominator {1};
+	for(size_t entry = 0; entry < residues.size(); ++entry) {
+	    BigInt scaled = residues[entry] * denominator % modulus;
+	    if(scaled.bitLength() <= bound) {
+		result[entry] = {std::move(scaled), denominator};
+	    } else if(BigInt shifted = scaled - modulus; shifted.abs().bitLength() <= bound) {
+		result[entry] = {std::move(shifted), denominator};
+	    } else if(auto rebuilt = reconstructRational(scaled, modulus, bound)) {
+		denominator *= rebuilt->second;
+		result[entry] = {std::move(rebuilt->first), denominator};
+	    } else {
+		return false;
+	    }
+	    /* Bring the entry into lowest terms */
+	    BigInt divisor = gcd(result[entry].first, result[entry].second);
+	    if(divisor != 1) {
+		result[entry].first /= divisor;
+		result[entry].second /= divisor;
+	    }
+	}
+	return true;
+    }
+
+    /** Reduces a Rational Matrix to RREF with multi-modular elimination.
+      * The integerized Matrix is reduced modulo batches of 62-bit primes, one prime per thread. Primes whose pivot columns
+      * differ from the best seen so far are unlucky and dropped. The surviving images are combined by Chinese remaindering,
+      * and once every entry can be rebuilt by rational reconstruction, the result is accepted if it also matches the images
+      * of the next batch of primes.
+      */
+    inline bool toRREFModular(Matrix<Rational>& m) {
+	Matrix<BigInt> ints = toIntegerRows(m);
+	ThreadPool& pool = ThreadPool::global();
+	size_t batch = pool.getThreadCount();
+
+	/* Pivot columns of the images combined so far, and the positions of the entries that are neither zero nor a pivot */
+	std::vector<size_t> pivotCols;
+	std::vector<std::pair<size_t, size_t>> positions;
+	/* Combined residues of those entries, modulo the product of the primes used */
+	std::vector<BigInt> residues;
+	BigInt modulus {1};
+	/* Reconstructed entries awaiting confirmation by the next batch */
+	std::vector<std::pair<BigInt, BigInt>> candidate;
+	bool haveCandidate = false;
+	bool first = true;
+	uint64_t prime = MOD_ARITH_PRIME_LIMIT;
+
+	while(true) {
+	    /* Reduce the Matrix modulo a batch of new primes in parallel */
+	    std::vector<uint64_t> primes (batch);
+	    for(uint64_t& p : primes) {
+		prime = ModArith::prevPrime(prime);
+		p = prime;
+	    }
+	    std::vector<Matrix<uint64_t>> images (batch);
+	    std::vector<std::vector<size_t>> profiles (batch);
+	    pool.parallelFor(0, batch, 1, [&](size_t firstIdx, size_t lastIdx) {
+		for(size_t idx = firstIdx; idx < lastIdx; ++idx) {
+		    Matrix<uint64_t> image {ints.getCols(), ints.getRows()};
+		    for(size_t row = 0; row < ints.getRows(); ++row) {
+			for(size_t col = 0; col < ints.getCols(); ++col) {
+			    image.atUnchecked(col, row) = ints.atUnchecked(col, row).residue(primes[idx]);
+			}
+		    }
+		    profiles[idx] = modularRREF(image, primes[idx]);
+		    images[idx] = std::move(image);
+		}
+	    });
+
+	    bool confirmed = haveCandidate;
+	    for(size_t idx = 0; idx < batch; ++idx) {
+		/* The true pivot columns have the highest rank and come first, anything else comes from an unlucky prime */
+		const std::vector<size_t>& profile = profiles[idx];
+		bool better = first || profile.size() > pivotCols.size() || (profile.size() == pivotCols.size() && profile < pivotCols);
+		if(better) {
+		    first = false;
+		    pivotCols = profile;
+		    positions.clear();
+		    for(size_t row = 0; row < pivotCols.size(); ++row) {
+			size_t next = 0;
+			for(size_t col = pivotCols[row] + 1; col < ints.getCols(); ++col) {
+			    while(next < pivotCols.size() && pivotCols[next] < col) {
+				++next;
+			    }
+			    if(next == pivotCols.size() || pivotCols[next] != col)
+				positions.emplace_back(col, row);
+			}
+		    }
+		    residues.assign(positions.size(), BigInt{});
+		    modulus = 1;
+		    haveCandidate = confirmed = false;
+		} else if(profile != pivotCols) {
+		    continue;
+		}
+		const Matrix<uint64_t>& image = images[idx];
+		uint64_t p = primes[idx];
+		/* Check the candidate against this image before folding it in */
+		if(confirmed) {
+		    for(size_t entry = 0; entry < positions.size() && confirmed; ++entry) {
+			auto [col, row] = positions[entry];
+			uint64_t lhs = candidate[entry].first.residue(p);
+			uint64_t rhs = ModArith::mulMod(image.atUnchecked(col, row), candidate[entry].second.residue(p), p);
+			confirmed = lhs == rhs;
+		    }
+		}
+		/* Chinese remaindering, x' = x + M * ((a - x) * M^-1 mod p) */
+		uint64_t inverse = ModArith::invMod(modulus.residue(p), p);
+		for(size_t entry = 0; entry < positions.size(); ++entry) {
+		    auto [col, row] = positions[entry];
+		    uint64_t delta = ModArith::subMod(image.atUnchecked(col, row), residues[entry].residue(p), p);
+		    uint64_t t = ModArith::mulMod(delta, inverse, p);
+		    if(t != 0)
+			residues[entry] += modulus * BigInt{t};
+		}
+		modulus *= BigInt{p};
+	    }
+	    if(confirmed)
+		break;
+
+	    /* Try to rebuild every entry */
+	    haveCandidate = reconstructAll(residues, modulus, candidate);
+	}
+
+	/* Write the result, pivots are one and everything outside the recorded positions is zero */
+	for(size_t row = 0; row < m.getRows(); ++row) {
+	    m.rowView(row).fill(Rational{});
+	}
+	for(size_t row = 0; row < pivotCols.size(); ++row) {
+	    m.atUnchecked(pivotCols[row], row) = Rational{1};
+	}
+	for(size_t entry = 0; entry < positions.size(); ++entry) {
+	    auto [col, row] = positions[entry];
+	    if(!candidate[entry].first.isZero())
+		m.atUnchecked(col, row) = Rational{candidate[entry].first, candidate[entry].second};
+	}
+	return isRREF(m);
+    }
+
+    /** Reduces a Rational Matrix with the batched structure-of-arrays elimination, to REF or with reduced to RREF.
+      * Returns false if an element doesn't fit into 64 bits before or during the elimination, the Matrix is then left
+      * as far as the batched row operations got, which is still row equivalent to the input.
+      */
+    inline bool toEchelonBatched(Matrix<Rational>& m, bool reduced) {
+	std::optional<MatrixSoA> soa = MatrixSoA::from(m);
+	if(!soa)
+	    return false;
+	bool done = reduceBatched(*soa, reduced);
+	soa->copyTo(m);
+	return done;
+    }
+
+    /** Reduces a Rational Matrix with the common-denominator elimination, to REF or with reduced to RREF */
+    inline void toEchelonCommonDen(Matrix<Rational>& m, bool reduced) {
+	MatrixCommonDen rows = MatrixCommonDen::from(m);
+	reduceCommonDen(rows, reduced);
+	rows.copyTo(m);
+    }
+
+    /** Reduces a Rational Matrix to Row Echelon Form (REF) with the given elimination algorithm */
+    inline bool toREF(Matrix<Rational>& m, Mode mode) {
+	/* The RREF is also a REF, and unlike other echelon forms it is unique, so modular reduction produces it */
+	if(mode == Mode::Standard || isREF(m))
+	    return toREF(m);
+	if(mode == Mode::Modular)
+	    return toRREFModular(m);
+	if(mode == Mode::Batched)
+	    return toEchelonBatched(m, false) ? isREF(m) : toREF(m);
+	if(mode == Mode::CommonDenominator) {
+	    toEchelonCommonDen(m, false);
+	    return isREF(m);
+	}
+	if(mode == Mode::Sparse) {
+	    SparseMatrix<Rational> sparse {m};
+	    toREF(sparse);
+	    m = sparse.toDense();
+	    return isREF(m);
+	}
+	Matrix<BigInt> ints = toIntegerRows(m);
+	std::vector<size_t> pivotCols = fractionFree(ints.view());
+	fromIntegerRows(ints, pivotCols, m);
+	return isREF(m);
+    }
+
+    /** Reduces a Rational Matrix to Reduced Row Echelon Form (RREF) with the given elimination algorithm */
+    inline bool toRREF(Matrix<Rational>& m, Mode mode) {
+	if(mode == Mode::Standard || isRREF(m))
+	    return toRREF(m);
+	if(mode == Mode::Modular)
+	    return toRREFModular(m);
+	if(mode == Mode::Batched)
+	    return toEchelonBatched(m, true) ? isRREF(m) : toRREF(m);
+	if(mode == Mode::CommonDenominator) {
+	    toEchelonCommonDen(m, true);
+	    return isRREF(m);
+	}
+	if(mode == Mode::Sparse) {
+	    SparseMatrix<Rational> sparse {m};
+	    toRREF(sparse);
+	    m = sparse.toDense();
+	    return isRREF(m);
+	}
+	Matrix<BigInt> ints = toIntegerRows(m);
+	std::vector<size_t> pivotCols = fractionFree(ints.view(), true);
+	fromIntegerRows(ints, pivotCols, m);
+	return isRREF(m);
+    }
+
+    /** Solves A * X = B exactly for a square, non-singular Rational Matrix A by p-adic (Dixon) lifting, returns false if A is singular.
+      * A is inverted modulo a single word-sized prime p once. Each lifting step then finds the next p-adic digit of X as
+      * C * R mod p (C the inverse, R the residual), and updates the residual exactly as R = (R - A * digit) / p.
+      * The rational entries of X are rebuilt from the expansion once it is long enough for the Hadamard bound of the system,
+      * earlier attempts are accepted only if A * X = B holds exactly.
+      */
+    inline bool solve(const Matrix<Rational>& a, const Matrix<Rational>& b, Matrix<Rational>& x) {
+	if(a.getCols() != a.getRows())
+	    return false;
+	if(b.getRows() != a.getRows())
+	    throw std::runtime_error {"Matrix Error: Right-hand side has the wrong number of rows"};
+	size_t n = a.getRows();
+	size_t k = b.getCols();
+	/* Scaling each row of the system [A | B] to integers leaves the solution unchanged */
+	Matrix<Rational> system {n + k, n};
+	system.subView(0, 0, n, n).assign(a);
+	system.subView(n, 0, k, n).assign(b);
+	Matrix<BigInt> ints = toIntegerRows(system);
+	MatrixView<BigInt> aInt = ints.subView(0, 0, n, n);
+	MatrixView<BigInt> bInt = ints.subView(n, 0, k, n);
+
+	/* Find a prime that doesn't divide det(A), along with the inverse of A modulo it */
+	uint64_t p = MOD_ARITH_PRIME_LIMIT;
+	Matrix<uint64_t> inverse;
+	for(int attempt = 0; attempt < 3 && inverse.getRows() != n; ++attempt) {
+	    p = ModArith::prevPrime(p);
+	    Matrix<uint64_t> augmented {2 * n, n, 0};
+	    for(size_t row = 0; row < n; ++row) {
+		for(size_t col = 0; col < n; ++col) {
+		    augmented.atUnchecked(col, row) = aInt.atUnchecked(col, row).residue(p);
+		}
+		augmented.atUnchecked(n + row, row) = 1;
+	    }
+	    std::vector<size_t> pivotCols = modularRREF(augmented, p);
+	    if(pivotCols.size() == n && (n == 0 || pivotCols.back() == n - 1))
+		inverse = augmented.subView(n, 0, n, n);
+	}
+	if(inverse.getRows() != n) {
+	    /* A is singular modulo several large primes, so almost certainly singular, settle it exactly */
+	    if(!toRREF(system, Mode::FractionFree) || system.atUnchecked(n - 1, n - 1) != 1)
+		return false;
+	    x = system.subView(n, 0, k, n);
+	    return true;
+	}
+
+	/* Hadamard bound on the minors of [A | B], which bounds the numerators and denominators of X */
+	double hadamardBits = 0.0;
+	for(size_t row = 0; row < n; ++row) {
+	    size_t rowBits = 0;
+	    for(size_t col = 0; col < n + k; ++col) {
+		rowBits = std::max(rowBits, ints.atUnchecked(col, row).bitLength());
+	    }
+	    hadamardBits += static_cast<double>(rowBits) + 0.5 * std::log2(static_cast<double>(n));
+	}
+	size_t neededBits = 2 * (static_cast<size_t>(hadamardBits) + 2) + 2;
+
+	/* Checks A * X = B exactly, each column of X brought to a common denominator */
+	auto verify = [&](const std::vector<std::pair<BigInt, BigInt>>& candidate) {
+	    for(size_t col = 0; col < k; ++col) {
+		BigInt common {1};
+		for(size_t row = 0; row < n; ++row) {
+		    const BigInt& den = candidate[row * k + col].second;
+		    common = common / gcd(common, den) * den;
+		}
+		std::vector<BigInt> numerators (n);
+		for(size_t row = 0; row < n; ++row) {
+		    numerators[row] = candidate[row * k + col].first * (common / candidate[row * k + col].second);
+		}
+		for(size_t row = 0; row < n; ++row) {
+		    BigInt sum;
+		    for(size_t idx = 0; idx < n; ++idx) {
+			if(!numerators[idx].isZero())
+			    sum += aInt.atUnchecked(idx, row) * numerators[idx];
+		    }
+		    if(sum != bInt.atUnchecked(col, row) * common)
+			return false;
+		}
+	    }
+	    return true;
+	};
+
+	ThreadPool& pool = ThreadPool::global();
+	Matrix<BigInt> residual = bInt;
+	std::vector<BigInt> expansion (n * k);
+	std::vector<std::pair<BigInt, BigInt>> candidate;
+	BigInt power {1};
+	const BigInt prime {p};
+	size_t nextAttempt = 2;
+	for(size_t step = 1;; ++step) {
+	    /* Next p-adic digit of X, C * (R mod p) */
+	    Matrix<uint64_t> reduced {k, n};
+	    for(size_t row = 0; row < n; ++row) {
+		for(size_t col = 0; col < k; ++col) {
+		    reduced.atUnchecked(col, row) = residual.atUnchecked(col, row).residue(p);
+		}
+	    }
+	    Matrix<uint64_t> digit {k, n, 0};
+	    pool.parallelFor(0, n, 4, [&](size_t first, size_t last) {
+		for(size_t row = first; row < last; ++row) {
+		    for(size_t idx = 0; idx < n; ++idx) {
+			uint64_t c = inverse.atUnchecked(idx, row);
+			if(c == 0)
+			    continue;
+			for(size_t col = 0; col < k; ++col) {
+			    digit.atUnchecked(col, row) = ModArith::addMod(digit.atUnchecked(col, row), ModArith::mulMod(c, reduced.atUnchecked(col, idx), p), p);
+			}
+		    }
+		}
+	    });
+	    /* R = (R - A * digit) / p, the division is exact as A * digit = R mod p */
+	    pool.parallelFor(0, n, 4, [&](size_t first, size_t last) {
+		for(size_t row = first; row < last; ++row) {
+		    for(size_t col = 0; col < k; ++col) {
+			BigInt& entry = residual.atUnchecked(col, row);
+			for(size_t idx = 0; idx < n; ++idx) {
+			    uint64_t d = digit.atUnchecked(col, idx);
+			    if(d != 0 && !aInt.atUnchecked(idx, row).isZero())
+				entry -= aInt.atUnchecked(idx, row) * BigInt{d};
+			}
+			entry /= prime;
+			BigInt& term = expansion[row * k + col];
+			if(digit.atUnchecked(col, row) != 0)
+			    term += power * BigInt{digit.atUnchecked(col, row)};
+		    }
+		}
+	    });
+	    power *= prime;
+
+	    /* Try to rebuild X at doubling intervals, and always once the expansion covers the Hadamard bound */
+	    bool complete = power.bitLength() >= neededBits;
+	    if(complete || step == nextAttempt) {
+		nextAttempt *= 2;
+		if(reconstructAll(expansion, power, candidate) && (complete || verify(candidate)))
+		    break;
+		if(complete)
+		    throw std::runtime_error {"Matrix Error: Exact solution could not be reconstructed"};
+	    }
+	}
+
+	x = Matrix<Rational> {k, n};
+	for(size_t row = 0; row < n; ++row) {
+	    for(size_t col = 0; col < k; ++col) {
+		const std::pair<BigInt, BigInt>& entry = candidate[row * k + col];
+		if(!entry.first.isZero())
+		    x.atUnchecked(col, row) = Rational{entry.first, entry.second};
+	    }
+	}
+	return true;
+    }
+
+} /* namespace MatrixReduce */
+
+#endif /* MATRIX_EXACT_H */
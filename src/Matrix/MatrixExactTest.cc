@@ -0,0 +1,183 @@
+/**
+ * @file MatrixExactTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the exact reduction algorithms
+*/
+
+#include "MatrixExactTest.hh"
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include "MatrixTestUtil.hh"
+
+namespace {
+
+/** Returns a Matrix of small pseudo-random Rationals, copying some rows to make it rank deficient */
+Matrix<Rational> randomMatrix(size_t cols, size_t rows, uint32_t& state) {
+    Matrix<Rational> m = MatrixTestUtil::randomMatrix(cols, rows, state, 6, 3);
+    for(size_t row = 1; row < rows; ++row) {
+	if((MatrixTestUtil::nextRandom(state) >> 20) % 4 == 0)
+	    m.rowView(row).assign(m.rowView(row - 1));
+    }
+    return m;
+}
+
+void fractionFreeTest(void) {
+
+    /* The last pivot of a square fraction-free elimination is the determinant */
+    Matrix<int64_t> m1 {{2, 1, 1}, {4, -6, 0}, {-2, 7, 2}};
+    std::vector<size_t> pivots1 = MatrixReduce::fractionFree(m1.view());
+    assert(pivots1.size() == 3);
+    assert(m1.at(2, 2) == -16);
+    Matrix<int64_t> r1 {{2, 1, 1}, {0, -16, -4}, {0, 0, -16}};
+    assert(m1 == r1);
+
+    /* Gauss-Jordan variant, all pivots equal the determinant */
+    Matrix<BigInt> m2 {{2, 1, 1}, {4, -6, 0}, {-2, 7, 2}};
+    MatrixReduce::fractionFree(m2.view(), true);
+    for(size_t row = 0; row < 3; ++row) {
+	for(size_t col = 0; col < 3; ++col) {
+	    assert(m2.at(col, row) == (row == col ? BigInt{-16} : BigInt{0}));
+	}
+    }
+
+    /* Skipped columns and dependent rows */
+    Matrix<int64_t> m3 {{0, 2, 4, 1}, {0, 1, 2, 3}, {0, 3, 6, 4}};
+    std::vector<size_t> pivots3 = MatrixReduce::fractionFree(m3.view());
+    assert(pivots3.size() == 2 && pivots3[0] == 1 && pivots3[1] == 3);
+    assert(m3.at(3, 2) == 0 && m3.at(1, 2) == 0);
+}
+
+void exactReduceTest(void) {
+
+    /* Rational input, both forms */
+    Matrix<Rational> m1 {{"1/2", "1/3", 1}, {"1/4", 2, "-2/3"}, {1, 0, 5}};
+    Matrix<Rational> m2 = m1;
+    assert(MatrixReduce::toREF(m1, MatrixReduce::Mode::FractionFree));
+    assert(MatrixReduce::isREF(m1));
+    assert(MatrixReduce::toRREF(m2, MatrixReduce::Mode::FractionFree));
+    assert(m2 == Matrix<Rational>::identity(3));
+
+    Matrix<Rational> m3 {{1, 2, 3, 4}, {2, 4, 6, 8}, {1, 0, 1, 0}};
+    assert(MatrixReduce::toRREF(m3, MatrixReduce::Mode::FractionFree));
+    Matrix<Rational> r3 {{1, 0, 1, 0}, {0, 1, 1, 2}, {0, 0, 0, 0}};
+    assert(m3 == r3);
+
+    /* The fraction-free forms agree with the Rational elimination */
+    uint32_t state = 2024;
+    for(int round = 0; round < 40; ++round) {
+	Matrix<Rational> m = randomMatrix(2 + round % 4, 2 + (round / 4) % 4, state);
+	Matrix<Rational> standard = m;
+	Matrix<Rational> exact = m;
+	assert(MatrixReduce::toRREF(standard));
+	assert(MatrixReduce::toRREF(exact, MatrixReduce::Mode::FractionFree));
+	assert(standard == exact);
+	Matrix<Rational> echelon = m;
+	assert(MatrixReduce::toREF(echelon, MatrixReduce::Mode::FractionFree));
+	assert(MatrixReduce::REFtoRREF(echelon));
+	assert(echelon == standard);
+	Matrix<Rational> modular = m;
+	assert(MatrixReduce::toRREF(modular, MatrixReduce::Mode::Modular));
+	assert(modular == standard);
+    }
+}
+
+void modularTest(void) {
+
+    /* Entries with large numerators and denominators need several primes before the reconstruction is stable */
+    Matrix<Rational> m1 {{"1/2", "1/3", "1/4", 1}, {"1/3", "1/4", "1/5", 2}, {"1/4", "1/5", "1/6", 3}};
+    Matrix<Rational> r1 = m1;
+    assert(MatrixReduce::toRREF(r1));
+    for(size_t threads : {1, 3}) {
+	ThreadPool::setGlobalThreadCount(threads);
+	Matrix<Rational> m = m1;
+	assert(MatrixReduce::toRREF(m, MatrixReduce::Mode::Modular));
+	assert(m == r1);
+    }
+    ThreadPool::setGlobalThreadCount(ThreadPool::defaultThreadCount());
+
+    /* Rank deficient with a zero column, and the zero Matrix */
+    Matrix<Rational> m2 {{0, 1, 2, 3}, {0, 2, 4, 6}, {0, 1, 1, 1}};
+    assert(MatrixReduce::toRREF(m2, MatrixReduce::Mode::Modular));
+    Matrix<Rational> r2 {{0, 1, 0, -1}, {0, 0, 1, 2}, {0, 0, 0, 0}};
+    assert(m2 == r2);
+    Matrix<Rational> m3 {3, 2, 0};
+    assert(MatrixReduce::toRREF(m3, MatrixReduce::Mode::Modular));
+    assert(m3 == (Matrix<Rational>{3, 2, 0}));
+
+    /* REF requests get the RREF, which is a valid REF */
+    Matrix<Rational> m4 {{2, 4}, {1, 3}};
+    assert(MatrixReduce::toREF(m4, MatrixReduce::Mode::Modular));
+    assert(m4 == Matrix<Rational>::identity(2));
+}
+
+void dixonTest(void) {
+
+    /* Integer system with an integer solution */
+    Matrix<Rational> a1 {{2, 1, 1}, {4, -6, 0}, {-2, 7, 2}};
+    Matrix<Rational> b1 {{5}, {-2}, {9}};
+    Matrix<Rational> x1;
+    assert(MatrixReduce::solve(a1, b1, x1));
+    Matrix<Rational> r1 {{1}, {1}, {2}};
+    assert(x1 == r1);
+
+    /* Rational entries and several right-hand sides, compared against the inverse */
+    Matrix<Rational> a2 {{"1/2", "1/3", "1/4"}, {"1/3", "1/4", "1/5"}, {"1/4", "1/5", "1/6"}};
+    Matrix<Rational> b2 {{1, 0, "2/3"}, {0, 1, -1}, {0, 0, 5}};
+    Matrix<Rational> x2;
+    assert(MatrixReduce::solve(a2, b2, x2));
+    Matrix<Rational> inverse = a2;
+    assert(MatrixReduce::invert(inverse));
+    assert(x2 == inverse * b2);
+
+    /* Pseudo-random systems agree with the fraction-free reduction of the augmented Matrix */
+    uint32_t state = 99;
+    for(int round = 0; round < 10; ++round) {
+	size_t n = 2 + round % 5;
+	Matrix<Rational> a = randomMatrix(n, n, state);
+	Matrix<Rational> b = randomMatrix(2, n, state);
+	Matrix<Rational> augmented {n + 2, n};
+	augmented.subView(0, 0, n, n).assign(a);
+	augmented.subView(n, 0, 2, n).assign(b);
+	assert(MatrixReduce::toRREF(augmented, MatrixReduce::Mode::FractionFree));
+	Matrix<Rational> x;
+	bool solved = MatrixReduce::solve(a, b, x);
+	assert(solved == (augmented.at(n - 1, n - 1) == 1));
+	if(solved)
+	    assert(x == Matrix<Rational>{augmented.subView(n, 0, 2, n)});
+    }
+
+    /* Singular and non-square systems have no unique solution */
+    Matrix<Rational> a3 {{1, 2}, {2, 4}};
+    Matrix<Rational> b3 {{1}, {2}};
+    Matrix<Rational> x3;
+    assert(!MatrixReduce::solve(a3, b3, x3));
+    assert(!MatrixReduce::solve(Matrix<Rational>{3, 2, 1}, b3, x3));
+
+    bool caught = false;
+    try {
+	MatrixReduce::solve(a1, b3, x3);
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+} /* anonymous */
+
+/** Function containing test cases for the exact reduction algorithms */
+void matrixExactTest(void) {
+
+    std::puts("--- MatrixExact TC Running ---");
+    fractionFreeTest();
+    std::puts("-> Passed fractionFreeTest()");
+    exactReduceTest();
+    std::puts("-> Passed exactReduceTest()");
+    modularTest();
+    std::puts("-> Passed modularTest()");
+    dixonTest();
+    std::puts("-> Passed dixonTest()");
+    std::puts("--- MatrixExact Tests Passed ---");
+}
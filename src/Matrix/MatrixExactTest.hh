@@ -0,0 +1,20 @@
+/**
+ * @file MatrixExactTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the exact reduction algorithms
+*/
+#ifndef MATRIX_EXACT_TEST_H
+#define MATRIX_EXACT_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+#include "../BigInt/BigInt.hh"
+#include "MatrixExact.hh"
+
+/** Function containing test cases for the exact reduction algorithms */
+void matrixExactTest(void);
+
+#endif /* MATRIX_EXACT_TEST_H */
@@ -0,0 +1,221 @@
+/**
+ * @file MatrixExpr.hh
+ * @author Martin
+ * @brief File containing the lazy expression templates for element-wise Matrix arithmetic
+*/
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Matrix.hh"
+#include "MatrixView.hh"
+
+/** Namespace containing the lazy element-wise expression nodes.
+  * Sums, differences, negations and scalar multiples of matrices build a tree of these nodes instead of temporaries,
+  * and the whole tree is evaluated element by element in a single pass once assigned to a Matrix.
+  */
+namespace MatrixExpr {
+
+    /** Whether the given type is a Matrix */
+    template <typename E>
+    inline constexpr bool isMatrix = false;
+    template <typename T>
+    inline constexpr bool isMatrix<Matrix<T>> = true;
+
+    /** Whether the given type can be used as an operand of element-wise expressions (a Matrix or an expression node) */
+    template <typename E>
+    inline constexpr bool isOperand = isMatrix<std::remove_cvref_t<E>> || std::is_base_of_v<MatrixExprTag, std::remove_cvref_t<E>>;
+
+    /** Leaf node referring to a Matrix that outlives the expression */
+    template <typename T>
+    class Ref : public MatrixExprTag {
+	private:
+	    const T* m_data;
+	    size_t m_cols;
+	    size_t m_rows;
+	public:
+	    using value_type = T;
+	    explicit Ref(const Matrix<T>& m) : m_data{m.data()}, m_cols{m.getCols()}, m_rows{m.getRows()} {}
+	    size_t getCols(void) const { return m_cols; }
+	    size_t getRows(void) const { return m_rows; }
+	    const T& operator[](size_t idx) const { return m_data[idx]; }
+	    bool conflicts(const MatrixLayout& target) const { return target.conflicts(MatrixLayout::of(m_data, m_cols, m_rows, m_cols, 1)); }
+    };
+
+    /** Leaf node owning a temporary Matrix (such as a product), so the expression stays valid after the full-expression */
+    template <typename T>
+    class Owned : public MatrixExprTag {
+	private:
+	    Matrix<T> m_matrix;
+	public:
+	    using value_type = T;
+	    explicit Owned(Matrix<T>&& m) : m_matrix{std::move(m)} {}
+	    size_t getCols(void) const { return m_matrix.getCols(); }
+	    size_t getRows(void) const { return m_matrix.getRows(); }
+	    const T& operator[](size_t idx) const { return m_matrix.data()[idx]; }
+	    bool conflicts(const MatrixLayout&) const { return false; }
+    };
+
+    /** Node combining two operands of equal shape element by element */
+    template <typename L, typename R, typename Op>
+    class Binary : public MatrixExprTag {
+	private:
+	    L m_lhs;
+	    R m_rhs;
+	public:
+	    using value_type = typename L::value_type;
+	    static_assert(std::is_same_v<value_type, typename R::value_type>, "Matrix Error: Element types of expression operands differ");
+	    Binary(L lhs, R rhs) : m_lhs{std::move(lhs)}, m_rhs{std::move(rhs)} {
+		/* Shapes are checked when the expression is built, not when it is evaluated */
+		if(m_lhs.getRows() != m_rhs.getRows() || m_lhs.getCols() != m_rhs.getCols())
+		    throw std::runtime_error {Op::shapeError};
+	    }
+	    size_t getCols(void) const { return m_lhs.getCols(); }
+	    size_t getRows(void) const { return m_lhs.getRows(); }
+	    value_type operator[](size_t idx) const { return Op::apply(m_lhs[idx], m_rhs[idx]); }
+	    bool conflicts(const MatrixLayout& target) const { return m_lhs.conflicts(target) || m_rhs.conflicts(target); }
+    };
+
+    /** Node multiplying every element of an operand by a scalar, from the left or from the right */
+    template <typename E, bool ScalarLeft>
+    class Scale : public MatrixExprTag {
+	private:
+	    E m_expr;
+	    typename E::value_type m_scalar;
+	public:
+	    using value_type = typename E::value_type;
+	    Scale(E expr, value_type scalar) : m_expr{std::move(expr)}, m_scalar{std::move(scalar)} {}
+	    size_t getCols(void) const { return m_expr.getCols(); }
+	    size_t getRows(void) const { return m_expr.getRows(); }
+	    value_type operator[](size_t idx) const {
+		if constexpr (ScalarLeft)
+		    return m_scalar * m_expr[idx];
+		else
+		    return m_expr[idx] * m_scalar;
+	    }
+	    bool conflicts(const MatrixLayout& target) const { return m_expr.conflicts(target); }
+    };
+
+    /** Node negating every element of an operand */
+    template <typename E>
+    class Negate : public MatrixExprTag {
+	private:
+	    E m_expr;
+	public:
+	    using value_type = typename E::value_type;
+	    explicit Negate(E expr) : m_expr{std::move(expr)} {}
+	    size_t getCols(void) const { return m_expr.getCols(); }
+	    size_t getRows(void) const { return m_expr.getRows(); }
+	    value_type operator[](size_t idx) const { return value_type{} - m_expr[idx]; }
+	    bool conflicts(const MatrixLayout& target) const { return m_expr.conflicts(target); }
+    };
+
+    /** Element-wise addition */
+    struct Add {
+	static constexpr const char* shapeError = "Matrix Error: Can't add Matrices of different dimensions";
+	template <typename T>
+	static T apply(const T& lhs, const T& rhs) { return lhs + rhs; }
+    };
+
+    /** Element-wise subtraction */
+    struct Sub {
+	static constexpr const char* shapeError = "Matrix Error: Can't subtract Matrices of different dimensions";
+	template <typename T>
+	static T apply(const T& lhs, const T& rhs) { return lhs - rhs; }
+    };
+
+    /** Wraps an operand into an expression node: Matrix lvalues are referenced, Matrix temporaries are taken over, nodes are copied */
+    template <typename E>
+    auto wrap(E&& operand) {
+	using D = std::remove_cvref_t<E>;
+	if constexpr (isMatrix<D>) {
+	    if constexpr (std::is_lvalue_reference_v<E>)
+		return Ref<typename D::value_type> {operand};
+	    else
+		return Owned<typename D::value_type> {std::move(operand)};
+	} else {
+	    return D {std::forward<E>(operand)};
+	}
+    }
+
+    /** Type of the node an operand is wrapped into */
+    template <typename E>
+    using Wrapped = decltype(wrap(std::declval<E>()));
+
+    /** Whether the given type is a view */
+    template <typename E>
+    inline constexpr bool isView = false;
+    template <typename T>
+    inline constexpr bool isView<MatrixView<T>> = true;
+
+    /** Evaluates an operand into something with a view, operands that already are a Matrix or a view are passed through */
+    template <typename E>
+    decltype(auto) evaluate(const E& operand) {
+	if constexpr (isMatrix<E> || isView<E>)
+	    return operand;
+	else
+	    return Matrix<typename E::value_type> {operand};
+    }
+
+    /** Returns a read-only view of an evaluated operand */
+    template <typename T>
+    MatrixView<const T> constView(const Matrix<T>& m) {
+	return m.view();
+    }
+    template <typename T>
+    MatrixView<const std::remove_const_t<T>> constView(const MatrixView<T>& v) {
+	return v;
+    }
+
+} /* namespace MatrixExpr */
+
+
+/* --- Expression Operators --- */
+
+template <typename L, typename R> requires (MatrixExpr::isOperand<L> && MatrixExpr::isOperand<R>)
+auto operator+(L&& lhs, R&& rhs) {
+    return MatrixExpr::Binary<MatrixExpr::Wrapped<L>, MatrixExpr::Wrapped<R>, MatrixExpr::Add> {
+	MatrixExpr::wrap(std::forward<L>(lhs)), MatrixExpr::wrap(std::forward<R>(rhs))};
+}
+
+template <typename L, typename R> requires (MatrixExpr::isOperand<L> && MatrixExpr::isOperand<R>)
+auto operator-(L&& lhs, R&& rhs) {
+    return MatrixExpr::Binary<MatrixExpr::Wrapped<L>, MatrixExpr::Wrapped<R>, MatrixExpr::Sub> {
+	MatrixExpr::wrap(std::forward<L>(lhs)), MatrixExpr::wrap(std::forward<R>(rhs))};
+}
+
+template <typename E> requires MatrixExpr::isOperand<E>
+auto operator-(E&& expr) {
+    return MatrixExpr::Negate<MatrixExpr::Wrapped<E>> {MatrixExpr::wrap(std::forward<E>(expr))};
+}
+
+template <typename S, typename E> requires (!MatrixExpr::isOperand<S> && MatrixExpr::isOperand<E> &&
+					    std::is_convertible_v<const S&, typename std::remove_cvref_t<E>::value_type>)
+auto operator*(const S& scalar, E&& expr) {
+    using T = typename std::remove_cvref_t<E>::value_type;
+    return MatrixExpr::Scale<MatrixExpr::Wrapped<E>, true> {MatrixExpr::wrap(std::forward<E>(expr)), T(scalar)};
+}
+
+template <typename E, typename S> requires (MatrixExpr::isOperand<E> && !MatrixExpr::isOperand<S> &&
+					    std::is_convertible_v<const S&, typename std::remove_cvref_t<E>::value_type>)
+auto operator*(E&& expr, const S& scalar) {
+    using T = typename std::remove_cvref_t<E>::value_type;
+    return MatrixExpr::Scale<MatrixExpr::Wrapped<E>, false> {MatrixExpr::wrap(std::forward<E>(expr)), T(scalar)};
+}
+
+/** Matrix product involving at least one view or lazy expression.
+  * Views are multiplied through their strides without copying, other expression operands are evaluated first.
+  */
+template <typename L, typename R> requires (MatrixExpr::isOperand<L> && MatrixExpr::isOperand<R> &&
+					    !(MatrixExpr::isMatrix<L> && MatrixExpr::isMatrix<R>))
+auto operator*(const L& lhs, const R& rhs) {
+    using T = typename L::value_type;
+    decltype(auto) lhsEvaluated = MatrixExpr::evaluate(lhs);
+    decltype(auto) rhsEvaluated = MatrixExpr::evaluate(rhs);
+    return Matrix<T>::multiply(MatrixExpr::constView(lhsEvaluated), MatrixExpr::constView(rhsEvaluated));
+}
+
+#endif /* MATRIX_EXPR_H */
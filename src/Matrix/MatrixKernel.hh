@@ -0,0 +1,178 @@
+/**
+ * @file MatrixKernel.hh
+ * @author Martin
+ * @brief File containing the packed, cache-blocked matrix multiplication kernel used for arithmetic element types
+*/
+#ifndef MATRIX_KERNEL_H
+#define MATRIX_KERNEL_H
+
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "../Thread/ThreadPool.hh"
+
+/** Minimum number of multiply-adds (m * n * k) before a product is split across the global thread pool */
+#define MATRIX_GEMM_PARALLEL_THRESHOLD (1 << 18)
+
+/** Namespace containing the low-level matrix multiplication kernel, working on raw strided buffers */
+namespace MatrixKernel {
+
+    /** Whether the packed kernel can be used for the given element type (plain arithmetic types, excluding bool) */
+    template <typename T>
+    inline constexpr bool isKernelType = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+    /** Blocking parameters of the kernel for a given element type */
+    template <typename T>
+    struct Blocking {
+	/** Rows of the register tile (micro-kernel height) */
+	static constexpr size_t MR = 4;
+	/** Columns of the register tile (micro-kernel width), one cache line of elements */
+	static constexpr size_t NR = std::min<size_t>(64 / sizeof(T), 16);
+	/** Depth of a packed panel, sized so that an MR x KC sliver of A and a KC x NR sliver of B stay in L1 */
+	static constexpr size_t KC = 256;
+	/** Rows of a packed block of A, sized for L2 */
+	static constexpr size_t MC = 128;
+	/** Columns of a packed block of B, sized for L3 */
+	static constexpr size_t NC = 2048;
+    };
+
+    /** Packs an (mc x kc) block of A into consecutive MR-row slivers, each stored column by column, zero-padding the last sliver */
+    template <typename T>
+    void packA(size_t mc, size_t kc, const T* a, size_t rsA, size_t csA, T* packed) {
+	constexpr size_t MR = Blocking<T>::MR;
+	for(size_t i0 = 0; i0 < mc; i0 += MR) {
+	    size_t mr = std::min(MR, mc - i0);
+	    for(size_t p = 0; p < kc; ++p) {
+		for(size_t i = 0; i < mr; ++i) {
+		    packed[i] = a[(i0 + i) * rsA + p * csA];
+		}
+		for(size_t i = mr; i < MR; ++i) {
+		    packed[i] = T{};
+		}
+		packed += MR;
+	    }
+	}
+    }
+
+    /** Packs a (kc x nc) block of B into consecutive NR-column slivers, each stored row by row, zero-padding the last sliver */
+    template <typename T>
+    void packB(size_t kc, size_t nc, const T* b, size_t rsB, size_t csB, T* packed) {
+	constexpr size_t NR = Blocking<T>::NR;
+	for(size_t j0 = 0; j0 < nc; j0 += NR) {
+	    size_t nr = std::min(NR, nc - j0);
+	    for(size_t p = 0; p < kc; ++p) {
+		for(size_t j = 0; j < nr; ++j) {
+		    packed[j] = b[p * rsB + (j0 + j) * csB];
+		}
+		for(size_t j = nr; j < NR; ++j) {
+		    packed[j] = T{};
+		}
+		packed += NR;
+	    }
+	}
+    }
+
+    /** Register-tiled micro-kernel, accumulates an MR x NR tile of packed A * packed B and adds alpha times the valid (mr x nr) part to C */
+    template <typename T>
+    void microKernel(size_t kc, const T* a, const T* b, T* c, size_t rsC, size_t csC, size_t mr, size_t nr, T alpha) {
+	constexpr size_t MR = Blocking<T>::MR;
+	constexpr size_t NR = Blocking<T>::NR;
+	/* The accumulator tile is small and fixed-size, so it lives in registers and the inner loops vectorize over NR */
+	T acc[MR][NR] = {};
+	for(size_t p = 0; p < kc; ++p) {
+	    for(size_t i = 0; i < MR; ++i) {
+		T aip = a[i];
+		for(size_t j = 0; j < NR; ++j) {
+		    acc[i][j] += aip * b[j];
+		}
+	    }
+	    a += MR;
+	    b += NR;
+	}
+	/* Write back only the part of the tile that lies inside C */
+	for(size_t i = 0; i < mr; ++i) {
+	    for(size_t j = 0; j < nr; ++j) {
+		c[i * rsC + j * csC] += alpha * acc[i][j];
+	    }
+	}
+    }
+
+    /** Computes C += alpha * A * B for an (m x k) matrix A, a (k x n) matrix B and an (m x n) matrix C, each given by a pointer and its row/column strides */
+    template <typename T>
+    void gemm(size_t m, size_t n, size_t k,
+	      const T* a, size_t rsA, size_t csA,
+	      const T* b, size_t rsB, size_t csB,
+	      T* c, size_t rsC, size_t csC, T alpha = T{1}) {
+	using B = Blocking<T>;
+	if(m == 0 || n == 0 || k == 0)
+	    return;
+	/* Packing buffers, sized for one block of A and one block of B (rounded up to whole slivers) */
+	size_t mcMax = std::min(B::MC, m);
+	size_t ncMax = std::min(B::NC, n);
+	size_t kcMax = std::min(B::KC, k);
+	std::unique_ptr<T[]> packedA = std::make_unique_for_overwrite<T[]>(((mcMax + B::MR - 1) / B::MR) * B::MR * kcMax);
+	std::unique_ptr<T[]> packedB = std::make_unique_for_overwrite<T[]>(((ncMax + B::NR - 1) / B::NR) * B::NR * kcMax);
+
+	/* Loop over column blocks of B and C */
+	for(size_t jc = 0; jc < n; jc += B::NC) {
+	    size_t nc = std::min(B::NC, n - jc);
+	    /* Loop over the shared dimension, packing a (kc x nc) block of B once per block */
+	    for(size_t pc = 0; pc < k; pc += B::KC) {
+		size_t kc = std::min(B::KC, k - pc);
+		packB(kc, nc, b + pc * rsB + jc * csB, rsB, csB, packedB.get());
+		/* Loop over row blocks of A and C, packing an (mc x kc) block of A */
+		for(size_t ic = 0; ic < m; ic += B::MC) {
+		    size_t mc = std::min(B::MC, m - ic);
+		    packA(mc, kc, a + ic * rsA + pc * csA, rsA, csA, packedA.get());
+		    /* Sweep the register tile over the block of C */
+		    for(size_t jr = 0; jr < nc; jr += B::NR) {
+			size_t nr = std::min(B::NR, nc - jr);
+			for(size_t ir = 0; ir < mc; ir += B::MR) {
+			    size_t mr = std::min(B::MR, mc - ir);
+			    microKernel(kc, packedA.get() + ir * kc, packedB.get() + jr * kc,
+					c + (ic + ir) * rsC + (jc + jr) * csC, rsC, csC, mr, nr, alpha);
+			}
+		    }
+		}
+	    }
+	}
+    }
+
+    /** Computes C += alpha * A * B like gemm, partitioning C across the global thread pool along its larger dimension.
+      * Each worker packs its own blocks, so the partitions are fully independent.
+      */
+    template <typename T>
+    void parallelGemm(size_t m, size_t n, size_t k,
+		      const T* a, size_t rsA, size_t csA,
+		      const T* b, size_t rsB, size_t csB,
+		      T* c, size_t rsC, size_t csC, T alpha = T{1}) {
+	using B = Blocking<T>;
+	ThreadPool& pool = ThreadPool::global();
+	if(pool.getThreadCount() == 1 || m * n * k < MATRIX_GEMM_PARALLEL_THRESHOLD) {
+	    gemm(m, n, k, a, rsA, csA, b, rsB, csB, c, rsC, csC, alpha);
+	    return;
+	}
+	if(m >= n) {
+	    /* Split the rows of A and C, in whole register tiles */
+	    size_t tiles = (m + B::MR - 1) / B::MR;
+	    pool.parallelFor(0, tiles, 4, [&](size_t first, size_t last) {
+		size_t rowBegin = first * B::MR;
+		size_t rowEnd = std::min(last * B::MR, m);
+		gemm(rowEnd - rowBegin, n, k, a + rowBegin * rsA, rsA, csA, b, rsB, csB, c + rowBegin * rsC, rsC, csC, alpha);
+	    });
+	} else {
+	    /* Split the columns of B and C, in whole register tiles */
+	    size_t tiles = (n + B::NR - 1) / B::NR;
+	    pool.parallelFor(0, tiles, 2, [&](size_t first, size_t last) {
+		size_t colBegin = first * B::NR;
+		size_t colEnd = std::min(last * B::NR, n);
+		gemm(m, colEnd - colBegin, k, a, rsA, csA, b + colBegin * csB, rsB, csB, c + colBegin * csC, rsC, csC, alpha);
+	    });
+	}
+    }
+
+} /* namespace MatrixKernel */
+
+#endif /* MATRIX_KERNEL_H */
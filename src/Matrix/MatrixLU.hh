@@ -0,0 +1,233 @@
+/**
+ * @file MatrixLU.hh
+ * @author Martin
+ * @brief File containing the LU factorization of a square Matrix, reusable for solving against many right-hand sides
+*/
+#ifndef MATRIX_LU_H
+#define MATRIX_LU_H
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+#include "Matrix.hh"
+#include "MatrixUtil.hh"
+#include "MatrixKernel.hh"
+
+/** Width of the column panels of the blocked factorization, larger floating point matrices are factorized in blocks */
+#define MATRIX_LU_BLOCK_SIZE 64
+
+/** LU factorization with row pivoting (P * A = L * U) of a square Matrix.
+  * The elimination is done once when the factorization is built, every solve afterwards only substitutes forward and back.
+  * Floating point types use partial pivoting (the largest entry of the column), exact types the first non-zero entry.
+  */
+template <typename T>
+class LU {
+
+    private:
+	/** L below the diagonal (with an implicit unit diagonal) and U on and above it, packed into a single Matrix */
+	Matrix<T> m_lu;
+	/** The row of the original Matrix in each row of the factorization */
+	std::vector<size_t> m_perm;
+	/** Whether the row permutation is odd, which flips the sign of the determinant */
+	bool m_oddPermutation = false;
+	/** Whether a column without a non-zero pivot was found */
+	bool m_singular = false;
+
+	/** Swaps two rows of the factorization, recording the swap in the permutation */
+	void swapRows(size_t row1, size_t row2) {
+	    MatrixRowOps::rowSwap(m_lu, row1, row2);
+	    std::swap(m_perm[row1], m_perm[row2]);
+	    m_oddPermutation = !m_oddPermutation;
+	}
+
+	/** Factorizes m_lu in place, one pivot at a time */
+	void factorize(void) {
+	    size_t n = m_lu.getRows();
+	    for(size_t col = 0; col < n; ++col) {
+		/* Find the pivot row */
+		size_t pivotRow = col;
+		if constexpr (std::is_floating_point_v<T>) {
+		    for(size_t row = col + 1; row < n; ++row) {
+			if(std::abs(m_lu.atUnchecked(col, row)) > std::abs(m_lu.atUnchecked(col, pivotRow)))
+			    pivotRow = row;
+		    }
+		} else {
+		    while(pivotRow < n && m_lu.atUnchecked(col, pivotRow) == 0) {
+			++pivotRow;
+		    }
+		}
+		/* Without a pivot the column is already eliminated, U gets a zero on the diagonal */
+		if(pivotRow == n || m_lu.atUnchecked(col, pivotRow) == 0) {
+		    m_singular = true;
+		    continue;
+		}
+		if(pivotRow != col)
+		    swapRows(pivotRow, col);
+		/* Eliminate below the pivot, storing the multipliers in the eliminated entries */
+		std::span<const T> pivot = m_lu.rowSpan(col).subspan(col + 1);
+		T divisor = m_lu.atUnchecked(col, col);
+		for(size_t row = col + 1; row < n; ++row) {
+		    if(m_lu.atUnchecked(col, row) == 0)
+			continue;
+		    T scale = m_lu.atUnchecked(col, row) / divisor;
+		    m_lu.atUnchecked(col, row) = scale;
+		    MatrixRowOps::rowSub(m_lu.rowSpan(row).subspan(col + 1), scale, pivot);
+		}
+	    }
+	}
+
+	/** Factorizes m_lu in place by blocked right-looking elimination, for floating point types.
+	  * Each panel of columns is factorized with row operations confined to the panel, after which the
+	  * trailing submatrix is updated in a single matrix product, which runs at the speed of the GEMM kernel.
+	  */
+	void factorizeBlocked(void) {
+	    size_t n = m_lu.getRows();
+	    T* a = m_lu.data();
+	    for(size_t block = 0; block < n; block += MATRIX_LU_BLOCK_SIZE) {
+		size_t width = std::min<size_t>(MATRIX_LU_BLOCK_SIZE, n - block);
+		size_t end = block + width;
+
+		/* Factorize the panel (all rows from the block down, the block's columns) with partial pivoting */
+		for(size_t col = block; col < end; ++col) {
+		    size_t pivotRow = col;
+		    for(size_t row = col + 1; row < n; ++row) {
+			if(std::abs(a[row * n + col]) > std::abs(a[pivotRow * n + col]))
+			    pivotRow = row;
+		    }
+		    if(a[pivotRow * n + col] == 0) {
+			m_singular = true;
+			continue;
+		    }
+		    /* Swapping whole rows keeps the multipliers left of the panel and the trailing columns consistent */
+		    if(pivotRow != col)
+			swapRows(pivotRow, col);
+		    std::span<const T> pivot {a + col * n + col + 1, end - col - 1};
+		    T divisor = a[col * n + col];
+		    for(size_t row = col + 1; row < n; ++row) {
+			if(a[row * n + col] == 0)
+			    continue;
+			T scale = a[row * n + col] / divisor;
+			a[row * n + col] = scale;
+			MatrixRowOps::rowSub(std::span<T>{a + row * n + col + 1, end - col - 1}, scale, pivot);
+		    }
+		}
+		if(end == n)
+		    break;
+
+		/* Solve the unit lower triangle of the panel against the block's rows of the trailing columns, giving U12 */
+		for(size_t row = block + 1; row < end; ++row) {
+		    std::span<T> target {a + row * n + end, n - end};
+		    for(size_t col = block; col < row; ++col) {
+			if(a[row * n + col] != 0)
+			    MatrixRowOps::rowSub(target, a[row * n + col], std::span<const T>{a + col * n + end, n - end});
+		    }
+		}
+
+		/* Trailing update A22 -= L21 * U12 */
+		MatrixKernel::parallelGemm(n - end, n - end, width,
+					   a + end * n + block, n, size_t{1},
+					   a + block * n + end, n, size_t{1},
+					   a + end * n + end, n, size_t{1}, T{-1});
+	    }
+	}
+
+    public:
+	/** Constructor, factorizes the given square Matrix */
+	explicit LU(const Matrix<T>& m) : LU{m.view()} {}
+
+	/** Constructor, factorizes a copy of the given square view, such as a block of a Matrix or a mapped MatrixFile */
+	explicit LU(MatrixView<const T> m) : m_lu{m}, m_perm(m.getRows()) {
+	    if(m.getCols() != m.getRows())
+		throw std::runtime_error {"Matrix Error: Can't factorize a non-square Matrix"};
+	    for(size_t idx = 0; idx < m_perm.size(); ++idx) {
+		m_perm[idx] = idx;
+	    }
+	    if constexpr (std::is_floating_point_v<T>) {
+		if(m_perm.size() > MATRIX_LU_BLOCK_SIZE) {
+		    factorizeBlocked();
+		    return;
+		}
+	    }
+	    factorize();
+	}
+
+	/** Returns the size (rows and columns) of the factorized Matrix */
+	size_t getSize(void) const {
+	    return m_lu.getRows();
+	}
+
+	/** Whether the factorized Matrix is singular, in which case it can't be used to solve */
+	bool isSingular(void) const {
+	    return m_singular;
+	}
+
+	/** Returns L and U packed into one Matrix, L below the diagonal without its unit diagonal and U on and above it */
+	const Matrix<T>& getFactors(void) const {
+	    return m_lu;
+	}
+
+	/** Returns the row of the original Matrix in each row of the factorization */
+	const std::vector<size_t>& getPermutation(void) const {
+	    return m_perm;
+	}
+
+	/** Returns the determinant of the factorized Matrix */
+	T determinant(void) const {
+	    T det {1};
+	    for(size_t idx = 0; idx < getSize(); ++idx) {
+		det *= m_lu.atUnchecked(idx, idx);
+	    }
+	    return m_oddPermutation ? T{0} - det : det;
+	}
+
+	/** Solves A * X = B for every column of B at once, returns X */
+	Matrix<T> solve(const Matrix<T>& b) const {
+	    return solve(b.view());
+	}
+
+	/** Solves A * X = B for every column of the viewed B at once, returns X */
+	Matrix<T> solve(MatrixView<const T> b) const {
+	    size_t n = getSize();
+	    if(b.getRows() != n)
+		throw std::runtime_error {"Matrix Error: Right-hand side has the wrong number of rows"};
+	    if(m_singular)
+		throw std::runtime_error {"Matrix Error: Can't solve with a singular Matrix"};
+	    /* Apply the row permutation */
+	    Matrix<T> x {b.getCols(), n};
+	    for(size_t row = 0; row < n; ++row) {
+		x.rowView(row).assign(b.rowView(m_perm[row]));
+	    }
+	    /* Forward substitution with the unit lower triangle, L * Y = P * B */
+	    for(size_t row = 1; row < n; ++row) {
+		for(size_t col = 0; col < row; ++col) {
+		    if(m_lu.atUnchecked(col, row) != 0)
+			MatrixRowOps::rowSub(x, row, m_lu.atUnchecked(col, row), col);
+		}
+	    }
+	    /* Back substitution with the upper triangle, U * X = Y */
+	    for(size_t row = n; row-- > 0;) {
+		for(size_t col = row + 1; col < n; ++col) {
+		    if(m_lu.atUnchecked(col, row) != 0)
+			MatrixRowOps::rowSub(x, row, m_lu.atUnchecked(col, row), col);
+		}
+		MatrixRowOps::rowDiv(x, row, m_lu.atUnchecked(row, row));
+	    }
+	    return x;
+	}
+
+	/** Solves A * x = b for a single right-hand side vector, returns x */
+	std::vector<T> solve(const std::vector<T>& b) const {
+	    Matrix<T> column {1, b.size()};
+	    for(size_t idx = 0; idx < b.size(); ++idx) {
+		column.atUnchecked(0, idx) = b[idx];
+	    }
+	    Matrix<T> x = solve(column);
+	    return std::vector<T>(x.data(), x.data() + x.getRows());
+	}
+};
+
+#endif /* MATRIX_LU_H */
@@ -0,0 +1,166 @@
+/**
+ * @file MatrixLUTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the LU factorization
+*/
+
+#include "MatrixLUTest.hh"
+
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <cstdint>
+
+#include "MatrixTestUtil.hh"
+
+namespace {
+
+void factorizeTest(void) {
+
+    /* The zero in the top left needs a row swap */
+    Matrix<Rational> m {{0, 1, 2}, {1, 0, 3}, {4, -3, 8}};
+    LU<Rational> lu {m};
+    assert(!lu.isSingular());
+    assert(lu.getSize() == 3);
+
+    /* Rebuilding P * A from the packed factors */
+    const Matrix<Rational>& f = lu.getFactors();
+    Matrix<Rational> l = Matrix<Rational>::identity(3);
+    Matrix<Rational> u {3, 3, 0};
+    for(size_t row = 0; row < 3; ++row) {
+	for(size_t col = 0; col < 3; ++col) {
+	    if(col < row)
+		l.at(col, row) = f.at(col, row);
+	    else
+		u.at(col, row) = f.at(col, row);
+	}
+    }
+    Matrix<Rational> product = l * u;
+    for(size_t row = 0; row < 3; ++row) {
+	for(size_t col = 0; col < 3; ++col) {
+	    assert(product.at(col, row) == m.at(col, lu.getPermutation()[row]));
+	}
+    }
+
+    /* Non-square matrices can't be factorized */
+    bool caught = false;
+    try {
+	LU<Rational> bad {Matrix<Rational>{3, 2, 0}};
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void determinantTest(void) {
+
+    LU<Rational> lu1 {Matrix<Rational>{{0, 1, 2}, {1, 0, 3}, {4, -3, 8}}};
+    assert(lu1.determinant() == Rational{-2});
+
+    LU<Rational> lu2 {Matrix<Rational>{{4, 3}, {3, 2}}};
+    assert(lu2.determinant() == Rational{-1});
+
+    LU<Rational> lu3 {Matrix<Rational>{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}};
+    assert(lu3.isSingular());
+    assert(lu3.determinant() == Rational{0});
+
+    LU<double> lu4 {Matrix<double>{{2.0, 0.0}, {1.0, 4.0}}};
+    assert(lu4.determinant() == 8.0);
+}
+
+void solveTest(void) {
+
+    Matrix<Rational> a {{2, 1, 1}, {4, -6, 0}, {-2, 7, 2}};
+    LU<Rational> lu {a};
+
+    /* Single right-hand side */
+    std::vector<Rational> x = lu.solve(std::vector<Rational>{5, -2, 9});
+    assert(x.size() == 3);
+    assert(x[0] == 1 && x[1] == 1 && x[2] == 2);
+
+    /* Several right-hand sides against the same factorization */
+    Matrix<Rational> b {{5, 2}, {-2, 4}, {9, -2}};
+    Matrix<Rational> xs = lu.solve(b);
+    assert(a * xs == b);
+
+    /* The inverse is the solution against the identity */
+    Matrix<Rational> inverse = a;
+    assert(MatrixReduce::invert(inverse));
+    assert(lu.solve(Matrix<Rational>::identity(3)) == inverse);
+
+    /* Floating point, with partial pivoting */
+    LU<double> luD {Matrix<double>{{1.0, 2.0}, {4.0, 4.0}}};
+    std::vector<double> xD = luD.solve(std::vector<double>{5.0, 12.0});
+    assert(std::abs(xD[0] - 1.0) < 1e-12 && std::abs(xD[1] - 2.0) < 1e-12);
+
+    /* Wrong shapes and singular matrices are rejected */
+    bool caught = false;
+    try {
+	lu.solve(std::vector<Rational>{1, 2});
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+    caught = false;
+    try {
+	LU<Rational> singular {Matrix<Rational>{{1, 2}, {2, 4}}};
+	singular.solve(std::vector<Rational>{1, 2});
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void blockedTest(void) {
+
+    /* Large enough for several panels of the blocked factorization, with a size that doesn't divide evenly */
+    const size_t n = 2 * MATRIX_LU_BLOCK_SIZE + 37;
+    Matrix<double> a {n, n};
+    uint32_t state = 12345;
+    for(size_t row = 0; row < n; ++row) {
+	for(size_t col = 0; col < n; ++col) {
+	    a.at(col, row) = static_cast<double>((MatrixTestUtil::nextRandom(state) >> 16) % 2001) / 1000.0 - 1.0;
+	}
+    }
+    Matrix<double> expected {1, n};
+    for(size_t row = 0; row < n; ++row) {
+	expected.at(0, row) = static_cast<double>(row % 7) - 3.0;
+    }
+    Matrix<double> b = a * expected;
+
+    LU<double> lu {a};
+    assert(!lu.isSingular());
+    Matrix<double> x = lu.solve(b);
+    for(size_t row = 0; row < n; ++row) {
+	assert(std::abs(x.at(0, row) - expected.at(0, row)) < 1e-8);
+    }
+
+    /* Partial pivoting keeps every multiplier at most one in magnitude */
+    for(size_t row = 0; row < n; ++row) {
+	for(size_t col = 0; col < row; ++col) {
+	    assert(std::abs(lu.getFactors().at(col, row)) <= 1.0);
+	}
+    }
+
+    /* A repeated row makes the matrix singular */
+    a.rowView(n - 1).assign(a.rowView(3));
+    LU<double> singular {a};
+    assert(std::abs(singular.determinant()) < 1e-8);
+}
+
+} /* anonymous */
+
+/** Function containing test cases for the LU factorization */
+void matrixLUTest(void) {
+
+    std::puts("--- MatrixLU TC Running ---");
+    factorizeTest();
+    std::puts("-> Passed factorizeTest()");
+    determinantTest();
+    std::puts("-> Passed determinantTest()");
+    solveTest();
+    std::puts("-> Passed solveTest()");
+    blockedTest();
+    std::puts("-> Passed blockedTest()");
+    std::puts("--- MatrixLU Tests Passed ---");
+}
@@ -0,0 +1,19 @@
+/**
+ * @file MatrixLUTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the LU factorization
+*/
+#ifndef MATRIX_LU_TEST_H
+#define MATRIX_LU_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+#include "MatrixLU.hh"
+
+/** Function containing test cases for the LU factorization */
+void matrixLUTest(void);
+
+#endif /* MATRIX_LU_TEST_H */
@@ -0,0 +1,304 @@
+/**
+ * @file MatrixSoA.hh
+ * @author Martin
+ * @brief File containing the structure-of-arrays storage of a Rational Matrix, with batched row operations working on whole rows
+*/
+#ifndef MATRIX_SOA_H
+#define MATRIX_SOA_H
+
+#include <vector>
+#include <span>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+#include "../BigInt/ModArith.hh"
+
+/** Rational Matrix stored as a structure of arrays: the numerators (with the sign folded in) and the denominators of all elements
+  * are kept in two separate contiguous arrays of rows. Row operations then stream over plain 64-bit integers, a pass at a time,
+  * instead of over one Rational at a time. Only elements in the inline form of Rational (see Rational.hh) can be stored.
+  */
+class MatrixSoA {
+
+    private:
+	/** The number of columns in the matrix (width) */
+	size_t m_cols;
+	/** The number of rows in the matrix (height) */
+	size_t m_rows;
+	/** The signed numerators, row by row */
+	std::vector<int64_t> m_num;
+	/** The positive denominators, row by row */
+	std::vector<uint64_t> m_den;
+
+	/** Returns the element at the given flat index as a Rational */
+	Rational element(size_t idx) const {
+	    int64_t num = m_num[idx];
+	    uint64_t magnitude = num < 0 ? uint64_t{0} - static_cast<uint64_t>(num) : static_cast<uint64_t>(num);
+	    return Rational{magnitude, m_den[idx], num < 0};
+	}
+
+    public:
+	/** Constructor, creates a zero matrix of shape (columns x rows) */
+	MatrixSoA(size_t columns, size_t rows) : m_cols{columns}, m_rows{rows}, m_num(columns * rows, 0), m_den(columns * rows, 1) {}
+
+	/** Returns the structure-of-arrays copy of a Rational Matrix, or nothing if an element doesn't fit into the inline form */
+	static std::optional<MatrixSoA> from(const Matrix<Rational>& m) {
+	    MatrixSoA result {m.getCols(), m.getRows()};
+	    for(size_t idx = 0; idx < m.getCols() * m.getRows(); ++idx) {
+		const Rational& element = m.data()[idx];
+		if(!element.isSmall())
+		    return std::nullopt;
+		int64_t num = static_cast<int64_t>(element.getNumerator());
+		result.m_num[idx] = element.isNegative() ? -num : num;
+		result.m_den[idx] = element.getDenominator();
+	    }
+	    return result;
+	}
+
+	/** Writes the elements back into a Rational Matrix of the same shape */
+	void copyTo(Matrix<Rational>& m) const {
+	    if(m.getCols() != m_cols || m.getRows() != m_rows)
+		throw std::runtime_error {"Matrix Error: Can't copy into a Matrix of different dimensions"};
+	    for(size_t idx = 0; idx < m_cols * m_rows; ++idx) {
+		m.data()[idx] = element(idx);
+	    }
+	}
+
+	size_t getRows(void) const {
+	    return m_rows;
+	}
+
+	size_t getCols(void) const {
+	    return m_cols;
+	}
+
+	/** Returns the element at (column, row) as a Rational */
+	Rational at(size_t column, size_t row) const {
+	    if(column >= m_cols || row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return element((row * m_cols) + column);
+	}
+
+	/** Returns the numerators of the given row */
+	std::span<int64_t> numerators(size_t row) {
+	    if(row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return {m_num.data() + (row * m_cols), m_cols};
+	}
+
+	/** Returns the denominators of the given row */
+	std::span<uint64_t> denominators(size_t row) {
+	    if(row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return {m_den.data() + (row * m_cols), m_cols};
+	}
+};
+
+
+/** Namespace containing basic Matrix row operations */
+namespace MatrixRowOps {
+
+    /** Scratch arrays of the batched row kernels, one set per thread, grown to the longest row seen */
+    struct BatchScratch {
+	std::vector<uint64_t> a, b, c, g1, g2;
+	std::vector<unsigned __int128> wide;
+	std::vector<uint64_t> den;
+	std::vector<int64_t> num;
+	std::vector<size_t> index;
+
+	void reserve(size_t n) {
+	    for(std::vector<uint64_t>* v : {&a, &b, &c, &g1, &g2, &den})
+		v->resize(std::max(v->size(), n));
+	    wide.resize(std::max(wide.size(), n));
+	    num.resize(std::max(num.size(), n));
+	    index.resize(std::max(index.size(), n));
+	}
+
+	static BatchScratch& local(void) {
+	    thread_local BatchScratch scratch;
+	    return scratch;
+	}
+    };
+
+    /** Returns the magnitude of a signed numerator */
+    inline uint64_t magnitude(int64_t num) {
+	return num < 0 ? uint64_t{0} - static_cast<uint64_t>(num) : static_cast<uint64_t>(num);
+    }
+
+    /** Substitutes a multiple of row2 from row1 (row1 -= multiple * row2) over the columns from fromCol on, a whole row at a time.
+      * The product is cross-cancelled and the difference reduced by Henrici's method, with the gcds of each pass computed for all
+      * columns together by the lane-parallel binary gcd. Returns false, leaving row1 unchanged, if a result doesn't fit into 64 bits.
+      */
+    inline bool rowSub(MatrixSoA& m, size_t row1Idx, const Rational& multiple, size_t row2Idx, size_t fromCol = 0) {
+	if(!multiple.isSmall())
+	    return false;
+	std::span<int64_t> xNum = m.numerators(row1Idx).subspan(fromCol);
+	std::span<uint64_t> xDen = m.denominators(row1Idx).subspan(fromCol);
+	std::span<int64_t> pNum = m.numerators(row2Idx).subspan(fromCol);
+	std::span<uint64_t> pDen = m.denominators(row2Idx).subspan(fromCol);
+	size_t n = xNum.size();
+	uint64_t sMag = multiple.getNumerator();
+	uint64_t sDen = multiple.getDenominator();
+	bool sNegative = multiple.isNegative();
+	if(sMag == 0)
+	    return true;
+	BatchScratch& s = BatchScratch::local();
+	s.reserve(n);
+
+	/* Only the columns where row2 is non-zero change, their indices are gathered without branching */
+	size_t count = 0;
+	for(size_t col = 0; col < n; ++col) {
+	    s.index[count] = col;
+	    count += pNum[col] != 0;
+	}
+
+	/* Cross-cancellation of the product, gcd(|s|, pden) and gcd(|pnum|, sden) */
+	for(size_t k = 0; k < count; ++k) {
+	    s.a[k] = sMag;
+	    s.b[k] = magnitude(pNum[s.index[k]]);
+	    s.c[k] = pDen[s.index[k]];
+	}
+	ModArith::binaryGcdLanes(s.a.data(), s.c.data(), s.g1.data(), count);
+	std::fill_n(s.a.data(), count, sDen);
+	ModArith::binaryGcdLanes(s.b.data(), s.a.data(), s.g2.data(), count);
+
+	/* Product q = multiple * p as a signed numerator (in num) and denominator (in den) */
+	bool overflow = false;
+	for(size_t k = 0; k < count; ++k) {
+	    size_t col = s.index[k];
+	    unsigned __int128 qMag = static_cast<unsigned __int128>(sMag / s.g1[k]) * (s.b[k] / s.g2[k]);
+	    unsigned __int128 qDen = static_cast<unsigned __int128>(sDen / s.g2[k]) * (s.c[k] / s.g1[k]);
+	    overflow |= qMag > static_cast<uint64_t>(INT64_MAX) || qDen > UINT64_MAX;
+	    int64_t q = static_cast<int64_t>(static_cast<uint64_t>(qMag));
+	    s.num[k] = (sNegative != (pNum[col] < 0)) ? -q : q;
+	    s.den[k] = static_cast<uint64_t>(qDen);
+	    s.c[k] = xDen[col];
+	}
+	if(overflow)
+	    return false;
+
+	/* Henrici: d1 = gcd(xden, qden) */
+	ModArith::binaryGcdLanes(s.c.data(), s.den.data(), s.g1.data(), count);
+	for(size_t k = 0; k < count; ++k) {
+	    uint64_t d1 = s.g1[k];
+	    __int128 left = static_cast<__int128>(xNum[s.index[k]]) * static_cast<__int128>(s.den[k] / d1);
+	    __int128 right = static_cast<__int128>(s.num[k]) * static_cast<__int128>(s.c[k] / d1);
+	    __int128 t;
+	    overflow |= __builtin_sub_overflow(left, right, &t);
+	    s.wide[k] = static_cast<unsigned __int128>(t);
+	    unsigned __int128 tMag = t < 0 ? static_cast<unsigned __int128>(0) - static_cast<unsigned __int128>(t) : static_cast<unsigned __int128>(t);
+	    /* The 128-bit remainder is only needed for large differences */
+	    s.a[k] = d1 == 1 ? 0 : (tMag <= UINT64_MAX ? static_cast<uint64_t>(tMag) % d1 : static_cast<uint64_t>(tMag % d1));
+	}
+	/* d2 = gcd(t, d1) = gcd(t mod d1, d1) */
+	ModArith::binaryGcdLanes(s.a.data(), s.g1.data(), s.g2.data(), count);
+	for(size_t k = 0; k < count; ++k) {
+	    __int128 t = static_cast<__int128>(s.wide[k]);
+	    uint64_t d1 = s.g1[k], d2 = s.g2[k];
+	    __int128 num = d2 == 1 ? t : t / static_cast<__int128>(d2);
+	    unsigned __int128 den = static_cast<unsigned __int128>(s.c[k] / d1) * (s.den[k] / d2);
+	    overflow |= num > INT64_MAX || num < -INT64_MAX || den > UINT64_MAX;
+	    s.num[k] = static_cast<int64_t>(num);
+	    s.den[k] = t == 0 ? 1 : static_cast<uint64_t>(den);
+	}
+	if(overflow)
+	    return false;
+	for(size_t k = 0; k < count; ++k) {
+	    xNum[s.index[k]] = s.num[k];
+	    xDen[s.index[k]] = s.den[k];
+	}
+	return true;
+    }
+
+    /** Divides a row by a non-zero Rational over the columns from fromCol on, a whole row at a time, with cross-cancellation.
+      * Returns false, leaving the row unchanged, if a result doesn't fit into 64 bits.
+      */
+    inline bool rowDiv(MatrixSoA& m, size_t rowIdx, const Rational& divisor, size_t fromCol = 0) {
+	if(divisor == 0)
+	    throw std::runtime_error {"Rational Error: Zero has no inverse element"};
+	if(!divisor.isSmall())
+	    return false;
+	std::span<int64_t> xNum = m.numerators(rowIdx).subspan(fromCol);
+	std::span<uint64_t> xDen = m.denominators(rowIdx).subspan(fromCol);
+	size_t n = xNum.size();
+	/* Multiplying with the inverse dMag / dDen' of the divisor, cancelling gcd(|xnum|, dMag) and gcd(dDen, xden) */
+	uint64_t dMag = divisor.getNumerator();
+	uint64_t dDen = divisor.getDenominator();
+	bool dNegative = divisor.isNegative();
+	BatchScratch& s = BatchScratch::local();
+	s.reserve(n);
+	for(size_t col = 0; col < n; ++col) {
+	    s.a[col] = magnitude(xNum[col]);
+	}
+	std::fill_n(s.b.data(), n, dMag);
+	ModArith::binaryGcdLanes(s.a.data(), s.b.data(), s.g1.data(), n);
+	std::fill_n(s.b.data(), n, dDen);
+	ModArith::binaryGcdLanes(s.b.data(), xDen.data(), s.g2.data(), n);
+	bool overflow = false;
+	for(size_t col = 0; col < n; ++col) {
+	    unsigned __int128 num = static_cast<unsigned __int128>(s.a[col] / s.g1[col]) * (dDen / s.g2[col]);
+	    unsigned __int128 den = static_cast<unsigned __int128>(xDen[col] / s.g2[col]) * (dMag / s.g1[col]);
+	    overflow |= num > static_cast<uint64_t>(INT64_MAX) || den > UINT64_MAX;
+	    int64_t value = static_cast<int64_t>(static_cast<uint64_t>(num));
+	    s.num[col] = (dNegative != (xNum[col] < 0)) ? -value : value;
+	    s.den[col] = num == 0 ? 1 : static_cast<uint64_t>(den);
+	}
+	if(overflow)
+	    return false;
+	std::copy_n(s.num.data(), n, xNum.data());
+	std::copy_n(s.den.data(), n, xDen.data());
+	return true;
+    }
+
+    /** Swaps two rows of a structure-of-arrays Matrix */
+    inline void rowSwap(MatrixSoA& m, size_t row1Idx, size_t row2Idx) {
+	if(row1Idx == row2Idx)
+	    return;
+	std::span<int64_t> num1 = m.numerators(row1Idx), num2 = m.numerators(row2Idx);
+	std::span<uint64_t> den1 = m.denominators(row1Idx), den2 = m.denominators(row2Idx);
+	std::swap_ranges(num1.begin(), num1.end(), num2.begin());
+	std::swap_ranges(den1.begin(), den1.end(), den2.begin());
+    }
+
+} /* namespace MatrixRowOps */
+
+
+/** Namespace containing Matrix Reduction functions */
+namespace MatrixReduce {
+
+    /** Gauss-Jordan elimination of a structure-of-arrays Matrix with the batched row operations, in place.
+      * Without reduced only the entries below each pivot are eliminated (REF), with reduced the entries above as well (RREF).
+      * Returns false as soon as a row operation overflows 64 bits, the Matrix is then left partially reduced.
+      */
+    inline bool reduceBatched(MatrixSoA& m, bool reduced) {
+	size_t currentRow = 0;
+	for(size_t col = 0; col < m.getCols() && currentRow < m.getRows(); ++col) {
+	    /* Find the first row with a non-zero entry in this column */
+	    size_t pivotRow = currentRow;
+	    while(pivotRow < m.getRows() && m.numerators(pivotRow)[col] == 0) {
+		++pivotRow;
+	    }
+	    if(pivotRow == m.getRows())
+		continue;
+	    MatrixRowOps::rowSwap(m, pivotRow, currentRow);
+	    /* Every row from the current one down is zero left of the column, so row operations start there */
+	    Rational pivot = m.at(col, currentRow);
+	    if(pivot != 1 && !MatrixRowOps::rowDiv(m, currentRow, pivot, col))
+		return false;
+	    for(size_t row = reduced ? 0 : currentRow + 1; row < m.getRows(); ++row) {
+		if(row == currentRow || m.numerators(row)[col] == 0)
+		    continue;
+		if(!MatrixRowOps::rowSub(m, row, m.at(col, row), currentRow, col))
+		    return false;
+	    }
+	    ++currentRow;
+	}
+	return true;
+    }
+
+} /* namespace MatrixReduce */
+
+#endif /* MATRIX_SOA_H */
@@ -0,0 +1,135 @@
+/**
+ * @file MatrixSoATest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the structure-of-arrays Rational Matrix
+*/
+
+#include "MatrixSoATest.hh"
+
+#include <optional>
+#include <cstdint>
+
+#include "MatrixTestUtil.hh"
+
+namespace {
+
+void conversionTest(void) {
+
+    Matrix<Rational> m1 {{"1/2", "-3/4", 0}, {5, "-7/9", "11/13"}};
+    std::optional<MatrixSoA> soa = MatrixSoA::from(m1);
+    assert(soa && soa->getCols() == 3 && soa->getRows() == 2);
+    assert(soa->numerators(0)[1] == -3 && soa->denominators(0)[1] == 4);
+    assert(soa->numerators(1)[0] == 5 && soa->denominators(1)[0] == 1);
+    assert(soa->at(2, 1) == Rational("11/13") && soa->at(2, 0) == 0);
+    Matrix<Rational> m2 {3, 2};
+    soa->copyTo(m2);
+    assert(m2 == m1);
+
+    /* Elements in the big form can't be stored */
+    m1.at(0, 0) = Rational{"-1208925819614629174706176/9"};
+    assert(!MatrixSoA::from(m1));
+
+    bool caught = false;
+    try {
+	soa->at(3, 0);
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void rowOpsTest(void) {
+
+    /* The batched kernels agree with the Rational row operations, including rows longer than one block of gcd lanes */
+    uint32_t state = 77;
+    for(int round = 0; round < 20; ++round) {
+	Matrix<Rational> m = MatrixTestUtil::randomMatrix(3 + round, 3, state);
+	Matrix<Rational> expected = m;
+	MatrixSoA soa = *MatrixSoA::from(m);
+	Rational multiple = m.at(0, 2) + Rational(1, 3, true);
+	MatrixRowOps::rowSub(expected, 0, multiple, 1);
+	assert(MatrixRowOps::rowSub(soa, 0, multiple, 1));
+	size_t from = round % 3;
+	Rational divisor = m.at(from, 1) == 0 ? Rational(-5, 7) : m.at(from, 1);
+	for(size_t col = from; col < m.getCols(); ++col) {
+	    expected.at(col, 2) /= divisor;
+	}
+	assert(MatrixRowOps::rowDiv(soa, 2, divisor, from));
+	MatrixRowOps::rowSwap(expected, 1, 2);
+	MatrixRowOps::rowSwap(soa, 1, 2);
+	Matrix<Rational> result {m.getCols(), m.getRows()};
+	soa.copyTo(result);
+	assert(result == expected);
+    }
+
+    bool caught = false;
+    try {
+	MatrixSoA soa {2, 2};
+	MatrixRowOps::rowDiv(soa, 0, Rational{});
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void overflowTest(void) {
+
+    /* A row operation that doesn't fit into 64 bits leaves the row unchanged */
+    Matrix<Rational> m {{Rational{1, (uint64_t{1} << 62) + 1}, 1}, {Rational{1, (uint64_t{1} << 62) - 1}, 1}};
+    MatrixSoA soa = *MatrixSoA::from(m);
+    assert(!MatrixRowOps::rowSub(soa, 0, Rational{1}, 1));
+    Matrix<Rational> result {2, 2};
+    soa.copyTo(result);
+    assert(result == m);
+    assert(!MatrixRowOps::rowDiv(soa, 0, Rational{1, UINT64_MAX}));
+    assert(MatrixRowOps::rowDiv(soa, 0, Rational{1, (uint64_t{1} << 62) + 1}));
+    assert(soa.at(0, 0) == 1 && soa.at(1, 0) == Rational((uint64_t{1} << 62) + 1, 1));
+}
+
+void batchedReduceTest(void) {
+
+    /* Batched elimination agrees with the Rational elimination */
+    uint32_t state = 4242;
+    for(int round = 0; round < 30; ++round) {
+	Matrix<Rational> m = MatrixTestUtil::randomMatrix(2 + round % 5, 2 + (round / 5) % 4, state);
+	Matrix<Rational> standard = m;
+	Matrix<Rational> batched = m;
+	assert(MatrixReduce::toRREF(standard));
+	assert(MatrixReduce::toRREF(batched, MatrixReduce::Mode::Batched));
+	assert(batched == standard);
+	Matrix<Rational> echelon = m;
+	assert(MatrixReduce::toREF(echelon, MatrixReduce::Mode::Batched));
+	assert(MatrixReduce::REFtoRREF(echelon));
+	assert(echelon == standard);
+    }
+
+    /* Hilbert-like entries overflow 64 bits during the elimination, which is then finished with Rational row operations */
+    Matrix<Rational> h {12, 12};
+    for(size_t row = 0; row < 12; ++row) {
+	for(size_t col = 0; col < 12; ++col) {
+	    h.at(col, row) = Rational{1, (row + 1) * (col + 1) * 1000003 + row + col};
+	}
+    }
+    Matrix<Rational> partial = h;
+    assert(!MatrixReduce::toEchelonBatched(partial, true));
+    assert(MatrixReduce::toRREF(partial) && partial == Matrix<Rational>::identity(12));
+    Matrix<Rational> batched = h;
+    assert(MatrixReduce::toRREF(batched, MatrixReduce::Mode::Batched));
+    assert(batched == Matrix<Rational>::identity(12));
+}
+
+} /* anonymous */
+
+void matrixSoATest(void) {
+
+    std::puts("--- Matrix SoA TC Running ---");
+    conversionTest();
+    std::puts("-> Passed conversionTest()");
+    rowOpsTest();
+    std::puts("-> Passed rowOpsTest()");
+    overflowTest();
+    std::puts("-> Passed overflowTest()");
+    batchedReduceTest();
+    std::puts("-> Passed batchedReduceTest()");
+    std::puts("--- Matrix SoA Tests Passed ---");
+}
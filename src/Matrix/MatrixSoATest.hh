@@ -0,0 +1,21 @@
+/**
+ * @file MatrixSoATest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the structure-of-arrays Rational Matrix
+*/
+#ifndef MATRIX_SOA_TEST_H
+#define MATRIX_SOA_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "Matrix.hh"
+#include "MatrixUtil.hh"
+#include "MatrixSoA.hh"
+#include "MatrixExact.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the structure-of-arrays Rational Matrix and its batched row operations */
+void matrixSoATest(void);
+
+#endif /* MATRIX_SOA_TEST_H */
@@ -6,6 +6,8 @@
 
 #include "MatrixTest.hh"
 
+#include <vector>
+
 namespace {
 
 void constructorTest(void) {
@@ -72,6 +74,22 @@ void accessTest(void) {
 
     /* Access test - initializer list-based random access test */
     assert(m4.at(0, 0) == 1.2f && m4.at(2, 0) == 7.6f && m4.at(1, 1) == "-3/4" && m4.at(3, 1) == "4/3");
+
+    /* Access test - unchecked access and row spans */
+    assert(m3.atUnchecked(0, 0) == 1 && m3.atUnchecked(3, 2) == 12 && m3.atUnchecked(1, 1) == 6);
+    std::span<Rational> row = m3.rowSpan(1);
+    assert(row.size() == 4 && row[0] == 5 && row[3] == 8);
+    row[2] = 70;
+    assert(m3.at(2, 1) == 70);
+    const Matrix<Rational>& constRef = m3;
+    assert(constRef.rowSpan(2)[1] == 10);
+    caught = 0;
+    try {
+	m3.rowSpan(3);
+    } catch(std::exception& e) {
+	++caught;
+    }
+    assert(caught == 1);
 }
 
 void resizeTest(void) {
@@ -98,6 +116,13 @@ void resizeTest(void) {
     std::puts(m1.print([](Rational r) { return r.toString(); }).c_str());
     assert(m1.getCols() == 2 && m1.getRows() == 3);
     assert(m1.at(0, 0) == 4.2f && m1.at(1, 1) == 6.2f && m1.at(1, 2) == 0);
+
+    /* Trivially copyable elements are copied a row at a time */
+    Matrix<double> m2 {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+    m2.resize(4, 3);
+    assert(m2 == (Matrix<double>{{1.0, 2.0, 3.0, 0.0}, {4.0, 5.0, 6.0, 0.0}, {0.0, 0.0, 0.0, 0.0}}));
+    m2.resize(2, 1);
+    assert(m2 == (Matrix<double>{{1.0, 2.0}}));
 }
 
 void printTest(void) {
@@ -198,6 +223,226 @@ void arithmeticTest(void) {
     assert(caught == 2);
 }
 
+void moveTest(void) {
+
+    Matrix<Rational> m1 {{1, 2, 3}, {4, 5, 6}};
+    Matrix<Rational> m2 {std::move(m1)};
+
+    /* The moved-from Matrix is left empty, the target owns the data */
+    assert(m1.getCols() == 0 && m1.getRows() == 0);
+    assert(m2.getCols() == 3 && m2.getRows() == 2 && m2.at(2, 1) == 6);
+
+    Matrix<Rational> m3;
+    m3 = std::move(m2);
+    assert(m2.getCols() == 0 && m2.getRows() == 0);
+    assert(m3.getCols() == 3 && m3.getRows() == 2 && m3.at(0, 0) == 1);
+
+    /* A moved-from Matrix can be assigned to again */
+    m2 = m3;
+    assert(m2 == m3);
+
+    /* Copy assignment into a Matrix of the same element count but different shape */
+    Matrix<Rational> m4 {{7, 8}, {9, 10}, {11, 12}};
+    m4 = m3;
+    assert(m4.getCols() == 3 && m4.getRows() == 2 && m4 == m3);
+}
+
+void inPlaceTest(void) {
+
+    Matrix<Rational> m1 {{1, 2, 3}, {4, 5, 6}};
+    Matrix<Rational> m2 {{6, 5, 4}, {3, 2, 1}};
+    Matrix<Rational> r1 {{-5, -3, -1}, {1, 3, 5}};
+
+    /* In-place subtraction */
+    Matrix<Rational> m3 = m1;
+    m3 -= m2;
+    assert(m3 == r1);
+
+    /* In-place scalar multiplication and division */
+    m3 *= Rational{2};
+    assert(m3.at(0, 0) == -10 && m3.at(2, 1) == 10);
+    m3 /= Rational{4};
+    assert(m3.at(0, 0) == "-5/2" && m3.at(2, 1) == "5/2");
+
+    /* Operators with temporaries on either side */
+    Matrix<Rational> m4 = m1 - (m2 * 2);
+    Matrix<Rational> r4 {{-11, -8, -5}, {-2, 1, 4}};
+    assert(m4 == r4);
+    Matrix<Rational> m5 = (m1 * 2) + (m2 * 2);
+    assert(m5 == Matrix<Rational>(3, 2, 14));
+    Matrix<Rational> m6 = m1 + (3 * m2);
+    Matrix<Rational> r6 {{19, 17, 15}, {13, 11, 9}};
+    assert(m6 == r6);
+
+    /* Shape mismatch is still detected on the temporary paths */
+    bool caught = false;
+    try {
+	Matrix<Rational> m7 = m1 - Matrix<Rational>{2, 2};
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void expressionTest(void) {
+
+    Matrix<Rational> a {{1, 2}, {3, 4}};
+    Matrix<Rational> b {{5, 6}, {7, 8}};
+    Matrix<Rational> c {{"1/2", 1}, {2, "-3/2"}};
+
+    /* Multi-term linear combinations are evaluated in a single pass */
+    Matrix<Rational> m1 = a + b - c * 2;
+    Matrix<Rational> r1 {{5, 6}, {6, 15}};
+    assert(m1 == r1);
+
+    Matrix<Rational> m2 = 2 * a - (b - c) + -a;
+    Matrix<Rational> r2 {{"-7/2", -3}, {-2, "-11/2"}};
+    assert(m2 == r2);
+
+    /* Assigning an expression that reads the target itself */
+    m2 = m2 + m2 * "1/2";
+    Matrix<Rational> r3 {{"-21/4", "-9/2"}, {-3, "-33/4"}};
+    assert(m2 == r3);
+
+    /* Assigning an expression of a different shape reallocates */
+    Matrix<Rational> m3 {3, 3};
+    m3 = a + b;
+    assert(m3.getCols() == 2 && m3.getRows() == 2 && m3.at(1, 1) == 12);
+
+    /* Compound assignment with an expression */
+    m3 += a * 2 - b;
+    m3 -= -a;
+    Matrix<Rational> r4 {{4, 8}, {12, 16}};
+    assert(m3 == r4);
+
+    /* Products are evaluated eagerly, with expression operands evaluated first */
+    Matrix<Rational> m4 = (a + b) * (b - a);
+    Matrix<Rational> r5 {{56, 56}, {88, 88}};
+    assert(m4 == r5);
+    Matrix<Rational> m5 = a * b + c;
+    Matrix<Rational> r6 {{"39/2", 23}, {45, "97/2"}};
+    assert(m5 == r6);
+
+    /* An expression can be stored and evaluated later, owning its temporaries */
+    auto expr = a * b - Matrix<Rational>{2, 2, 1};
+    Matrix<Rational> m6 = expr;
+    assert(m6.at(0, 0) == 18 && m6.at(1, 1) == 49);
+
+    /* Arithmetic element types */
+    Matrix<double> d1 {{1.0, 2.0}, {3.0, 4.0}};
+    Matrix<double> d2 = 0.5 * d1 + d1 * 2 - d1;
+    assert(d2.at(0, 0) == 1.5 && d2.at(1, 1) == 6.0);
+
+    /* Shape mismatches are detected when the expression is built */
+    bool caught = false;
+    try {
+	auto bad = a + c - Matrix<Rational>{3, 2};
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
+void kernelTest(void) {
+
+    /* Odd shapes exercise the partial register tiles and the zero-padded packing */
+    const size_t m = 37, k = 301, n = 29;
+    Matrix<int64_t> a {k, m};
+    Matrix<int64_t> b {n, k};
+    for(size_t row = 0; row < m; ++row) {
+	for(size_t col = 0; col < k; ++col) {
+	    a.at(col, row) = static_cast<int64_t>((row * 7 + col * 3) % 11) - 5;
+	}
+    }
+    for(size_t row = 0; row < k; ++row) {
+	for(size_t col = 0; col < n; ++col) {
+	    b.at(col, row) = static_cast<int64_t>((row * 5 + col * 13) % 17) - 8;
+	}
+    }
+
+    Matrix<int64_t> c = a * b;
+    assert(c.getCols() == n && c.getRows() == m);
+    for(size_t row = 0; row < m; ++row) {
+	for(size_t col = 0; col < n; ++col) {
+	    int64_t expected = 0;
+	    for(size_t idx = 0; idx < k; ++idx) {
+		expected += a.at(idx, row) * b.at(col, idx);
+	    }
+	    assert(c.at(col, row) == expected);
+	}
+    }
+
+    /* Floating point kernel path, compared against a product known exactly */
+    Matrix<double> d1 {{1.5, 2.0, -1.0}, {0.5, 0.0, 4.0}};
+    Matrix<double> d2 {{2.0, 1.0}, {-1.0, 0.5}, {0.25, 3.0}};
+    Matrix<double> d3 = d1 * d2;
+    Matrix<double> r3 {{0.75, -0.5}, {2.0, 12.5}};
+    assert(d3 == r3);
+}
+
+void viewTest(void) {
+
+    Matrix<Rational> m {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+
+    /* Views share the data of the Matrix */
+    MatrixView<Rational> sub = m.subView(1, 1, 2, 2);
+    assert(sub.getCols() == 2 && sub.getRows() == 2);
+    assert(sub.at(0, 0) == 5 && sub.at(1, 1) == 9);
+    sub.at(1, 0) = 60;
+    assert(m.at(2, 1) == 60);
+    m.at(2, 1) = 6;
+
+    MatrixView<Rational> row = m.rowView(2);
+    MatrixView<Rational> col = m.colView(1);
+    assert(row.getCols() == 3 && row.getRows() == 1 && row.at(2, 0) == 9);
+    assert(col.getCols() == 1 && col.getRows() == 3 && col.at(0, 2) == 8);
+    assert(!m.transposed().isRowContiguous());
+    assert(m.transposed().at(2, 0) == 7);
+
+    /* Out of bounds views are rejected */
+    bool caught = false;
+    try {
+	m.subView(2, 0, 2, 1);
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+
+    /* Copying a view into a Matrix, and assigning through a view */
+    Matrix<Rational> copy = sub;
+    Matrix<Rational> r1 {{5, 6}, {8, 9}};
+    assert(copy == r1);
+    m.subView(0, 0, 2, 2).assign(copy);
+    Matrix<Rational> r2 {{5, 6, 3}, {8, 9, 6}, {7, 8, 9}};
+    assert(m == r2);
+    m.colView(2).fill(0);
+    Matrix<Rational> r3 {{5, 6, 0}, {8, 9, 0}, {7, 8, 0}};
+    assert(m == r3);
+
+    /* Transposing in place reads elements that are overwritten, so the assignment has to evaluate first */
+    m.view().assign(m.transposed());
+    Matrix<Rational> r4 {{5, 8, 7}, {6, 9, 8}, {0, 0, 0}};
+    assert(m == r4);
+
+    /* Element-wise expressions and products over views */
+    Matrix<Rational> a {{1, 2}, {3, 4}};
+    Matrix<Rational> s = a.view() + a.transposed();
+    Matrix<Rational> r5 {{2, 5}, {5, 8}};
+    assert(s == r5);
+    Matrix<Rational> p1 = a.transposed() * a;
+    Matrix<Rational> r6 {{10, 14}, {14, 20}};
+    assert(p1 == r6);
+
+    /* Strided kernel path */
+    Matrix<double> d {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+    Matrix<double> p2 = d * d.transposed();
+    Matrix<double> r7 {{14.0, 32.0}, {32.0, 77.0}};
+    assert(p2 == r7);
+    Matrix<double> p3 = d.subView(1, 0, 2, 2).transposed() * d.colView(0);
+    Matrix<double> r8 {{22.0}, {27.0}};
+    assert(p3 == r8);
+}
+
 void identityTest(void) {
 
     Matrix<Rational> i1 = Matrix<Rational>::identity(1);
@@ -214,6 +459,50 @@ void identityTest(void) {
 
 }
 
+void appendTest(void) {
+
+    /* The first row sets the width, later rows are moved into the grown data block */
+    Matrix<Rational> m1;
+    std::vector<Rational> row {1, "1/2", -3};
+    m1.appendRow(row);
+    assert(m1.getCols() == 3 && m1.getRows() == 1 && m1.at(1, 0) == Rational(1, 2));
+    for(int idx = 0; idx < 20; ++idx) {
+	std::vector<Rational> next {idx, idx + 1, idx + 2};
+	m1.appendRow(next);
+	assert(m1.getRows() == static_cast<size_t>(idx) + 2 && m1.at(2, static_cast<size_t>(idx) + 1) == idx + 2);
+    }
+    assert(m1.at(2, 0) == -3);
+
+    /* Copies, moves and resizing keep working with the spare room */
+    Matrix<Rational> m2 = m1;
+    assert(m2 == m1);
+    Matrix<Rational> m3 = std::move(m2);
+    std::vector<Rational> last {7, 8, 9};
+    m3.appendRow(last);
+    assert(m3.getRows() == 22 && m3.at(0, 21) == 7);
+    m3.resize(2, 2);
+    assert(m3 == (Matrix<Rational>{{1, "1/2"}, {0, 1}}));
+
+    /* Reserved rows don't reallocate */
+    Matrix<double> m4 {2, 0};
+    m4.reserveRows(3);
+    const double* data = m4.data();
+    std::vector<double> values {1.5, 2.5};
+    for(int idx = 0; idx < 3; ++idx) {
+	m4.appendRow(values);
+    }
+    assert(m4.data() == data && m4.getRows() == 3 && m4.at(1, 2) == 2.5);
+
+    bool caught = false;
+    try {
+	std::vector<double> wrong {1.0};
+	m4.appendRow(wrong);
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
 } /* anonymous */
 
 /** Function containing test cases for the Matrix class */
@@ -226,6 +515,8 @@ void matrixTest(void) {
     std::puts("-> Passed accessTest()");
     resizeTest();
     std::puts("-> Passed resizeTest()");
+    appendTest();
+    std::puts("-> Passed appendTest()");
     printTest();
     std::puts("-> Passed printTest()");
     equalsTest();
@@ -234,6 +525,16 @@ void matrixTest(void) {
     std::puts("-> Passed compareTest()");
     arithmeticTest();
     std::puts("-> Passed arithmeticTest()");
+    moveTest();
+    std::puts("-> Passed moveTest()");
+    inPlaceTest();
+    std::puts("-> Passed inPlaceTest()");
+    expressionTest();
+    std::puts("-> Passed expressionTest()");
+    kernelTest();
+    std::puts("-> Passed kernelTest()");
+    viewTest();
+    std::puts("-> Passed viewTest()");
     identityTest();
     std::puts("-> Passed identityTest()");
 
@@ -0,0 +1,43 @@
+/**
+ * @file MatrixTestUtil.hh
+ * @author Martin
+ * @brief File containing the pseudo-random Matrix generator shared by the test cases
+*/
+#ifndef MATRIX_TEST_UTIL_H
+#define MATRIX_TEST_UTIL_H
+
+#include <cstdint>
+
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Namespace containing helpers of the Matrix test cases, reproducible for a given starting state */
+namespace MatrixTestUtil {
+
+    /** Advances the state of the linear congruential generator, returns the new state */
+    inline uint32_t nextRandom(uint32_t& state) {
+	state = state * 1103515245u + 12345u;
+	return state;
+    }
+
+    /** Returns a pseudo-random Rational Matrix, numerators up to maxNumerator with a random sign and denominators up to maxDenominator.
+      * Only about one in density entries is drawn, the others are zero, and for a density above one the drawn entries are never zero.
+      */
+    inline Matrix<Rational> randomMatrix(size_t cols, size_t rows, uint32_t& state, uint32_t maxNumerator = 8, uint32_t maxDenominator = 5, uint32_t density = 1) {
+	Matrix<Rational> m {cols, rows, 0};
+	for(size_t row = 0; row < rows; ++row) {
+	    for(size_t col = 0; col < cols; ++col) {
+		nextRandom(state);
+		if((state >> 20) % density != 0)
+		    continue;
+		uint32_t num = density > 1 ? ((state >> 16) % maxNumerator) + 1 : (state >> 16) % (maxNumerator + 1);
+		uint32_t den = ((state >> 8) % maxDenominator) + 1;
+		m.at(col, row) = Rational{num, den, ((state >> 4) & 1) != 0};
+	    }
+	}
+	return m;
+    }
+
+} /* namespace MatrixTestUtil */
+
+#endif /* MATRIX_TEST_UTIL_H */
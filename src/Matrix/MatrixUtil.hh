@@ -8,18 +8,38 @@
 
 #include <utility>
 #include <algorithm>
+#include <span>
+#include <vector>
+#include <type_traits>
+#include <stdexcept>
+#include <cmath>
 
 #include "Matrix.hh"
 
 /** Namespace containing Matrix Row Operation functions */
 namespace MatrixRowOps {
 
+    /** Substitutes a multiple of row2 from row1 (row1 -= multiple * row2), given as spans of equal length */
+    template <typename T>
+    void rowSub(std::span<T> row1, T multiple, std::type_identity_t<std::span<const T>> row2) {
+	if constexpr (std::is_arithmetic_v<T>) {
+	    /* Plain loop over contiguous memory, which the compiler can vectorize */
+	    for(size_t idx = 0; idx < row1.size(); ++idx) {
+		row1[idx] -= multiple * row2[idx];
+	    }
+	} else {
+	    /* Zero entries of row2 leave row1 unchanged, skipping them saves an expensive multiply and subtract */
+	    for(size_t idx = 0; idx < row1.size(); ++idx) {
+		if(row2[idx] != 0)
+		    row1[idx] -= multiple * row2[idx];
+	    }
+	}
+    }
+
     /** Substitutes a multiple of row2 from row1 (row1 -= multiple * row2) */
     template <typename T>
     void rowSub(Matrix<T>& m, size_t row1Idx, T multiple, size_t row2Idx) {
-	for(size_t idx = 0; idx < m.getCols(); ++idx) {
-	    m.at(idx, row1Idx) -= multiple * m.at(idx, row2Idx);
-	}
+	rowSub(m.rowSpan(row1Idx), multiple, m.rowSpan(row2Idx));
     }
 
     /** Substitutes row2 from row1 (row1 -= row2) */
@@ -27,29 +47,98 @@ namespace MatrixRowOps {
     void rowSub(Matrix<T>& m, size_t row1Idx, size_t row2Idx) {
 	rowSub(m, row1Idx, T{1}, row2Idx);
     }
+
+    /** Multiplies a row, given as a span, with the given element (row *= multiple) */
+    template <typename T>
+    void rowMul(std::span<T> row, T multiple) {
+	for(T& element : row) {
+	    element *= multiple;
+	}
+    }
     
     /** Multiplies a row with the given element (row *= multiple) */
     template <typename T>
     void rowMul(Matrix<T>& m, size_t rowIdx, T multiple) {
-	for(size_t idx = 0; idx < m.getCols(); ++idx) {
-	    m.at(idx, rowIdx) *= multiple;
+	rowMul(m.rowSpan(rowIdx), multiple);
+    }
+
+    /** Divides a row, given as a span, with the given element (row /= divisor) */
+    template <typename T>
+    void rowDiv(std::span<T> row, T divisor) {
+	for(T& element : row) {
+	    element /= divisor;
 	}
     }
     
     /** Divides a row with the given element (row /= divisor) */
     template <typename T>
     void rowDiv(Matrix<T>& m, size_t rowIdx, T divisor) {
-	for(size_t idx = 0; idx < m.getCols(); ++idx) {
-	    m.at(idx, rowIdx) /= divisor;
-	}
+	rowDiv(m.rowSpan(rowIdx), divisor);
     }
     
     /** Swaps row1 and row2 */
     template <typename T>
     void rowSwap(Matrix<T>& m, size_t row1Idx, size_t row2Idx) {
-         for(size_t idx = 0; idx < m.getCols(); ++idx) {
-	    std::swap(m.at(idx, row1Idx), m.at(idx, row2Idx));
-	}   
+	if(row1Idx == row2Idx)
+	    return;
+	std::span<T> row1 = m.rowSpan(row1Idx);
+	std::span<T> row2 = m.rowSpan(row2Idx);
+	std::swap_ranges(row1.begin(), row1.end(), row2.begin());
+    }
+
+    /** Substitutes a multiple of row2 from row1 (row1 -= multiple * row2) within a view, strided views are walked element by element */
+    template <typename T>
+    void rowSub(const MatrixView<T>& m, size_t row1Idx, T multiple, size_t row2Idx) {
+	if(m.isRowContiguous()) {
+	    rowSub(m.rowSpan(row1Idx), multiple, m.rowSpan(row2Idx));
+	    return;
+	}
+	if(row1Idx >= m.getRows() || row2Idx >= m.getRows())
+	    throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	for(size_t col = 0; col < m.getCols(); ++col) {
+	    if(m.atUnchecked(col, row2Idx) != 0)
+		m.atUnchecked(col, row1Idx) -= multiple * m.atUnchecked(col, row2Idx);
+	}
+    }
+
+    /** Multiplies a row of a view with the given element (row *= multiple) */
+    template <typename T>
+    void rowMul(const MatrixView<T>& m, size_t rowIdx, T multiple) {
+	if(m.isRowContiguous()) {
+	    rowMul(m.rowSpan(rowIdx), multiple);
+	    return;
+	}
+	if(rowIdx >= m.getRows())
+	    throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	for(size_t col = 0; col < m.getCols(); ++col) {
+	    m.atUnchecked(col, rowIdx) *= multiple;
+	}
+    }
+
+    /** Divides a row of a view with the given element (row /= divisor) */
+    template <typename T>
+    void rowDiv(const MatrixView<T>& m, size_t rowIdx, T divisor) {
+	if(m.isRowContiguous()) {
+	    rowDiv(m.rowSpan(rowIdx), divisor);
+	    return;
+	}
+	if(rowIdx >= m.getRows())
+	    throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	for(size_t col = 0; col < m.getCols(); ++col) {
+	    m.atUnchecked(col, rowIdx) /= divisor;
+	}
+    }
+
+    /** Swaps row1 and row2 of a view */
+    template <typename T>
+    void rowSwap(const MatrixView<T>& m, size_t row1Idx, size_t row2Idx) {
+	if(row1Idx >= m.getRows() || row2Idx >= m.getRows())
+	    throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	if(row1Idx == row2Idx)
+	    return;
+	for(size_t col = 0; col < m.getCols(); ++col) {
+	    std::swap(m.atUnchecked(col, row1Idx), m.atUnchecked(col, row2Idx));
+	}
     }
 
 } /* namespace MatrixRowOps */
@@ -58,22 +147,23 @@ namespace MatrixRowOps {
 /** Namespace containing Matrix Reduction functions */
 namespace MatrixReduce {
 
-    /** Checks whether a given Matrix is in Row Echelon Form */
+    /** Checks whether a given Matrix view is in Row Echelon Form */
     template <typename T>
-    bool isREF(Matrix<T>& m, bool reduced = false) {
+    bool isREF(MatrixView<T> m, bool reduced = false) {
+	/* Loop bounds keep all accesses inside the Matrix, so the unchecked accessor is used */
 	/* Current considered top of each next column, moves downwards as the function progresses through the columns */
 	size_t top = 0;
 	/* Go through the Matrix column by column, checking the next top element */
 	for(size_t col = 0; (col < m.getCols() && top < m.getRows()); ++col) {
 	    /* The allowed values for any current column top are 1 or 0 */
-	    if(m.at(col, top) != 1 && m.at(col, top) != 0)
+	    if(m.atUnchecked(col, top) != 1 && m.atUnchecked(col, top) != 0)
 		return false;
 	    /* If the top value is 1, move the top downwards for the next column, and check the entire column if RREF */
-	    if(m.at(col, top) == 1) {
+	    if(m.atUnchecked(col, top) == 1) {
 		/* If validating RREF, the entire column with a leading one must be 0 */
 		if(reduced) {
 		    for(size_t row = 0; row < top; ++row) {
-			if(m.at(col, row) != 0)
+			if(m.atUnchecked(col, row) != 0)
 			    return false;
 		    }
 		}
@@ -81,7 +171,7 @@ namespace MatrixReduce {
 	    }
 	    /* Go through the rest of the column and ensure everything under the pivot/top is zero */
 	    for(size_t row = top; row < m.getRows(); ++row) {
-		if(m.at(col, row) != 0)
+		if(m.atUnchecked(col, row) != 0)
 		    return false;
 	    }
 	}
@@ -89,83 +179,73 @@ namespace MatrixReduce {
         return true;
     }
 
+    /** Checks whether a given Matrix is in Row Echelon Form */
+    template <typename T>
+    bool isREF(Matrix<T>& m, bool reduced = false) {
+	return isREF(m.view(), reduced);
+    }
+
+    /** Checks whether a given Matrix view is in Reduced Row Echelon Form */
+    template <typename T>
+    bool isRREF(MatrixView<T> m) {
+	return isREF(m, true);
+    }
+
     /** Checks whether a given Matrix is in Reduced Row Echelon Form */
     template <typename T>
     bool isRREF(Matrix<T>& m) {
-	return isREF(m, true);
+	return isREF(m.view(), true);
     }
 
-    /** Reduces a Matrix to Row Echelon Form (REF) */
+    /** Reduces a Matrix view to Row Echelon Form (REF), in place in the viewed data */
     template <typename T>
-    bool toREF(Matrix<T>& m) {
+    bool toREF(MatrixView<T> m) {
 	/* Check that the Matrix isn't already in REF, return immediately if it is */
 	if(isREF(m))
 	    return true;
-	/* The column for which the algorithm is currently trying to set a pivot (leading zeros and a one) */
-	size_t currentCol = 0;
-	/* The number of pivots in the echelon that were skipped, to ensure rows swapped into the correct place */
-	size_t skippedPivots = 0;
-	/* The real column of the pivots at any current column, with -1 (unsigned overflow - max size_t number) implying there's no such pivot */
-	size_t pivots [m.getCols()];
-	std::fill_n(pivots, m.getCols(), -1);
-	/* Iterating through the Matrix until we get to the bottom row with the last pivot or until we run out of columns */
-	while((currentCol - skippedPivots) < m.getRows() && currentCol < m.getCols()) {
-
-	    /* First, try to subtract previous pivots (where they exist) to clear leading numbers where non-zero */
-	    for(size_t colIdx = 0; colIdx < currentCol; ++colIdx) {
-		if(m.at(colIdx, currentCol - skippedPivots) != 0 && pivots[colIdx] != static_cast<size_t>(-1)) {
-		    T scale = m.at(colIdx, currentCol - skippedPivots);
-		    MatrixRowOps::rowSub(m, currentCol - skippedPivots, scale, pivots[colIdx]);
-		}
-	    }
-
+	/* The row the next pivot is placed in */
+	size_t currentRow = 0;
+	/* Go through the columns, placing a pivot in each one that has a non-zero entry at or below the current row */
+	for(size_t currentCol = 0; currentCol < m.getCols() && currentRow < m.getRows(); ++currentCol) {
 	    /* Find next row with a non-zero scalar at the current column to continue the diagonal */
-	    size_t rowIdx;
-	    for(rowIdx = (currentCol - skippedPivots); rowIdx < m.getRows(); ++rowIdx) {
-		/* End loop at first non-zero column index to keep the rowIdx we want */
-		if(m.at(currentCol, rowIdx) != 0)
-		    break;
+	    size_t rowIdx = currentRow;
+	    while(rowIdx < m.getRows() && m.atUnchecked(currentCol, rowIdx) == 0) {
+		++rowIdx;
 	    }
-	    /* If no row with a scalar at the current column found, move to the next column and indicate pivot was skipped */
-	    if(rowIdx == m.getRows()) {
-		++currentCol;
-	        ++skippedPivots;
+	    /* If no row with a scalar at the current column found, the column gets no pivot */
+	    if(rowIdx == m.getRows())
 		continue;
-	    }
-
-	    /* If finding next row with available non-zero pivot introduced any leading numbers, subtract them as well */
-	    for(size_t colIdx = 0; colIdx < currentCol; ++colIdx) {
-		if(m.at(colIdx, rowIdx) != 0 && pivots[colIdx] != static_cast<size_t>(-1)) {
-		    T scale = m.at(colIdx, rowIdx);
-		    MatrixRowOps::rowSub(m, rowIdx, scale, pivots[colIdx]);
-		}
-	    }
-
 	    /* Swap the row into the correct position if not already correct */
-	    if((rowIdx + skippedPivots) != currentCol) {
-		MatrixRowOps::rowSwap(m, rowIdx, currentCol);
-		/* Set the row index to the row we swapped to for convenience */
-		rowIdx = currentCol;
-	    }
+	    MatrixRowOps::rowSwap(m, rowIdx, currentRow);
 
+	    /* Every row from the current one down is zero left of the current column, so row operations start there */
+	    MatrixView<T> right = m.subView(currentCol, 0, m.getCols() - currentCol, m.getRows());
 	    /* Reduce row diagonal to 1 */
-	    T divisor = m.at(currentCol, rowIdx);
+	    T divisor = m.atUnchecked(currentCol, currentRow);
 	    if(divisor != 1)
-		MatrixRowOps::rowDiv(m, rowIdx, divisor);
-
-	    /* Record real row location of pivot for the current column */
-	    pivots[currentCol] = (currentCol - skippedPivots);
-
-	    /* Move to the next column */
-	    ++currentCol;
+		MatrixRowOps::rowDiv(right, currentRow, divisor);
+	    /* Clear the current column in all rows below the pivot */
+	    for(size_t row = currentRow + 1; row < m.getRows(); ++row) {
+		if(m.atUnchecked(currentCol, row) != 0) {
+		    T scale = m.atUnchecked(currentCol, row);
+		    MatrixRowOps::rowSub(right, row, scale, currentRow);
+		}
+	    }
+	    ++currentRow;
 	}
 	/* Once the loop is done, the Matrix should be in REF, return only after a validity check to be sure */
 	return isREF(m);
     }
 
-    /** Reduces a Matrix that is in REF to Reduced Row Echelon Form (RREF), returns false if incorrect Matrix given */
+    /** Reduces a Matrix to Row Echelon Form (REF) */
     template <typename T>
-    bool REFtoRREF(Matrix<T>& m) {
+    bool toREF(Matrix<T>& m) {
+	return toREF(m.view());
+    }
+
+    /** Reduces a Matrix view that is in REF to Reduced Row Echelon Form (RREF), returns false if incorrect Matrix given */
+    template <typename T>
+    bool REFtoRREF(MatrixView<T> m) {
 	/* Don't proceed if input not in REF */
 	if(!isREF(m))
 	    return false;
@@ -174,14 +254,16 @@ namespace MatrixReduce {
 	/* Go through each column and reduce zeros above the pivot, if any found */
 	for(size_t col = 0; (col < m.getCols() && pivot < m.getRows()); ++col) {
 	    /* Skip column if pivot is zero */
-	    if(m.at(col, pivot) == 0)
+	    if(m.atUnchecked(col, pivot) == 0)
 		continue;
 	    /* If the pivot is one, go through all leading row values and subtract */
-	    if(m.at(col, pivot) == 1) {
+	    if(m.atUnchecked(col, pivot) == 1) {
+		/* In REF the pivot row is zero left of the pivot, so only the columns from the pivot onwards change */
+		MatrixView<T> right = m.subView(col, 0, m.getCols() - col, m.getRows());
 		for(size_t rowIdx = 0; rowIdx < pivot; ++rowIdx) {
-		    if(m.at(col, rowIdx) != 0) {
-			T scale = m.at(col, rowIdx);
-			MatrixRowOps::rowSub(m, rowIdx, scale, pivot);
+		    if(m.atUnchecked(col, rowIdx) != 0) {
+			T scale = m.atUnchecked(col, rowIdx);
+			MatrixRowOps::rowSub(right, rowIdx, scale, pivot);
 		    }
 		}
 		++pivot;
@@ -194,9 +276,15 @@ namespace MatrixReduce {
 	return isRREF(m);
     }
 
-    /** Reduces a Matrix to Reduced Row Echelon Form (RREF) */
+    /** Reduces a Matrix that is in REF to Reduced Row Echelon Form (RREF), returns false if incorrect Matrix given */
     template <typename T>
-    bool toRREF(Matrix<T>& m) {
+    bool REFtoRREF(Matrix<T>& m) {
+	return REFtoRREF(m.view());
+    }
+
+    /** Reduces a Matrix view to Reduced Row Echelon Form (RREF), in place in the viewed data */
+    template <typename T>
+    bool toRREF(MatrixView<T> m) {
 	/* Return immediately if Matrix in RREF already */
 	if(isRREF(m))
 	    return true;
@@ -210,38 +298,59 @@ namespace MatrixReduce {
 	return true;
     }
 
-    /** Inverts the given matrix, returns whether successful or not */
+    /** Reduces a Matrix to Reduced Row Echelon Form (RREF) */
+    template <typename T>
+    bool toRREF(Matrix<T>& m) {
+	return toRREF(m.view());
+    }
+
+    /** Inverts the given matrix in place by Gauss-Jordan elimination, returns whether successful or not.
+      * Works within the storage of m and a vector of row swaps, if m is singular it is left partially reduced.
+      */
     template <typename T>
     bool invert(Matrix<T>& m) {
 	/* Check that the matrix is square before attempting inverse */
 	if(m.getCols() != m.getRows())
 	    return false;
-	/* Create the augmented Matrix to use for the inversion, twice the columns of m */
-	Matrix<T> augmented {2 * m.getCols(), m.getRows(), 0};
-	/* Populate the augmented Matrix */
-	for(size_t row = 0; row < augmented.getRows(); ++row) {
-	    /* Copying over left half */
-	    for(size_t col = 0; col < m.getCols(); ++col) {
-		augmented.at(col, row) = m.at(col, row);
+	size_t n = m.getCols();
+	/* The row swapped into each pivot position, used to undo the swaps on the columns of the inverse */
+	std::vector<size_t> swaps (n);
+	for(size_t col = 0; col < n; ++col) {
+	    /* Find the pivot row, the largest magnitude for floating point types and the first non-zero entry otherwise */
+	    size_t pivotRow = col;
+	    if constexpr (std::is_floating_point_v<T>) {
+		for(size_t row = col + 1; row < n; ++row) {
+		    if(std::abs(m.atUnchecked(col, row)) > std::abs(m.atUnchecked(col, pivotRow)))
+			pivotRow = row;
+		}
+	    } else {
+		while(pivotRow < n && m.atUnchecked(col, pivotRow) == 0) {
+		    ++pivotRow;
+		}
 	    }
-	    /* Setting the correct pivot one in the right half */
-	    augmented.at(m.getCols() + row, row) = 1;
-	}
-	/* Reduce to RREF */
-	if(!toRREF(augmented))
-	    return false;
-	/* Check that the left is the identity matrix */
-	for(size_t row = 0; row < m.getRows(); ++row) {
-	    for(size_t col = 0; col < m.getCols(); ++col) {
-		if(augmented.at(col, row) != (row == col ? 1 : 0))
-		    return false;
+	    /* A column without a pivot proves the matrix singular, there is no need to finish the reduction */
+	    if(pivotRow == n || m.atUnchecked(col, pivotRow) == 0)
+		return false;
+	    MatrixRowOps::rowSwap(m, pivotRow, col);
+	    swaps[col] = pivotRow;
+
+	    /* The pivot column of the reduced matrix is known, so its storage holds the matching column of the inverse instead */
+	    std::span<T> pivot = m.rowSpan(col);
+	    T divisor = pivot[col];
+	    pivot[col] = T{1};
+	    MatrixRowOps::rowDiv(pivot, divisor);
+	    for(size_t row = 0; row < n; ++row) {
+		if(row == col || m.atUnchecked(col, row) == 0)
+		    continue;
+		T scale = m.atUnchecked(col, row);
+		m.atUnchecked(col, row) = T{0};
+		MatrixRowOps::rowSub(m.rowSpan(row), scale, pivot);
 	    }
 	}
-	/* The left is the identity, overwrite m with the right half and return true */
-	for(size_t row = 0; row < m.getRows(); ++row) {
-	    for(size_t col = 0; col < m.getCols(); ++col) {
-		m.at(col, row) = augmented.at(m.getCols() + col, row);
-	    }
+	/* Row swaps of the input are column swaps of the inverse, undo them in reverse order */
+	for(size_t col = n; col-- > 0;) {
+	    if(swaps[col] != col)
+		MatrixRowOps::rowSwap(m.transposed(), swaps[col], col);
 	}
 	return true;
     }
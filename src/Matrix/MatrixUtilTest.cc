@@ -17,6 +17,11 @@ void rowSubTest(void) {
 
     MatrixRowOps::rowSub(m, 2, Rational{2}, 1);
     assert(m.at(0, 2) == 0 && m.at(1, 2) == 0 && m.at(2, 2) == 0 && m.at(3, 2) == 0);
+
+    /* Span overload on parts of rows */
+    Matrix<double> d {{1.0, 2.0, 3.0, 4.0}, {1.0, 1.0, 1.0, 1.0}};
+    MatrixRowOps::rowSub(d.rowSpan(0).subspan(2), 2.0, d.rowSpan(1).subspan(2));
+    assert(d.at(0, 0) == 1.0 && d.at(1, 0) == 2.0 && d.at(2, 0) == 1.0 && d.at(3, 0) == 2.0);
 }
 
 void rowMulDivTest(void) {
@@ -104,6 +109,16 @@ void matrixReduceTest(void) {
     assert(MatrixReduce::toREF(m5));
     assert(MatrixReduce::isREF(m5));
 
+    /* Pivot found below the current row after a skipped column */
+    Matrix<Rational> m11 = {{0, 0}, {0, 0}, {0, 1}};
+    assert(MatrixReduce::toREF(m11));
+    assert(m11.at(1, 0) == 1 && m11.at(1, 2) == 0);
+
+    /* A row that cancels to zero after its leading entry is cleared gets no pivot */
+    Matrix<Rational> m12 = {{1, 1}, {0, 0}, {1, 1}};
+    assert(MatrixReduce::toREF(m12));
+    assert(m12 == (Matrix<Rational>{{1, 1}, {0, 0}, {0, 0}}));
+
     std::puts(" -> matrixReduceTest(): Passed REF TC");
 
     /* --- REF->RREF TC --- */
@@ -190,6 +205,47 @@ void matrixInvertTest(void) {
     assert(m5 == r5);
 
     assert(!MatrixReduce::invert(m6));
+
+    /* Zero pivots need row swaps, which permute the columns of the inverse */
+    Matrix<Rational> m7 {{0, 1, 2}, {1, 0, 3}, {4, -3, 8}};
+    assert(MatrixReduce::invert(m7));
+    Matrix<Rational> r7 {{"-9/2", 7, "-3/2"}, {-2, 4, -1}, {"3/2", -2, "1/2"}};
+    assert(m7 == r7);
+
+    /* Floating point inversion picks the largest pivot */
+    Matrix<double> m8 {{1.0, 2.0}, {4.0, 4.0}};
+    assert(MatrixReduce::invert(m8));
+    Matrix<double> r8 {{-1.0, 0.5}, {1.0, -0.25}};
+    assert(m8 == r8);
+
+    /* A zero column is singular */
+    Matrix<double> m9 {{0.0, 1.0}, {0.0, 2.0}};
+    assert(!MatrixReduce::invert(m9));
+}
+
+void viewReduceTest(void) {
+
+    /* Row operations on a strided view act on the columns of the Matrix */
+    Matrix<Rational> m {{1, 2, 3}, {4, 5, 6}};
+    MatrixView<Rational> t = m.transposed();
+    MatrixRowOps::rowSub(t, 2, Rational{1}, 0);
+    MatrixRowOps::rowMul(t, 1, Rational{2});
+    MatrixRowOps::rowSwap(t, 0, 1);
+    Matrix<Rational> r1 {{4, 1, 2}, {10, 4, 2}};
+    assert(m == r1);
+
+    /* Reducing the left block of a Matrix leaves the rest untouched */
+    Matrix<Rational> a {{2, 4, 7}, {1, 3, 8}};
+    assert(MatrixReduce::toRREF(a.subView(0, 0, 2, 2)));
+    Matrix<Rational> r2 {{1, 0, 7}, {0, 1, 8}};
+    assert(a == r2);
+
+    /* Reducing a transposed view */
+    Matrix<Rational> b {{0, 1}, {2, 2}, {4, 3}};
+    assert(MatrixReduce::toRREF(b.transposed()));
+    assert(MatrixReduce::isRREF(b.transposed()));
+    Matrix<Rational> r3 {{1, 0}, {0, 1}, {-1, 2}};
+    assert(b == r3);
 }
 
 } /* anonymous */
@@ -213,5 +269,7 @@ void matrixUtilTest(void) {
     std::puts("-> Passed matrixReduceTest()");
     matrixInvertTest();
     std::puts("-> Passed matrixInvertTest()");
+    viewReduceTest();
+    std::puts("-> Passed viewReduceTest()");
     std::puts("--- MatrixUtil MatrixReduce Tests Passed ---");
 }
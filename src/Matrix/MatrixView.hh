@@ -0,0 +1,203 @@
+/**
+ * @file MatrixView.hh
+ * @author Martin
+ * @brief File containing the class representing a non-owning, strided view of Matrix data
+*/
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Matrix.hh"
+
+/** Non-owning view of an N by M block of Matrix data, addressed through a row stride and a column stride.
+  * Submatrices, single rows and columns and transposes of a Matrix are all views of its data, without copying.
+  * A view can be read as an element-wise expression, and assigned to, writing through to the viewed Matrix.
+  */
+template <typename T>
+class MatrixView : public MatrixExprTag {
+
+    private:
+	/** Pointer to the element at (0, 0) of the view */
+	T* m_data;
+	/** The number of columns in the view (width) */
+	size_t m_cols;
+	/** The number of rows in the view (height) */
+	size_t m_rows;
+	/** Distance between two vertically adjacent elements */
+	size_t m_rowStride;
+	/** Distance between two horizontally adjacent elements */
+	size_t m_colStride;
+
+	/** Validates that a block of the given shape at the given position lies inside the view */
+	void checkBlock(size_t column, size_t row, size_t columns, size_t rows) const {
+	    if(column + columns > m_cols || row + rows > m_rows || column + columns < column || row + rows < row)
+		throw std::runtime_error {"Matrix Error: View out of bounds!"};
+	}
+
+	/** Whether the given type is a view of the same element type */
+	template <typename E>
+	static constexpr bool isViewOf = std::is_same_v<E, MatrixView<std::remove_const_t<T>>> || std::is_same_v<E, MatrixView<const std::remove_const_t<T>>>;
+
+    public:
+	/** The type of the elements, used by the expression templates */
+	using value_type = std::remove_const_t<T>;
+
+	/** Constructor, creates a view of (columns x rows) elements starting at data, with the given strides */
+	MatrixView(T* data, size_t columns, size_t rows, size_t rowStride, size_t colStride)
+	    : m_data{data}, m_cols{columns}, m_rows{rows}, m_rowStride{rowStride}, m_colStride{colStride} {}
+
+	/** Conversion from a mutable view to a read-only view */
+	template <typename U> requires std::is_same_v<const U, T>
+	MatrixView(const MatrixView<U>& other)
+	    : m_data{other.data()}, m_cols{other.getCols()}, m_rows{other.getRows()}, m_rowStride{other.getRowStride()}, m_colStride{other.getColStride()} {}
+
+	size_t getRows(void) const {
+	    return m_rows;
+	}
+
+	size_t getCols(void) const {
+	    return m_cols;
+	}
+
+	size_t getRowStride(void) const {
+	    return m_rowStride;
+	}
+
+	size_t getColStride(void) const {
+	    return m_colStride;
+	}
+
+	/** Returns a pointer to the element at (0, 0) */
+	T* data(void) const {
+	    return m_data;
+	}
+
+	/** Whether the elements of each row are contiguous in memory */
+	bool isRowContiguous(void) const {
+	    return m_colStride == 1 || m_cols <= 1;
+	}
+
+	T& at(size_t column, size_t row) const {
+	    if(column >= m_cols || row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    return m_data[(row * m_rowStride) + (column * m_colStride)];
+	}
+
+	/** Element access without the bounds check, the caller guarantees that (column, row) lies inside the view */
+	T& atUnchecked(size_t column, size_t row) const {
+	    return m_data[(row * m_rowStride) + (column * m_colStride)];
+	}
+
+	/** Returns the given row as a contiguous span, only possible for views with contiguous rows */
+	std::span<T> rowSpan(size_t row) const {
+	    if(row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    if(!isRowContiguous())
+		throw std::runtime_error {"Matrix Error: View rows are not contiguous!"};
+	    return {m_data + (row * m_rowStride), m_cols};
+	}
+
+	/** Element of the view at a flat row-major index, used when the view is evaluated as an expression */
+	const T& operator[](size_t idx) const {
+	    if(isRowContiguous())
+		return m_data[((idx / m_cols) * m_rowStride) + (idx % m_cols)];
+	    return m_data[((idx / m_cols) * m_rowStride) + ((idx % m_cols) * m_colStride)];
+	}
+
+	/** Memory layout of the view, for alias detection in expressions */
+	MatrixLayout layout(void) const {
+	    return MatrixLayout::of(m_data, m_cols, m_rows, m_rowStride, m_colStride);
+	}
+
+	/** Whether reading this view while assigning to the given target reads elements the target overwrites at other positions */
+	bool conflicts(const MatrixLayout& target) const {
+	    return target.conflicts(layout());
+	}
+
+	/* --- Sub-views --- */
+
+	/** Returns a view of the (columns x rows) block starting at (column, row) */
+	MatrixView<T> subView(size_t column, size_t row, size_t columns, size_t rows) const {
+	    checkBlock(column, row, columns, rows);
+	    return {m_data + (row * m_rowStride) + (column * m_colStride), columns, rows, m_rowStride, m_colStride};
+	}
+
+	/** Returns a (1 x rows) view of the given row */
+	MatrixView<T> rowView(size_t row) const {
+	    return subView(0, row, m_cols, 1);
+	}
+
+	/** Returns an (columns x 1) view of the given column */
+	MatrixView<T> colView(size_t column) const {
+	    return subView(column, 0, 1, m_rows);
+	}
+
+	/** Returns the transpose of this view, by swapping the shape and the strides */
+	MatrixView<T> transposed(void) const {
+	    return {m_data, m_rows, m_cols, m_colStride, m_rowStride};
+	}
+
+	/* --- Assignment --- */
+
+	/** Writes a Matrix, view or element-wise expression of the same shape into the viewed elements */
+	template <typename E> requires (std::is_base_of_v<MatrixExprTag, E> || std::is_same_v<E, Matrix<value_type>>)
+	const MatrixView& assign(const E& expr) const {
+	    if(m_rows != expr.getRows() || m_cols != expr.getCols())
+		throw std::runtime_error {"Matrix Error: Can't assign to a view of different dimensions"};
+	    if constexpr (std::is_same_v<E, Matrix<value_type>>) {
+		assign(expr.view());
+	    } else if(expr.conflicts(layout())) {
+		/* The expression reads elements this assignment overwrites at other positions, evaluate it first */
+		assign(Matrix<value_type>{expr});
+	    } else {
+		if constexpr (isViewOf<E>) {
+		    if(isRowContiguous() && expr.isRowContiguous() && m_cols > 0) {
+			/* Row by row copy between contiguous rows, a memcpy per row for trivially copyable types */
+			for(size_t row = 0; row < m_rows; ++row) {
+			    const value_type* source = &expr.atUnchecked(0, row);
+			    if(source != &atUnchecked(0, row))
+				Matrix<value_type>::copyElements(source, m_cols, &atUnchecked(0, row));
+			}
+			return *this;
+		    }
+		}
+		for(size_t row = 0; row < m_rows; ++row) {
+		    for(size_t col = 0; col < m_cols; ++col) {
+			atUnchecked(col, row) = expr[(row * m_cols) + col];
+		    }
+		}
+	    }
+	    return *this;
+	}
+
+	/** Sets every viewed element to the given value */
+	const MatrixView& fill(const value_type& value) const {
+	    for(size_t row = 0; row < m_rows; ++row) {
+		for(size_t col = 0; col < m_cols; ++col) {
+		    atUnchecked(col, row) = value;
+		}
+	    }
+	    return *this;
+	}
+
+	friend bool operator==(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+	    if(lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols())
+		return false;
+	    for(size_t row = 0; row < lhs.getRows(); ++row) {
+		for(size_t col = 0; col < lhs.getCols(); ++col) {
+		    if(lhs.atUnchecked(col, row) != rhs.atUnchecked(col, row))
+			return false;
+		}
+	    }
+	    return true;
+	}
+
+	friend bool operator!=(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+	    return !(lhs == rhs);
+	}
+};
+
+#endif /* MATRIX_VIEW_H */
@@ -0,0 +1,737 @@
+/**
+ * @file SparseMatrix.hh
+ * @author Martin
+ * @brief File containing the compressed sparse row Matrix, its row operations, and sparse elimination with Markowitz pivoting
+*/
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <utility>
+
+#include "Matrix.hh"
+#include "MatrixView.hh"
+#include "MatrixUtil.hh"
+
+/** Number of rows and columns examined for a pivot after a first candidate was found, more give less fill-in but a slower search */
+#define SPARSE_MARKOWITZ_SEARCH 4
+/** Fraction of the largest magnitude in its row a floating point pivot must reach, trading stability against fill-in */
+#define SPARSE_PIVOT_THRESHOLD 0.1
+
+/** Sparse vector, the indices of its non-zero entries in increasing order and their values */
+template <typename T>
+struct SparseVector {
+    std::vector<size_t> indices;
+    std::vector<T> values;
+
+    size_t size(void) const {
+	return indices.size();
+    }
+
+    bool empty(void) const {
+	return indices.empty();
+    }
+
+    void clear(void) {
+	indices.clear();
+	values.clear();
+    }
+
+    void push(size_t index, T value) {
+	indices.push_back(index);
+	values.push_back(std::move(value));
+    }
+
+    /** Returns the position of the entry at the given index, or size() if that entry is zero */
+    size_t find(size_t index) const {
+	auto it = std::lower_bound(indices.begin(), indices.end(), index);
+	return (it != indices.end() && *it == index) ? static_cast<size_t>(it - indices.begin()) : size();
+    }
+
+    /** Removes the entry at the given position */
+    void erase(size_t position) {
+	indices.erase(indices.begin() + static_cast<std::ptrdiff_t>(position));
+	values.erase(values.begin() + static_cast<std::ptrdiff_t>(position));
+    }
+};
+
+/** Sparse Matrix in compressed sparse row (CSR) format, storing only the non-zero elements.
+  * The column indices and values of all rows lie back to back, sorted by column within each row, and the row
+  * starts index into them. Memory use and the row operations scale with the number of non-zeros, not with (rows x columns).
+  */
+template <typename T>
+class SparseMatrix {
+
+    private:
+	size_t m_cols = 0;
+	size_t m_rows = 0;
+	/** The position of the first entry of each row in m_colIndices and m_values, followed by the number of entries */
+	std::vector<size_t> m_rowStart {0};
+	/** The column of each entry */
+	std::vector<size_t> m_colIndices;
+	/** The value of each entry */
+	std::vector<T> m_values;
+
+    public:
+	/** Constructor, creates an empty matrix */
+	SparseMatrix(void) = default;
+
+	/** Constructor, creates a zero matrix of shape (columns x rows) */
+	SparseMatrix(size_t columns, size_t rows) : m_cols{columns}, m_rows{rows}, m_rowStart(rows + 1, 0) {}
+
+	/** Constructor, copies the non-zero elements of a dense Matrix view */
+	explicit SparseMatrix(MatrixView<const T> m) : m_cols{m.getCols()}, m_rows{m.getRows()} {
+	    m_rowStart.reserve(m_rows + 1);
+	    for(size_t row = 0; row < m_rows; ++row) {
+		for(size_t col = 0; col < m_cols; ++col) {
+		    const T& value = m.atUnchecked(col, row);
+		    if(value != T{0}) {
+			m_colIndices.push_back(col);
+			m_values.push_back(value);
+		    }
+		}
+		m_rowStart.push_back(m_values.size());
+	    }
+	}
+
+	/** Constructor, copies the non-zero elements of a dense Matrix */
+	explicit SparseMatrix(const Matrix<T>& m) : SparseMatrix{m.view()} {}
+
+	/** Returns the Matrix of shape (columns x rows) with the given (row, column, value) triplets, as in a coordinate list.
+	  * Triplets can come in any order, values at the same position are summed up, and zeros are dropped.
+	  */
+	static SparseMatrix fromTriplets(size_t columns, size_t rows, std::span<const size_t> rowIndices, std::span<const size_t> colIndices, std::span<const T> values) {
+	    if(rowIndices.size() != values.size() || colIndices.size() != values.size())
+		throw std::runtime_error {"Matrix Error: Triplets of different lengths"};
+	    /* Counting sort by row, then each row is sorted by column */
+	    SparseMatrix result {columns, rows};
+	    for(size_t idx = 0; idx < values.size(); ++idx) {
+		if(rowIndices[idx] >= rows || colIndices[idx] >= columns)
+		    throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+		++result.m_rowStart[rowIndices[idx] + 1];
+	    }
+	    std::partial_sum(result.m_rowStart.begin(), result.m_rowStart.end(), result.m_rowStart.begin());
+	    std::vector<size_t> next (result.m_rowStart.begin(), result.m_rowStart.end() - 1);
+	    std::vector<size_t> order (values.size());
+	    for(size_t idx = 0; idx < values.size(); ++idx) {
+		order[next[rowIndices[idx]]++] = idx;
+	    }
+	    std::vector<size_t> rowStart {0};
+	    rowStart.reserve(rows + 1);
+	    for(size_t row = 0; row < rows; ++row) {
+		auto first = order.begin() + static_cast<std::ptrdiff_t>(result.m_rowStart[row]);
+		auto last = order.begin() + static_cast<std::ptrdiff_t>(result.m_rowStart[row + 1]);
+		std::stable_sort(first, last, [&colIndices](size_t a, size_t b) { return colIndices[a] < colIndices[b]; });
+		for(auto it = first; it != last;) {
+		    size_t col = colIndices[*it];
+		    T sum = values[*it];
+		    for(++it; it != last && colIndices[*it] == col; ++it) {
+			sum += values[*it];
+		    }
+		    if(sum != T{0}) {
+			result.m_colIndices.push_back(col);
+			result.m_values.push_back(std::move(sum));
+		    }
+		}
+		rowStart.push_back(result.m_values.size());
+	    }
+	    result.m_rowStart = std::move(rowStart);
+	    return result;
+	}
+
+	/** Returns the Matrix of the given number of columns with the given rows, which are moved from */
+	static SparseMatrix fromRows(size_t columns, std::vector<SparseVector<T>>& rows) {
+	    SparseMatrix result {columns, rows.size()};
+	    size_t entries = 0;
+	    for(const SparseVector<T>& row : rows) {
+		entries += row.size();
+	    }
+	    result.m_colIndices.reserve(entries);
+	    result.m_values.reserve(entries);
+	    for(size_t row = 0; row < rows.size(); ++row) {
+		result.m_colIndices.insert(result.m_colIndices.end(), rows[row].indices.begin(), rows[row].indices.end());
+		std::move(rows[row].values.begin(), rows[row].values.end(), std::back_inserter(result.m_values));
+		result.m_rowStart[row + 1] = result.m_values.size();
+	    }
+	    return result;
+	}
+
+	/** Returns the rows as sparse vectors */
+	std::vector<SparseVector<T>> toRows(void) const {
+	    std::vector<SparseVector<T>> rows (m_rows);
+	    for(size_t row = 0; row < m_rows; ++row) {
+		rows[row].indices.assign(rowColumns(row).begin(), rowColumns(row).end());
+		rows[row].values.assign(rowValues(row).begin(), rowValues(row).end());
+	    }
+	    return rows;
+	}
+
+	/** Returns the dense copy of the Matrix */
+	Matrix<T> toDense(void) const {
+	    Matrix<T> result {m_cols, m_rows, T{0}};
+	    for(size_t row = 0; row < m_rows; ++row) {
+		for(size_t idx = m_rowStart[row]; idx < m_rowStart[row + 1]; ++idx) {
+		    result.atUnchecked(m_colIndices[idx], row) = m_values[idx];
+		}
+	    }
+	    return result;
+	}
+
+	size_t getRows(void) const {
+	    return m_rows;
+	}
+
+	size_t getCols(void) const {
+	    return m_cols;
+	}
+
+	/** Returns the number of stored (non-zero) elements */
+	size_t getNonZeros(void) const {
+	    return m_values.size();
+	}
+
+	/** Returns the element at (column, row), zero if it isn't stored */
+	T at(size_t column, size_t row) const {
+	    if(column >= m_cols || row >= m_rows)
+		throw std::runtime_error {"Matrix Error: Index out of bounds!"};
+	    std::span<const size_t> cols = rowColumns(row);
+	    auto it = std::lower_bound(cols.begin(), cols.end(), column);
+	    return (it != cols.end() && *it == column) ? m_values[m_rowStart[row] + static_cast<size_t>(it - cols.begin())] : T{0};
+	}
+
+	/** Returns the columns of the stored elements of a row, in increasing order */
+	std::span<const size_t> rowColumns(size_t row) const {
+	    return {m_colIndices.data() + m_rowStart[row], m_rowStart[row + 1] - m_rowStart[row]};
+	}
+
+	/** Returns the values of the stored elements of a row, in the order of rowColumns */
+	std::span<const T> rowValues(size_t row) const {
+	    return {m_values.data() + m_rowStart[row], m_rowStart[row + 1] - m_rowStart[row]};
+	}
+
+	/** Returns the product of this Matrix and a dense Matrix, touching only the stored elements */
+	Matrix<T> operator*(const Matrix<T>& rhs) const {
+	    if(m_cols != rhs.getRows())
+		throw std::runtime_error {"Matrix Error: Can't multiply matrices of incompatible dimensions"};
+	    Matrix<T> result {rhs.getCols(), m_rows, T{0}};
+	    for(size_t row = 0; row < m_rows; ++row) {
+		for(size_t idx = m_rowStart[row]; idx < m_rowStart[row + 1]; ++idx) {
+		    MatrixRowOps::rowSub(result.rowSpan(row), T{0} - m_values[idx], rhs.rowSpan(m_colIndices[idx]));
+		}
+	    }
+	    return result;
+	}
+
+	friend bool operator==(const SparseMatrix& lhs, const SparseMatrix& rhs) = default;
+};
+
+
+/** Namespace containing basic Matrix row operations */
+namespace MatrixRowOps {
+
+    /** Substitutes a multiple of a sparse row from another (row1 -= multiple * row2), by merging their entries through scratch.
+      * Entries that cancel out are removed. onChange(index, 1) is called for each new entry and onChange(index, -1) for each removed one.
+      */
+    template <typename T, typename F>
+    void rowSub(SparseVector<T>& row1, const T& multiple, const SparseVector<T>& row2, SparseVector<T>& scratch, const F& onChange) {
+	scratch.clear();
+	scratch.indices.reserve(row1.size() + row2.size());
+	scratch.values.reserve(row1.size() + row2.size());
+	size_t idx1 = 0, idx2 = 0;
+	while(idx1 < row1.size() || idx2 < row2.size()) {
+	    if(idx2 == row2.size() || (idx1 < row1.size() && row1.indices[idx1] < row2.indices[idx2])) {
+		scratch.push(row1.indices[idx1], std::move(row1.values[idx1]));
+		++idx1;
+	    } else if(idx1 == row1.size() || row2.indices[idx2] < row1.indices[idx1]) {
+		/* Fill-in, an entry zero in row1 */
+		scratch.push(row2.indices[idx2], T{0} - multiple * row2.values[idx2]);
+		onChange(row2.indices[idx2], 1);
+		++idx2;
+	    } else {
+		T value = row1.values[idx1] - multiple * row2.values[idx2];
+		if(value != T{0})
+		    scratch.push(row1.indices[idx1], std::move(value));
+		else
+		    onChange(row1.indices[idx1], -1);
+		++idx1;
+		++idx2;
+	    }
+	}
+	std::swap(row1, scratch);
+    }
+
+    /** Substitutes a multiple of a sparse row from another (row1 -= multiple * row2) */
+    template <typename T>
+    void rowSub(SparseVector<T>& row1, const T& multiple, const SparseVector<T>& row2, SparseVector<T>& scratch) {
+	rowSub(row1, multiple, row2, scratch, [](size_t, int) {});
+    }
+
+    /** Divides every entry of a sparse row by a non-zero divisor */
+    template <typename T>
+    void rowDiv(SparseVector<T>& row, const T& divisor) {
+	if(divisor == T{0})
+	    throw std::runtime_error {"Matrix Error: Can't divide a row by zero"};
+	for(T& value : row.values) {
+	    value /= divisor;
+	}
+    }
+
+} /* namespace MatrixRowOps */
+
+
+/** Rows or columns linked into lists by their number of non-zeros, finding those with the fewest takes constant time */
+class SparseCountBuckets {
+
+    private:
+	/** The first item of each count, or none */
+	std::vector<size_t> m_head;
+	/** The neighbours of each item in its list */
+	std::vector<size_t> m_next;
+	std::vector<size_t> m_prev;
+	/** The count each item is listed under, or none if it isn't listed */
+	std::vector<size_t> m_count;
+
+    public:
+	static constexpr size_t none = SIZE_MAX;
+
+	/** Constructor, for the given number of items with counts up to maxCount, none listed yet */
+	SparseCountBuckets(size_t items, size_t maxCount) : m_head(maxCount + 1, none), m_next(items, none), m_prev(items, none), m_count(items, none) {}
+
+	/** Lists an item under the given count */
+	void insert(size_t item, size_t count) {
+	    m_count[item] = count;
+	    m_prev[item] = none;
+	    m_next[item] = m_head[count];
+	    if(m_head[count] != none)
+		m_prev[m_head[count]] = item;
+	    m_head[count] = item;
+	}
+
+	/** Removes an item from its list, if it is listed */
+	void remove(size_t item) {
+	    if(m_count[item] == none)
+		return;
+	    if(m_prev[item] != none)
+		m_next[m_prev[item]] = m_next[item];
+	    else
+		m_head[m_count[item]] = m_next[item];
+	    if(m_next[item] != none)
+		m_prev[m_next[item]] = m_prev[item];
+	    m_count[item] = none;
+	}
+
+	/** Moves a listed item to a new count */
+	void update(size_t item, size_t count) {
+	    if(m_count[item] == none || m_count[item] == count)
+		return;
+	    remove(item);
+	    insert(item, count);
+	}
+
+	/** Returns the first item listed under a count, or none */
+	size_t first(size_t count) const {
+	    return count < m_head.size() ? m_head[count] : none;
+	}
+
+	/** Returns the item after the given one in its list, or none */
+	size_t next(size_t item) const {
+	    return m_next[item];
+	}
+
+	size_t getMaxCount(void) const {
+	    return m_head.size() - 1;
+	}
+};
+
+
+/** Sparse LU factorization (P * A * Q = L * U) of a square sparse Matrix, with row and column permutations P and Q.
+  * Pivots are chosen by the Markowitz criterion, the entry whose row and column have the fewest other non-zeros, which
+  * bounds the fill-in each elimination step can cause. The search looks at the rows and columns with the fewest non-zeros
+  * first and stops after a few of them. Floating point pivots must also reach a fraction of the largest magnitude of
+  * their row, exact types accept any non-zero pivot.
+  */
+template <typename T>
+class SparseLU {
+
+    private:
+	/** The pivot row of each step, in the columns of the original Matrix, which is a row of U */
+	std::vector<SparseVector<T>> m_upper;
+	/** The multipliers of each step by the original row they were applied to, which is a column of L */
+	std::vector<SparseVector<T>> m_lower;
+	/** The pivot of each step */
+	std::vector<T> m_pivots;
+	/** The original row and column of the pivot of each step */
+	std::vector<size_t> m_rowPerm;
+	std::vector<size_t> m_colPerm;
+	/** Whether the factorization ran out of non-zero pivots */
+	bool m_singular = false;
+
+	/** Returns the largest magnitude in a row, which floating point pivots are measured against */
+	static T largest(const SparseVector<T>& row) {
+	    T result {0};
+	    if constexpr (std::is_floating_point_v<T>) {
+		for(const T& entry : row.values) {
+		    result = std::max(result, std::abs(entry));
+		}
+	    }
+	    return result;
+	}
+
+	/** Whether an entry may be a pivot, floating point entries need to be large enough within their row */
+	static bool acceptable(const T& value, const T& rowLargest) {
+	    if constexpr (std::is_floating_point_v<T>)
+		return value != T{0} && std::abs(value) >= T(SPARSE_PIVOT_THRESHOLD) * rowLargest;
+	    else
+		return value != T{0};
+	}
+
+	/** Returns the parity of a permutation, true if odd */
+	static bool isOdd(const std::vector<size_t>& perm) {
+	    std::vector<bool> seen (perm.size());
+	    bool odd = false;
+	    for(size_t start = 0; start < perm.size(); ++start) {
+		/* Each cycle of length k is k - 1 transpositions */
+		for(size_t idx = perm[start]; !seen[start] && idx != start; idx = perm[idx]) {
+		    seen[idx] = true;
+		    odd = !odd;
+		}
+		seen[start] = true;
+	    }
+	    return odd;
+	}
+
+	/** Factorizes the rows of the Matrix, consuming them */
+	void factorize(std::vector<SparseVector<T>>& rows) {
+	    size_t n = rows.size();
+	    /* The rows with an entry in each column, entries removed by cancellation leave stale rows behind which are skipped */
+	    std::vector<std::vector<size_t>> colRows (n);
+	    std::vector<size_t> colCount (n, 0);
+	    for(size_t row = 0; row < n; ++row) {
+		for(size_t col : rows[row].indices) {
+		    colRows[col].push_back(row);
+		    ++colCount[col];
+		}
+	    }
+	    SparseCountBuckets rowBuckets {n, n}, colBuckets {n, n};
+	    for(size_t idx = 0; idx < n; ++idx) {
+		rowBuckets.insert(idx, rows[idx].size());
+		colBuckets.insert(idx, colCount[idx]);
+	    }
+	    std::vector<bool> rowActive (n, true), colActive (n, true);
+	    SparseVector<T> pivotRest, scratch;
+
+	    for(size_t step = 0; step < n; ++step) {
+		/* Markowitz search, cost (row count - 1) * (column count - 1), rows and columns with the fewest entries first */
+		size_t bestRow = SparseCountBuckets::none, bestCol = SparseCountBuckets::none, bestCost = SIZE_MAX, examined = 0;
+		auto consider = [&](size_t row, size_t col, const T& value, const T& rowLargest) {
+		    size_t cost = (rows[row].size() - 1) * (colCount[col] - 1);
+		    if(cost < bestCost && acceptable(value, rowLargest)) {
+			bestCost = cost;
+			bestRow = row;
+			bestCol = col;
+		    }
+		};
+		for(size_t count = 1; count <= n && (bestCost > (count - 1) * (count - 1) || bestRow == SparseCountBuckets::none); ++count) {
+		    for(size_t col = colBuckets.first(count); col != SparseCountBuckets::none && !(bestRow != SparseCountBuckets::none && examined >= SPARSE_MARKOWITZ_SEARCH); col = colBuckets.next(col)) {
+			/* Stale rows are dropped from the column while looking through it */
+			std::vector<size_t>& candidates = colRows[col];
+			size_t kept = 0;
+			for(size_t row : candidates) {
+			    size_t position = rowActive[row] ? rows[row].find(col) : rows[row].size();
+			    if(position == rows[row].size())
+				continue;
+			    candidates[kept++] = row;
+			    consider(row, col, rows[row].values[position], largest(rows[row]));
+			}
+			candidates.resize(kept);
+			++examined;
+		    }
+		    for(size_t row = rowBuckets.first(count); row != SparseCountBuckets::none && !(bestRow != SparseCountBuckets::none && examined >= SPARSE_MARKOWITZ_SEARCH); row = rowBuckets.next(row)) {
+			T rowLargest = largest(rows[row]);
+			for(size_t idx = 0; idx < rows[row].size(); ++idx) {
+			    consider(row, rows[row].indices[idx], rows[row].values[idx], rowLargest);
+			}
+			++examined;
+		    }
+		    if(bestRow != SparseCountBuckets::none && examined >= SPARSE_MARKOWITZ_SEARCH)
+			break;
+		}
+		/* Without a pivot every remaining row is zero, they are matched up with the remaining columns in any order */
+		if(bestRow == SparseCountBuckets::none) {
+		    m_singular = true;
+		    for(size_t row = 0, col = 0; row < n; ++row) {
+			if(!rowActive[row])
+			    continue;
+			while(!colActive[col]) {
+			    ++col;
+			}
+			colActive[col] = false;
+			m_rowPerm.push_back(row);
+			m_colPerm.push_back(col);
+			m_upper.emplace_back();
+			m_lower.emplace_back();
+			m_pivots.push_back(T{0});
+		    }
+		    return;
+		}
+
+		/* The pivot row and column leave the active part */
+		rowActive[bestRow] = false;
+		colActive[bestCol] = false;
+		rowBuckets.remove(bestRow);
+		colBuckets.remove(bestCol);
+		SparseVector<T>& pivotRow = rows[bestRow];
+		T pivot = pivotRow.values[pivotRow.find(bestCol)];
+		pivotRest.clear();
+		for(size_t idx = 0; idx < pivotRow.size(); ++idx) {
+		    size_t col = pivotRow.indices[idx];
+		    if(col == bestCol)
+			continue;
+		    pivotRest.push(col, pivotRow.values[idx]);
+		    colBuckets.update(col, --colCount[col]);
+		}
+
+		/* Eliminate the pivot column from every other active row */
+		SparseVector<T> multipliers;
+		for(size_t row : colRows[bestCol]) {
+		    if(!rowActive[row])
+			continue;
+		    size_t position = rows[row].find(bestCol);
+		    if(position == rows[row].size())
+			continue;
+		    T multiple = rows[row].values[position] / pivot;
+		    rows[row].erase(position);
+		    MatrixRowOps::rowSub(rows[row], multiple, pivotRest, scratch, [&](size_t col, int change) {
+			colCount[col] = static_cast<size_t>(static_cast<std::ptrdiff_t>(colCount[col]) + change);
+			colBuckets.update(col, colCount[col]);
+			if(change > 0)
+			    colRows[col].push_back(row);
+		    });
+		    rowBuckets.update(row, rows[row].size());
+		    multipliers.push(row, std::move(multiple));
+		}
+		colCount[bestCol] = 0;
+		std::vector<size_t>().swap(colRows[bestCol]);
+
+		/* L is applied in row order during solving, so its multipliers are sorted by row */
+		std::vector<size_t> order (multipliers.size());
+		std::iota(order.begin(), order.end(), size_t{0});
+		std::sort(order.begin(), order.end(), [&multipliers](size_t a, size_t b) { return multipliers.indices[a] < multipliers.indices[b]; });
+		SparseVector<T> lower;
+		for(size_t idx : order) {
+		    lower.push(multipliers.indices[idx], std::move(multipliers.values[idx]));
+		}
+		m_lower.push_back(std::move(lower));
+		m_upper.push_back(std::move(pivotRow));
+		m_pivots.push_back(std::move(pivot));
+		m_rowPerm.push_back(bestRow);
+		m_colPerm.push_back(bestCol);
+	    }
+	}
+
+    public:
+	/** Constructor, factorizes the given square sparse Matrix */
+	explicit SparseLU(const SparseMatrix<T>& m) {
+	    if(m.getCols() != m.getRows())
+		throw std::runtime_error {"Matrix Error: Can't factorize a non-square Matrix"};
+	    std::vector<SparseVector<T>> rows = m.toRows();
+	    factorize(rows);
+	}
+
+	/** Returns the size (rows and columns) of the factorized Matrix */
+	size_t getSize(void) const {
+	    return m_pivots.size();
+	}
+
+	/** Whether the factorized Matrix is singular, in which case it can't be used to solve */
+	bool isSingular(void) const {
+	    return m_singular;
+	}
+
+	/** Returns the number of non-zeros of L and U together, the size of the original Matrix plus the fill-in */
+	size_t getNonZeros(void) const {
+	    size_t entries = 0;
+	    for(size_t step = 0; step < getSize(); ++step) {
+		entries += m_upper[step].size() + m_lower[step].size();
+	    }
+	    return entries;
+	}
+
+	/** Returns the original row of the pivot of each step */
+	const std::vector<size_t>& getRowPermutation(void) const {
+	    return m_rowPerm;
+	}
+
+	/** Returns the original column of the pivot of each step */
+	const std::vector<size_t>& getColPermutation(void) const {
+	    return m_colPerm;
+	}
+
+	/** Returns the determinant of the factorized Matrix */
+	T determinant(void) const {
+	    T det {1};
+	    for(const T& pivot : m_pivots) {
+		det *= pivot;
+	    }
+	    return isOdd(m_rowPerm) != isOdd(m_colPerm) ? T{0} - det : det;
+	}
+
+	/** Solves A * x = b for a single right-hand side vector, returns x */
+	std::vector<T> solve(std::vector<T> b) const {
+	    size_t n = getSize();
+	    if(b.size() != n)
+		throw std::runtime_error {"Matrix Error: Right-hand side has the wrong number of rows"};
+	    if(m_singular)
+		throw std::runtime_error {"Matrix Error: Can't solve with a singular Matrix"};
+	    /* Forward substitution, applying the steps of the elimination to b in their order */
+	    for(size_t step = 0; step < n; ++step) {
+		const T& value = b[m_rowPerm[step]];
+		if(value == T{0})
+		    continue;
+		const SparseVector<T>& lower = m_lower[step];
+		for(size_t idx = 0; idx < lower.size(); ++idx) {
+		    b[lower.indices[idx]] -= lower.values[idx] * value;
+		}
+	    }
+	    /* Back substitution, the pivot row of each step only has entries in the pivot columns of its own and later steps */
+	    std::vector<T> x (n, T{0});
+	    for(size_t step = n; step-- > 0;) {
+		T sum = b[m_rowPerm[step]];
+		const SparseVector<T>& upper = m_upper[step];
+		for(size_t idx = 0; idx < upper.size(); ++idx) {
+		    if(upper.indices[idx] != m_colPerm[step])
+			sum -= upper.values[idx] * x[upper.indices[idx]];
+		}
+		x[m_colPerm[step]] = sum / m_pivots[step];
+	    }
+	    return x;
+	}
+
+	/** Solves A * X = B for every column of B, returns X */
+	Matrix<T> solve(const Matrix<T>& b) const {
+	    if(b.getRows() != getSize())
+		throw std::runtime_error {"Matrix Error: Right-hand side has the wrong number of rows"};
+	    Matrix<T> x {b.getCols(), b.getRows()};
+	    std::vector<T> column (b.getRows());
+	    for(size_t col = 0; col < b.getCols(); ++col) {
+		for(size_t row = 0; row < b.getRows(); ++row) {
+		    column[row] = b.atUnchecked(col, row);
+		}
+		std::vector<T> result = solve(column);
+		for(size_t row = 0; row < b.getRows(); ++row) {
+		    x.atUnchecked(col, row) = std::move(result[row]);
+		}
+	    }
+	    return x;
+	}
+};
+
+
+/** Namespace containing Matrix Reduction functions */
+namespace MatrixReduce {
+
+    /** Gauss-Jordan elimination of a sparse Matrix, in place, with leading ones in the pivot rows.
+      * Echelon forms fix the order of the pivot columns, so of the rows that can hold a column's pivot the one with the
+      * fewest non-zeros is picked (the Markowitz choice within that column), floating point ones among those large enough.
+      * Without reduced only the rows below each pivot are eliminated (REF), with reduced the rows above as well (RREF).
+      */
+    template <typename T>
+    void reduceSparse(SparseMatrix<T>& m, bool reduced) {
+	std::vector<SparseVector<T>> rows = m.toRows();
+	/* The rows with an entry in each column, entries removed by cancellation leave stale rows behind which are skipped */
+	std::vector<std::vector<size_t>> colRows (m.getCols());
+	for(size_t row = 0; row < rows.size(); ++row) {
+	    for(size_t col : rows[row].indices) {
+		colRows[col].push_back(row);
+	    }
+	}
+	std::vector<bool> pivoted (rows.size(), false);
+	std::vector<size_t> pivotRows;
+	SparseVector<T> scratch;
+
+	for(size_t col = 0; col < m.getCols() && pivotRows.size() < rows.size(); ++col) {
+	    /* Rows not yet pivoted are zero left of this column, so the candidates are those starting in it */
+	    auto candidate = [&](size_t row) { return !pivoted[row] && !rows[row].empty() && rows[row].indices.front() == col; };
+	    T largest {0};
+	    if constexpr (std::is_floating_point_v<T>) {
+		for(size_t row : colRows[col]) {
+		    if(candidate(row))
+			largest = std::max(largest, std::abs(rows[row].values.front()));
+		}
+	    }
+	    size_t pivotRow = SIZE_MAX;
+	    for(size_t row : colRows[col]) {
+		if(!candidate(row) || (pivotRow != SIZE_MAX && rows[row].size() >= rows[pivotRow].size()))
+		    continue;
+		if constexpr (std::is_floating_point_v<T>) {
+		    if(std::abs(rows[row].values.front()) < T(SPARSE_PIVOT_THRESHOLD) * largest)
+			continue;
+		}
+		pivotRow = row;
+	    }
+	    if(pivotRow == SIZE_MAX)
+		continue;
+
+	    /* Leading one in the pivot row, then the column is cleared in the other rows holding it */
+	    SparseVector<T>& pivot = rows[pivotRow];
+	    MatrixRowOps::rowDiv(pivot, T{pivot.values.front()});
+	    pivot.values.front() = T{1};
+	    for(size_t row : colRows[col]) {
+		if(row == pivotRow || (pivoted[row] && !reduced))
+		    continue;
+		size_t position = rows[row].find(col);
+		if(position == rows[row].size())
+		    continue;
+		T multiple = rows[row].values[position];
+		MatrixRowOps::rowSub(rows[row], multiple, pivot, scratch, [&colRows, row](size_t fillCol, int change) {
+		    if(change > 0)
+			colRows[fillCol].push_back(row);
+		});
+		/* The pivot column cancels exactly only for exact types */
+		position = rows[row].find(col);
+		if(position != rows[row].size())
+		    rows[row].erase(position);
+	    }
+	    std::vector<size_t>().swap(colRows[col]);
+	    pivoted[pivotRow] = true;
+	    pivotRows.push_back(pivotRow);
+	}
+
+	/* Pivot rows in the order of their pivots, the zero rows below them */
+	std::vector<SparseVector<T>> ordered;
+	ordered.reserve(rows.size());
+	for(size_t row : pivotRows) {
+	    ordered.push_back(std::move(rows[row]));
+	}
+	for(size_t row = 0; row < rows.size(); ++row) {
+	    if(!pivoted[row])
+		ordered.push_back(std::move(rows[row]));
+	}
+	m = SparseMatrix<T>::fromRows(m.getCols(), ordered);
+    }
+
+    /** Reduces a sparse Matrix to Row Echelon Form (REF) */
+    template <typename T>
+    bool toREF(SparseMatrix<T>& m) {
+	reduceSparse(m, false);
+	return true;
+    }
+
+    /** Reduces a sparse Matrix to Reduced Row Echelon Form (RREF) */
+    template <typename T>
+    bool toRREF(SparseMatrix<T>& m) {
+	reduceSparse(m, true);
+	return true;
+    }
+
+} /* namespace MatrixReduce */
+
+#endif /* SPARSE_MATRIX_H */
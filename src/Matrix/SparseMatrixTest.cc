@@ -0,0 +1,167 @@
+/**
+ * @file SparseMatrixTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the sparse Matrix and its elimination
+*/
+
+#include "SparseMatrixTest.hh"
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+
+#include "MatrixLU.hh"
+#include "MatrixExact.hh"
+#include "MatrixTestUtil.hh"
+#include "../IO/MatrixMarket.hh"
+
+namespace {
+
+void conversionTest(void) {
+
+    /* Only the non-zero elements are stored */
+    Matrix<Rational> dense {{0, "1/2", 0, 0}, {0, 0, 0, 0}, {3, 0, 0, "-1/3"}};
+    SparseMatrix<Rational> m {dense};
+    assert(m.getCols() == 4 && m.getRows() == 3 && m.getNonZeros() == 3);
+    assert(m.at(1, 0) == Rational(1, 2) && m.at(0, 1) == 0 && m.at(3, 2) == Rational{"-1/3"});
+    assert(m.rowColumns(1).empty() && m.rowColumns(2).size() == 2 && m.rowColumns(2)[1] == 3);
+    assert(m.toDense() == dense);
+
+    /* Triplets in any order, duplicates summed and zeros dropped */
+    std::vector<size_t> rows {2, 0, 2, 1, 2}, cols {3, 1, 0, 2, 3};
+    std::vector<Rational> values {"-1/6", "1/2", 3, 0, "-1/6"};
+    assert(SparseMatrix<Rational>::fromTriplets(4, 3, rows, cols, values) == m);
+
+    /* Straight from a Matrix Market coordinate list, never dense */
+    std::istringstream input {"%%MatrixMarket matrix coordinate rational general\n3 4 3\n3 4 -1/3\n1 2 1/2\n3 1 3\n"};
+    MatrixMarket::Coordinates<Rational> c = MatrixMarket::readCoordinates<Rational>(input);
+    assert(SparseMatrix<Rational>::fromTriplets(c.cols, c.rows, c.rowIndices, c.colIndices, c.values) == m);
+
+    /* Products with dense matrices only touch the stored elements */
+    Matrix<Rational> rhs {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+    assert(m * rhs == dense * rhs);
+}
+
+void rowOpsTest(void) {
+
+    /* Fill-in and cancellation are reported */
+    SparseVector<Rational> row1, row2, scratch;
+    row1.push(0, 2);
+    row1.push(3, 4);
+    row2.push(1, 1);
+    row2.push(3, 2);
+    int fills = 0, cancels = 0;
+    MatrixRowOps::rowSub(row1, Rational{2}, row2, scratch, [&](size_t col, int change) {
+	assert(col == (change > 0 ? 1 : 3));
+	(change > 0 ? fills : cancels) += 1;
+    });
+    assert(fills == 1 && cancels == 1);
+    assert(row1.indices == (std::vector<size_t>{0, 1}) && row1.values[1] == -2);
+    MatrixRowOps::rowDiv(row1, Rational{-2});
+    assert(row1.values[0] == -1 && row1.values[1] == 1);
+}
+
+void reduceTest(void) {
+
+    /* The RREF is unique, so it matches the dense one, a REF only needs to be a REF */
+    uint32_t state = 7;
+    for(size_t round = 0; round < 24; ++round) {
+	Matrix<Rational> dense = MatrixTestUtil::randomMatrix(3 + round % 7, 2 + (round * 5) % 9, state, 7, 3, 3 + round % 3);
+	/* Repeat a row to make some of them rank deficient */
+	if(round % 4 == 0 && dense.getRows() > 1)
+	    dense.rowView(dense.getRows() - 1).assign(dense.rowView(0));
+	SparseMatrix<Rational> sparse {dense};
+	SparseMatrix<Rational> echelon = sparse;
+	assert(MatrixReduce::toREF(echelon));
+	Matrix<Rational> ref = echelon.toDense();
+	assert(MatrixReduce::isREF(ref));
+	assert(MatrixReduce::toRREF(sparse));
+	assert(MatrixReduce::toRREF(dense));
+	assert(sparse.toDense() == dense);
+	assert(MatrixReduce::toRREF(ref) && ref == dense);
+    }
+
+    /* The same through the elimination modes of Rational matrices */
+    Matrix<Rational> m1 = MatrixTestUtil::randomMatrix(12, 9, state, 7, 3, 4), m2 = m1;
+    assert(MatrixReduce::toRREF(m1, MatrixReduce::Mode::Sparse));
+    assert(MatrixReduce::toRREF(m2));
+    assert(m1 == m2);
+}
+
+void luTest(void) {
+
+    /* Solutions and determinants match the dense factorization */
+    uint32_t state = 11;
+    for(size_t round = 0; round < 10; ++round) {
+	size_t n = 4 + round;
+	Matrix<Rational> dense = MatrixTestUtil::randomMatrix(n, n, state, 7, 3, 3);
+	/* A non-zero diagonal keeps most of them regular */
+	for(size_t idx = 0; idx < n; ++idx) {
+	    dense.at(idx, idx) += 1;
+	}
+	SparseLU<Rational> sparse {SparseMatrix<Rational>{dense}};
+	LU<Rational> lu {dense};
+	assert(sparse.determinant() == lu.determinant());
+	assert(sparse.isSingular() == lu.isSingular());
+	if(lu.isSingular())
+	    continue;
+	Matrix<Rational> b = MatrixTestUtil::randomMatrix(2, n, state, 7, 3, 1);
+	assert(sparse.solve(b) == lu.solve(b));
+	assert(dense * sparse.solve(b) == b);
+    }
+
+    /* Singular matrices are recognized */
+    Matrix<Rational> singular {{1, 2, 0}, {2, 4, 0}, {0, 0, 1}};
+    SparseLU<Rational> lu {SparseMatrix<Rational>{singular}};
+    assert(lu.isSingular() && lu.determinant() == 0);
+}
+
+void fillTest(void) {
+
+    /* An arrowhead matrix fills in completely when its dense first row and column are eliminated first,
+     * Markowitz pivoting leaves them for last and causes no fill-in at all */
+    size_t n = 200;
+    std::vector<size_t> rows, cols;
+    std::vector<double> values;
+    for(size_t idx = 0; idx < n; ++idx) {
+	rows.insert(rows.end(), {idx, 0, idx});
+	cols.insert(cols.end(), {idx, idx, 0});
+	values.insert(values.end(), {idx == 0 ? double(n) : 4.0, idx == 0 ? 0.0 : 1.0, idx == 0 ? 0.0 : 1.0});
+    }
+    SparseMatrix<double> arrow = SparseMatrix<double>::fromTriplets(n, n, rows, cols, values);
+    assert(arrow.getNonZeros() == 3 * n - 2);
+    SparseLU<double> lu {arrow};
+    assert(!lu.isSingular());
+    assert(lu.getNonZeros() == arrow.getNonZeros());
+    assert(lu.getRowPermutation().front() != 0 && lu.getColPermutation().front() != 0);
+
+    /* The solution still matches the dense one */
+    std::vector<double> b (n);
+    for(size_t idx = 0; idx < n; ++idx) {
+	b[idx] = double(idx % 7) - 3;
+    }
+    std::vector<double> x = lu.solve(b);
+    std::vector<double> expected = LU<double>{arrow.toDense()}.solve(b);
+    for(size_t idx = 0; idx < n; ++idx) {
+	assert(std::abs(x[idx] - expected[idx]) < 1e-9);
+    }
+}
+
+} /* anonymous */
+
+void sparseMatrixTest(void) {
+
+    std::puts("--- Sparse Matrix TC Running ---");
+    conversionTest();
+    std::puts("-> Passed conversionTest()");
+    rowOpsTest();
+    std::puts("-> Passed rowOpsTest()");
+    reduceTest();
+    std::puts("-> Passed reduceTest()");
+    luTest();
+    std::puts("-> Passed luTest()");
+    fillTest();
+    std::puts("-> Passed fillTest()");
+    std::puts("--- Sparse Matrix Tests Passed ---");
+}
@@ -0,0 +1,19 @@
+/**
+ * @file SparseMatrixTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the sparse Matrix and its elimination
+*/
+#ifndef SPARSE_MATRIX_TEST_H
+#define SPARSE_MATRIX_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "SparseMatrix.hh"
+#include "Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the sparse Matrix and its elimination */
+void sparseMatrixTest(void);
+
+#endif /* SPARSE_MATRIX_TEST_H */
@@ -8,141 +8,461 @@
 
 #include <string>
 #include <stdexcept>
-#include <regex>
-#include <numeric>
+#include <string_view>
+#include <charconv>
+#include <system_error>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <utility>
 #include <cstdlib>
 #include <cstdint>
 
+#include "../BigInt/BigInt.hh"
+
 #define FLOAT_CONVERSION_PRECISION 1000000
 
-/** Rational Number, a signed fraction of two real numbers */
+/** Rational Number, a signed fraction of two integers, packed into 16 bytes.
+  * Values with a numerator that fits into an int64_t and a denominator that fits into a uint64_t are stored inline and computed
+  * on with overflow-checked machine arithmetic. Only when a result doesn't fit, it is promoted to a pair of BigInts behind a
+  * shared pointer, and demoted back once it fits again.
+  */
 class Rational {
 
     private:
-	/** The numerator of the Rational */
-	uint32_t m_a;
-	/** The denominator of the Rational */
-	uint32_t m_b;
-	/** Whether the number is negative */
-	bool m_negative;
-
-	/** Utility member function to simplify the fraction */
-	void simplify(void) {
-	    /* Simplify terms */
-	    uint32_t gcd = std::gcd(m_a, m_b);
-	    if(gcd > 1) {
-		m_a /= gcd;
-		m_b /= gcd;
+	/** Arbitrary precision form of the value, in lowest terms with a positive denominator */
+	struct Big {
+	    /** The signed numerator */
+	    BigInt num;
+	    /** The positive denominator */
+	    BigInt den;
+	    /** The number of Rationals sharing this value, it is copied before being modified while shared */
+	    std::atomic<size_t> refs {1};
+	};
+
+	/** The signed numerator in the inline form, the address of the Big value in the big form */
+	int64_t m_num = 0;
+	/** The positive denominator in the inline form, zero marks the big form */
+	uint64_t m_den = 1;
+
+	/** Whether the reduction of small results to lowest terms is currently deferred on this thread, see DeferNormalization */
+	static bool& deferred(void) {
+	    thread_local bool flag = false;
+	    return flag;
+	}
+
+	/** Whether the value is in the big form */
+	bool isBig(void) const {
+	    return m_den == 0;
+	}
+
+	/** Returns the Big value, only valid in the big form */
+	Big* big(void) const {
+	    return std::bit_cast<Big*>(m_num);
+	}
+
+	/** Drops the reference to the Big value, if in the big form */
+	void release(void) {
+	    if(isBig() && big()->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete big();
+	}
+
+	/** Returns the magnitude of the inline numerator */
+	uint64_t magnitude(void) const {
+	    return m_num < 0 ? uint64_t{0} - static_cast<uint64_t>(m_num) : static_cast<uint64_t>(m_num);
+	}
+
+	/** Returns the common divisor of the inline numerator and denominator, one unless normalization was deferred */
+	uint64_t divisor(void) const {
+	    return ModArith::binaryGcd(magnitude(), m_den);
+	}
+
+	/** Sets the inline form from a magnitude, denominator and sign, returns false without changing anything if the numerator doesn't fit */
+	bool setSmall(uint64_t a, uint64_t b, bool negative) {
+	    if(a > static_cast<uint64_t>(INT64_MAX))
+		return false;
+	    release();
+	    m_num = negative ? -static_cast<int64_t>(a) : static_cast<int64_t>(a);
+	    m_den = b;
+	    return true;
+	}
+
+	/** Adds the magnitude x with sign xNegative to y with sign yNegative, returns false if the sum overflows */
+	static bool addSigned(uint64_t x, bool xNegative, uint64_t y, bool yNegative, uint64_t& result, bool& negative) {
+	    if(xNegative == yNegative) {
+		negative = xNegative;
+		return !__builtin_add_overflow(x, y, &result);
+	    }
+	    negative = x >= y ? xNegative : yNegative;
+	    result = x >= y ? x - y : y - x;
+	    return true;
+	}
+
+	/** Adds the small value a / b with the given sign in 64 bits, returns false without changing the value if that overflows.
+	  * Following Henrici, only the gcd of the denominators is divided out before the cross multiplication,
+	  * and the sum is brought to lowest terms by a gcd with that divisor alone, for operands in lowest terms.
+	  * With deferred normalization, no gcd is taken at all unless the plain cross multiplication overflows.
+	  */
+	bool addSmall(uint64_t a, uint64_t b, bool negative) {
+	    uint64_t selfA = magnitude(), selfB = m_den;
+	    bool selfNegative = m_num < 0;
+	    uint64_t num, den, lhsA, rhsA;
+	    bool resultNegative;
+	    if(deferred()) {
+		bool fits;
+		if(selfB == b) {
+		    den = b;
+		    fits = addSigned(selfA, selfNegative, a, negative, num, resultNegative);
+		} else {
+		    fits = !__builtin_mul_overflow(selfA, b, &lhsA) && !__builtin_mul_overflow(a, selfB, &rhsA) &&
+			   !__builtin_mul_overflow(selfB, b, &den) && addSigned(lhsA, selfNegative, rhsA, negative, num, resultNegative);
+		}
+		if(fits && setSmall(num, den, resultNegative))
+		    return true;
+		/* Reduce both operands and fall back to the reducing addition */
+		uint64_t gcd = ModArith::binaryGcd(selfA, selfB);
+		selfA /= gcd;
+		selfB /= gcd;
+		gcd = ModArith::binaryGcd(a, b);
+		a /= gcd;
+		b /= gcd;
+	    }
+	    uint64_t d1 = ModArith::binaryGcd(selfB, b);
+	    if(__builtin_mul_overflow(selfA, b / d1, &lhsA) || __builtin_mul_overflow(a, selfB / d1, &rhsA) ||
+	       !addSigned(lhsA, selfNegative, rhsA, negative, num, resultNegative))
+		return false;
+	    if(num == 0)
+		return setSmall(0, 1, false);
+	    uint64_t d2 = d1 == 1 ? 1 : ModArith::binaryGcd(num, d1);
+	    if(__builtin_mul_overflow(selfB / d1, b / d2, &den))
+		return false;
+	    return setSmall(num / d2, den, resultNegative);
+	}
+
+	/** Multiplies by the small value a / b with the given sign in 64 bits, returns false without changing the value if that overflows.
+	  * Common factors are cancelled across (numerator against the other denominator) before multiplying,
+	  * so the operands stay small and the product of operands in lowest terms is in lowest terms again.
+	  */
+	bool mulSmall(uint64_t a, uint64_t b, bool negative) {
+	    uint64_t selfA = magnitude(), selfB = m_den;
+	    /* Logical XOR for the sign */
+	    bool resultNegative = (m_num < 0) != negative;
+	    if(selfA == 0 || a == 0)
+		return setSmall(0, 1, false);
+	    uint64_t num, den;
+	    if(deferred()) {
+		if(!__builtin_mul_overflow(selfA, a, &num) && !__builtin_mul_overflow(selfB, b, &den) && setSmall(num, den, resultNegative))
+		    return true;
+		/* Reduce both operands and fall back to the cross-cancelling multiplication */
+		uint64_t gcd = ModArith::binaryGcd(selfA, selfB);
+		selfA /= gcd;
+		selfB /= gcd;
+		gcd = ModArith::binaryGcd(a, b);
+		a /= gcd;
+		b /= gcd;
+	    }
+	    uint64_t g1 = ModArith::binaryGcd(selfA, b);
+	    uint64_t g2 = ModArith::binaryGcd(a, selfB);
+	    if(__builtin_mul_overflow(selfA / g1, a / g2, &num) || __builtin_mul_overflow(selfB / g2, b / g1, &den))
+		return false;
+	    return setSmall(num, den, resultNegative);
+	}
+
+	/** Sets the value to num / den, reducing it to lowest terms and choosing the inline form whenever it fits */
+	void assign(BigInt num, BigInt den) {
+	    if(den.isZero())
+		throw std::runtime_error {"Rational Error: Denominator can't be zero!"};
+	    if(den.isNegative()) {
+		num.negate();
+		den.negate();
+	    }
+	    BigInt divisor = gcd(num, den);
+	    if(divisor != 1) {
+		num /= divisor;
+		den /= divisor;
+	    }
+	    if(num.bitLength() <= 63 && den.bitLength() <= 64) {
+		release();
+		m_num = num.toInt64();
+		m_den = den.toMagnitude64();
+	    } else {
+		Big* value = new Big{std::move(num), std::move(den)};
+		release();
+		m_num = std::bit_cast<int64_t>(value);
+		m_den = 0;
 	    }
-	    /* Remove sign if zero to ensure unsigned zero */
-	    if(m_a == 0 && m_negative)
-		m_negative = false;
+	}
+
+	/** Returns the signed numerator as a BigInt, whichever form the value is in */
+	BigInt signedNumerator(void) const {
+	    return isBig() ? big()->num : BigInt{m_num};
+	}
+
+	/** Returns the denominator as a BigInt, whichever form the value is in */
+	BigInt bigDenominator(void) const {
+	    return isBig() ? big()->den : BigInt{m_den};
 	}
 
 	/** Static member function that creates a rational instance from a floating point number */
 	static Rational fromFloat(float number) {
 	    /* Getting unsigned integer representation of float, up to specific precision */
-	    uint32_t a = static_cast<uint32_t>(std::abs(number) * FLOAT_CONVERSION_PRECISION);
-	    uint32_t b = FLOAT_CONVERSION_PRECISION;
+	    uint64_t a = static_cast<uint64_t>(std::abs(number) * FLOAT_CONVERSION_PRECISION);
+	    uint64_t b = FLOAT_CONVERSION_PRECISION;
 	    bool negative = (number < 0.0f);
 	    /* Creating new Rational instance with the given parameters */
 	    return Rational {a, b, negative};
 	}
 
-	/** Static member function that creates a rational instance from a std::string. 
-	  * Accepted string formats are either a decimal number or a fraction of integers separated with a slash.
-	  */
-	static Rational fromString(std::string number) {
-	    /* Checking if string is valid */
-	    std::smatch matches;
-	    if(std::regex_match(number, matches, std::regex("[-+]?\\d+(\\.\\d+)?"))) {
-		/* String is a valid decimal number */
-		return Rational::fromFloat(std::stof(number));
-
-	    } else if(std::regex_match(number, matches, std::regex("([-+]?)(\\d+)/(\\d+)"))) {
-		/* String is a valid fraction format */
-		uint32_t a = std::stoi(matches[2].str());
-		uint32_t b = std::stoi(matches[3].str());
-		bool negative = (matches[1].str() == "-");
-		return Rational {a, b, negative};
+	/** Returns the position after the run of decimal digits starting at pos */
+	static size_t skipDigits(std::string_view text, size_t pos) {
+	    while(pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+		++pos;
+	    }
+	    return pos;
+	}
 
-	    } else {
-		/* String is invalid */
-		throw std::runtime_error {"Rational Error: Invalid string format specified!"};
+	/** Parses a run of decimal digits into value, returns false if it doesn't fit into 64 bits */
+	static bool parseDigits(std::string_view digits, uint64_t& value) {
+	    return std::from_chars(digits.data(), digits.data() + digits.size(), value).ec == std::errc{};
+	}
+
+	/** Returns 10 to the given power as a BigInt */
+	static BigInt powerOfTen(size_t exponent) {
+	    BigInt result {1};
+	    for(; exponent >= 19; exponent -= 19) {
+		result *= BigInt{uint64_t{10000000000000000000u}};
+	    }
+	    uint64_t rest = 1;
+	    for(; exponent > 0; --exponent) {
+		rest *= 10;
 	    }
+	    return rest == 1 ? result : result * BigInt{rest};
 	}
 
     public:
+	/** Scope guard deferring the reduction to lowest terms of small results on the calling thread.
+	  * Inside the scope, sums and products skip their gcd computations until a result would overflow 64 bits.
+	  * Comparisons stay exact and getters and output reduce what they return, normalize() reduces a value explicitly.
+	  */
+	class DeferNormalization {
+	    private:
+		/** Whether normalization was already deferred when the guard was created */
+		bool m_previous;
+	    public:
+		DeferNormalization(void) : m_previous{deferred()} {
+		    deferred() = true;
+		}
+		~DeferNormalization(void) {
+		    deferred() = m_previous;
+		}
+		DeferNormalization(const DeferNormalization&) = delete;
+		DeferNormalization& operator=(const DeferNormalization&) = delete;
+	};
+
+	/** Parses a Rational from a decimal number ("-0.125") or a fraction of integers separated with a slash ("3/8"), either with an optional sign.
+	  * Decimals are converted exactly, and values that fit into 64 bits are parsed without allocating.
+	  */
+	static Rational parse(std::string_view text) {
+	    bool negative = !text.empty() && text[0] == '-';
+	    size_t pos = (!text.empty() && (text[0] == '-' || text[0] == '+')) ? 1 : 0;
+	    size_t wholeEnd = skipDigits(text, pos);
+	    std::string_view whole = text.substr(pos, wholeEnd - pos);
+	    /* The part after a decimal point or a slash, which must be digits up to the end */
+	    std::string_view rest;
+	    char separator = wholeEnd < text.size() ? text[wholeEnd] : '\0';
+	    if(separator == '.' || separator == '/') {
+		rest = text.substr(wholeEnd + 1);
+		if(skipDigits(rest, 0) != rest.size())
+		    rest = {};
+	    }
+	    if(whole.empty() || (separator != '\0' && rest.empty()))
+		throw std::runtime_error {"Rational Error: Invalid string format specified!"};
+
+	    /* Fast path, everything fits into 64 bits */
+	    uint64_t num = 0, fraction = 0, den = 1;
+	    if(parseDigits(whole, num)) {
+		if(separator == '\0')
+		    return Rational{num, 1, negative};
+		if(separator == '/' && parseDigits(rest, den))
+		    return Rational{num, den, negative};
+		if(separator == '.' && rest.size() <= 19 && parseDigits(rest, fraction)) {
+		    for(size_t digit = 0; digit < rest.size(); ++digit) {
+			den *= 10;
+		    }
+		    uint64_t scaled;
+		    if(!__builtin_mul_overflow(num, den, &scaled) && !__builtin_add_overflow(scaled, fraction, &scaled))
+			return Rational{scaled, den, negative};
+		}
+	    }
+
+	    /* Values of any length go through BigInt */
+	    BigInt numerator {whole};
+	    BigInt denominator {1};
+	    if(separator == '/') {
+		denominator = BigInt{rest};
+	    } else if(separator == '.') {
+		denominator = powerOfTen(rest.size());
+		numerator = numerator * denominator + BigInt{rest};
+	    }
+	    if(negative)
+		numerator.negate();
+	    return Rational{std::move(numerator), std::move(denominator)};
+	}
+
 	/** Constructor creating a Rational instance from the numerator a, denominator b and sign boolean */
-	Rational(uint32_t a, uint32_t b, bool negative = false) : m_a{a}, m_b{b}, m_negative{negative} {
-	    if(m_b == 0)
+	Rational(uint64_t a, uint64_t b, bool negative = false) {
+	    if(b == 0)
 		throw std::runtime_error {"Rational Error: Denominator can't be zero!"};
-	    this->simplify();
+	    /* Simplify terms */
+	    uint64_t gcd = ModArith::binaryGcd(a, b);
+	    a /= gcd;
+	    b /= gcd;
+	    if(!setSmall(a, b, negative))
+		assign(negative ? BigInt{a}.negate() : BigInt{a}, BigInt{b});
+	}
+	/** Constructor creating a Rational instance from an arbitrary precision numerator and denominator (of any sign) */
+	Rational(BigInt num, BigInt den) {
+	    assign(std::move(num), std::move(den));
 	}
 	/** Constructor creating a Rational instance from a floating point number */
 	Rational(float number) {
 	    *this = Rational::fromFloat(number);
 	}
-	/** Constructor creating a Rational instance from an integer */
-	Rational(int number) : Rational{static_cast<float>(number)} {}
+	/** Constructor creating a Rational instance from an integer, exactly */
+	template <std::integral I> requires (!std::same_as<I, bool>)
+	Rational(I number) : Rational{std::cmp_less(number, 0) ? uint64_t{0} - static_cast<uint64_t>(number) : static_cast<uint64_t>(number), 1, std::cmp_less(number, 0)} {}
 	/** Constructor creating a Rational instance from a string, either containing a decimal number or a fraction of integers separated with a slash */
-	Rational(std::string number) {
-	    *this = Rational::fromString(number);
+	Rational(const std::string& number) {
+	    *this = Rational::parse(number);
+	}
+	/** Constructor creating a Rational instance from a string view, in the same formats */
+	Rational(std::string_view number) {
+	    *this = Rational::parse(number);
 	}
 	/** Constructor creating a Rational instance from a C string */
 	Rational(char const * number) {
-	    *this = Rational::fromString(number);
+	    *this = Rational::parse(number);
+	}
+	/** Copy constructor, shares the value in the big form */
+	Rational(const Rational& other) : m_num{other.m_num}, m_den{other.m_den} {
+	    if(isBig())
+		big()->refs.fetch_add(1, std::memory_order_relaxed);
 	}
-	/** Copy constructor */
-	Rational(const Rational& other) {
-	    *this = other;
+	/** Move constructor, takes over the value of other and leaves it as zero */
+	Rational(Rational&& other) noexcept : m_num{other.m_num}, m_den{other.m_den} {
+	    other.m_num = 0;
+	    other.m_den = 1;
 	}
 	/** Constructor creating a Rational instance set to zero by default */
-	Rational(void) {
-	    m_a = 0;
-	    m_b = 1;
-	    m_negative = false;
+	Rational(void) = default;
+	/** Destructor */
+	~Rational(void) {
+	    release();
 	}
 
-	/** Returns the numerator of the Rational instance */
-	uint32_t getNumerator(void) {
-	    return m_a;
+	/** Returns the numerator of the Rational instance, throws if it doesn't fit into 64 bits */
+	uint64_t getNumerator(void) const {
+	    if(isBig()) {
+		if(big()->num.bitLength() > 64 || big()->den.bitLength() > 64)
+		    throw std::runtime_error {"Rational Error: Value doesn't fit into 64 bits!"};
+		return big()->num.toMagnitude64();
+	    }
+	    return magnitude() / divisor();
+	}
+	/** Returns the denominator of the Rational instance, throws if it doesn't fit into 64 bits */
+	uint64_t getDenominator(void) const {
+	    if(isBig()) {
+		if(big()->num.bitLength() > 64 || big()->den.bitLength() > 64)
+		    throw std::runtime_error {"Rational Error: Value doesn't fit into 64 bits!"};
+		return big()->den.toMagnitude64();
+	    }
+	    return m_den / divisor();
 	}
-	/** Returns the denominator of the Rational instance */
-	uint32_t getDenominator(void) {
-	    return m_b;
+	/** Returns the numerator of the Rational instance as a BigInt, without the sign */
+	BigInt getBigNumerator(void) const {
+	    return isBig() ? big()->num.abs() : BigInt{magnitude() / divisor()};
+	}
+	/** Returns the denominator of the Rational instance as a BigInt */
+	BigInt getBigDenominator(void) const {
+	    return isBig() ? big()->den : BigInt{m_den / divisor()};
 	}
 	/** Returns whether the Rational instance is negative */
-	bool isNegative(void) {
-	    return m_negative;
+	bool isNegative(void) const {
+	    return isBig() ? big()->num.isNegative() : m_num < 0;
+	}
+	/** Returns whether the value is stored inline, so that the fast machine arithmetic is used */
+	bool isSmall(void) const {
+	    return !isBig();
+	}
+
+	/** Reduces the Rational instance to lowest terms, only needed after arithmetic with deferred normalization */
+	Rational& normalize(void) {
+	    if(!isBig()) {
+		uint64_t gcd = divisor();
+		setSmall(magnitude() / gcd, m_den / gcd, m_num < 0);
+	    }
+	    return *this;
 	}
 
 	/** Switches the sign of the Rational instance */
 	Rational& negate(void) {
-	    m_negative = !m_negative;
+	    if(!isBig()) {
+		/* The inline numerator is never INT64_MIN, that magnitude is stored big */
+		m_num = -m_num;
+	    } else if(big()->refs.load(std::memory_order_acquire) == 1) {
+		big()->num.negate();
+	    } else {
+		assign(BigInt{big()->num}.negate(), big()->den);
+	    }
 	    return *this;
 	}
 	/** Inverts the numerator and denominator of the Rational instance */
 	Rational& invert(void) {
 	    /* Check that the inversion won't result in a zero-division */
-	    if(m_a == 0) {
+	    if(m_num == 0 && !isBig()) {
 		throw std::runtime_error {"Rational Error: Zero has no inverse element"};
 	    }
-	    /* Invert a and b */
-	    uint32_t oldA = m_a;
-	    m_a = m_b;
-	    m_b = oldA;
+	    /* Invert a and b, the denominator may not fit into the numerator */
+	    if(isBig() || !setSmall(m_den, magnitude(), m_num < 0))
+		assign(isNegative() ? bigDenominator().negate() : bigDenominator(), getBigNumerator());
 	    return *this;
 	}
 
 	/** Returns the floating point representation of the rational number */
-	float toFloat(void) {
-	    return (m_negative ? -1.0f : 1.0f)*(static_cast<float>(m_a) / static_cast<float>(m_b));
+	float toFloat(void) const {
+	    if(isBig())
+		return static_cast<float>(big()->num.toDouble() / big()->den.toDouble());
+	    return static_cast<float>(static_cast<double>(m_num) / static_cast<double>(m_den));
 	}
 
 	/** Returns the string representation of the rational number, in the form of "A/B" */
-	std::string toString(void) {
-	    return (m_negative ? "-" : "") + std::to_string(m_a) + (m_b != 1 ? "/" + std::to_string(m_b) : "");
+	std::string toString(void) const {
+	    std::string result;
+	    appendTo(result);
+	    return result;
+	}
+
+	/** Appends the number in lowest terms to out, as "a/b" or "a" for integers, without creating intermediate strings */
+	void appendTo(std::string& out) const {
+	    if(isBig()) {
+		big()->num.appendTo(out);
+		if(big()->den != 1) {
+		    out += '/';
+		    big()->den.appendTo(out);
+		}
+		return;
+	    }
+	    if(m_num == 0) {
+		out += '0';
+		return;
+	    }
+	    uint64_t gcd = divisor();
+	    char buffer[24];
+	    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), m_num / static_cast<int64_t>(gcd)).ptr);
+	    if(m_den != gcd) {
+		out += '/';
+		out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), m_den / gcd).ptr);
+	    }
 	}
 
 	/* --- Operators --- */
@@ -152,18 +472,36 @@ class Rational {
 	    if(this == &other) {
 		return *this;
 	    }
+	    if(other.isBig())
+		other.big()->refs.fetch_add(1, std::memory_order_relaxed);
+	    release();
+	    this->m_num = other.m_num;
+	    this->m_den = other.m_den;
+	    return *this;
+	}
 
-	    /* Copy values and return self */
-	    this->m_a = other.m_a;
-	    this->m_b = other.m_b;
-	    this->m_negative = other.m_negative;
+	Rational& operator=(Rational&& other) noexcept {
+	    swap(*this, other);
 	    return *this;
 	}
 
+	/** Swaps two Rationals by exchanging their 16 bytes, the big form is owned through a plain pointer */
+	friend void swap(Rational& lhs, Rational& rhs) noexcept {
+	    std::swap(lhs.m_num, rhs.m_num);
+	    std::swap(lhs.m_den, rhs.m_den);
+	}
+
 	/* --- Comparison Operators --- */
 
 	friend bool operator==(const Rational& lhs, const Rational& rhs) {
-	    return (lhs.m_a == rhs.m_a && lhs.m_b == rhs.m_b && lhs.m_negative == rhs.m_negative);
+	    /* The big form is canonical, a value that fits is never stored big */
+	    if(lhs.isBig() || rhs.isBig())
+		return lhs.isBig() && rhs.isBig() && lhs.big()->num == rhs.big()->num && lhs.big()->den == rhs.big()->den;
+	    if(lhs.m_den == rhs.m_den)
+		return lhs.m_num == rhs.m_num;
+	    /* Denominators differ only if normalization was deferred, compare the cross products */
+	    return (lhs.m_num < 0) == (rhs.m_num < 0) &&
+		   static_cast<unsigned __int128>(lhs.magnitude()) * rhs.m_den == static_cast<unsigned __int128>(rhs.magnitude()) * lhs.m_den;
 	}
 
 	friend bool operator!=(const Rational& lhs, const Rational& rhs) {
@@ -172,11 +510,15 @@ class Rational {
 
 	friend bool operator<(const Rational& lhs, const Rational& rhs) {
 	    /* If the sign is different, return based on sign */
-	    if(lhs.m_negative != rhs.m_negative) {
-		return lhs.m_negative;
+	    if(lhs.isNegative() != rhs.isNegative()) {
+		return lhs.isNegative();
 	    }
-	    /* If the sign is the same, convert to the same denominator and compare numerators */
-	    return (lhs.m_a * rhs.m_b < rhs.m_a * lhs.m_b);
+	    if(lhs.isBig() || rhs.isBig())
+		return lhs.signedNumerator() * rhs.bigDenominator() < rhs.signedNumerator() * lhs.bigDenominator();
+	    /* If the sign is the same, convert to the same denominator and compare magnitudes, which reverse for negative numbers */
+	    unsigned __int128 left = static_cast<unsigned __int128>(lhs.magnitude()) * rhs.m_den;
+	    unsigned __int128 right = static_cast<unsigned __int128>(rhs.magnitude()) * lhs.m_den;
+	    return lhs.m_num < 0 ? right < left : left < right;
 	}
 
 	friend bool operator>(const Rational& lhs, const Rational& rhs) {
@@ -193,43 +535,40 @@ class Rational {
 
 	/* --- Arithmetic Operators --- */
 	Rational& operator+=(const Rational& rhs) {
-	    int64_t result = 0;
-	    if(this->m_b == rhs.m_b) {
-		/* Add sign-corrected numerators if denominators equal */
-		result = (this->m_negative ? -1 : 1)*static_cast<int64_t>(this->m_a) + (rhs.m_negative ? -1 : 1)*static_cast<int64_t>(rhs.m_a);
-	    } else {
-		/* Add sign-corrected denominator-corrected numerators */
-		result = (this->m_negative ? -1 : 1)*static_cast<int64_t>(this->m_a * rhs.m_b) + (rhs.m_negative ? -1 : 1)*static_cast<int64_t>(rhs.m_a * this->m_b);
-		this->m_b *= rhs.m_b;
-	    }
-	    /* Set the corresponding a and negative bool */
-	    this->m_a = static_cast<uint32_t>(std::abs(result));
-	    this->m_negative = (result < 0);
-	    /* Simplify the fraction and return reference */
-	    this->simplify();
+	    if(!this->isBig() && !rhs.isBig() && addSmall(rhs.magnitude(), rhs.m_den, rhs.m_num < 0))
+		return *this;
+	    /* Some part doesn't fit into 64 bits, add in arbitrary precision */
+	    BigInt lhsDen = this->bigDenominator();
+	    BigInt rhsDen = rhs.bigDenominator();
+	    assign(this->signedNumerator() * rhsDen + rhs.signedNumerator() * lhsDen, lhsDen * rhsDen);
 	    return *this;
 	}
 
-	Rational& operator*=(const Rational& rhs) {
-	    /* Multiply a and b of both sides */
-	    this->m_a *= rhs.m_a;
-	    this->m_b *= rhs.m_b;
-	    /* Logical XOR for the sign */
-	    this->m_negative = this->m_negative != rhs.m_negative;
-	    /* Simplify the fraction and return reference */
-	    this->simplify();
+	Rational& operator-=(const Rational& rhs) {
+	    /* Adding with the opposite sign, without a negated copy */
+	    if(!this->isBig() && !rhs.isBig() && addSmall(rhs.magnitude(), rhs.m_den, rhs.m_num > 0))
+		return *this;
+	    BigInt lhsDen = this->bigDenominator();
+	    BigInt rhsDen = rhs.bigDenominator();
+	    assign(this->signedNumerator() * rhsDen - rhs.signedNumerator() * lhsDen, lhsDen * rhsDen);
 	    return *this;
 	}
 
-	Rational& operator-=(const Rational& rhs) {
-	    Rational negated = rhs;
-	    *this += negated.negate();
+	Rational& operator*=(const Rational& rhs) {
+	    if(!this->isBig() && !rhs.isBig() && mulSmall(rhs.magnitude(), rhs.m_den, rhs.m_num < 0))
+		return *this;
+	    /* Some part doesn't fit into 64 bits, multiply in arbitrary precision */
+	    assign(this->signedNumerator() * rhs.signedNumerator(), this->bigDenominator() * rhs.bigDenominator());
 	    return *this;
 	}
 
 	Rational& operator/=(const Rational& rhs) {
-	    Rational inverted = rhs;
-	    *this *= inverted.invert();
+	    if(!rhs.isBig() && rhs.m_num == 0)
+		throw std::runtime_error {"Rational Error: Zero has no inverse element"};
+	    /* Multiplying with numerator and denominator swapped, without an inverted copy */
+	    if(!this->isBig() && !rhs.isBig() && mulSmall(rhs.m_den, rhs.magnitude(), rhs.m_num < 0))
+		return *this;
+	    assign(this->signedNumerator() * rhs.bigDenominator(), this->bigDenominator() * rhs.signedNumerator());
 	    return *this;
 	}
 
@@ -255,4 +594,6 @@ class Rational {
 
 };
 
+static_assert(sizeof(Rational) == 16, "Rational Error: The inline form should take 16 bytes");
+
 #endif /* RATIONAL_H */
@@ -431,6 +431,187 @@ void arithmeticTestNum(void) {
     assert(caught == 3);
 }
 
+void promotionTest(void) {
+
+    /* Products of two 64-bit values overflow the inline form and are promoted */
+    Rational r1 {uint64_t{1} << 40, 3};
+    BigInt p80 = BigInt{uint64_t{1} << 40} * BigInt{uint64_t{1} << 40};
+    Rational r2 = r1 * r1;
+    assert(!r2.isSmall() && r2.getBigNumerator() == p80 && r2.getBigDenominator() == 9);
+    assert(r2.toString() == "1208925819614629174706176/9");
+
+    /* Dividing back demotes to the inline form, equal to the original */
+    r2 /= r1;
+    assert(r2.isSmall() && r2 == r1);
+
+    /* Sums overflowing 64 bits */
+    Rational r3 {INT64_MAX};
+    Rational r4 = r3 + r3;
+    assert(!r4.isSmall() && r4.getBigNumerator() == BigInt{INT64_MAX} * 2 && !r4.isNegative());
+    r4 -= r3;
+    assert(r4.isSmall() && r4 == r3);
+
+    /* Common denominators overflowing 64 bits */
+    Rational r5 {1, UINT64_MAX - 1};
+    Rational r6 {1, UINT64_MAX, true};
+    Rational r7 = r5 + r6;
+    assert(!r7.isSmall() && r7.getBigNumerator() == 1 && r7.isNegative() == false);
+    assert(r7.getBigDenominator() == BigInt{UINT64_MAX - 1} * BigInt{UINT64_MAX});
+    assert(r7 > Rational{} && r7 < r5);
+    r7 -= r5;
+    assert(r7 == r6);
+
+    /* Big values throw from the 64-bit getters, and compare and negate correctly */
+    bool caught = false;
+    try {
+	r2 = r1 * r1;
+	r2.getNumerator();
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+    Rational r8 = r2;
+    r8.negate();
+    assert(r8 < r1 && r8 < Rational{} && r8.isNegative() && r8 != r2);
+    assert(r8.toString() == "-1208925819614629174706176/9");
+    r8.invert();
+    assert(!r8.isSmall() && r8.getBigDenominator() == p80 && r8.getBigNumerator() == 9 && r8.isNegative());
+    assert(r2.getBigNumerator() == p80 && !r2.isNegative());
+
+    /* Fractions too long for 64 bits are parsed exactly */
+    Rational r9 {"-1208925819614629174706176/18"};
+    assert(r9 * Rational(2, 1, true) == r2);
+
+    /* Integers are exact, also beyond the float precision */
+    Rational r10 {int64_t{123456789012345}};
+    Rational r11 {INT64_MIN};
+    assert(r10.getNumerator() == 123456789012345 && r10.getDenominator() == 1);
+    assert(r11.getNumerator() == uint64_t{1} << 63 && r11.isNegative());
+
+    /* Negative comparisons */
+    assert(Rational(1, 2, true) < Rational(1, 3, true));
+    assert(!(Rational(1, 3, true) < Rational(1, 2, true)));
+}
+
+void layoutTest(void) {
+
+    assert(sizeof(Rational) == 16);
+
+    /* Swapping and moving exchange the packed bytes, also in the big form */
+    Rational big = Rational{uint64_t{1} << 40, 3} * Rational{uint64_t{1} << 40, 7, true};
+    Rational small {2, 5};
+    swap(big, small);
+    assert(big == Rational(2, 5) && !small.isSmall() && small.isNegative());
+    Rational moved {std::move(small)};
+    assert(small == Rational{} && !moved.isSmall());
+    small = std::move(moved);
+    assert(!small.isSmall() && small.toString() == "-1208925819614629174706176/21");
+
+    /* Copies of the big form share the value until one of them is modified */
+    Rational copy = small;
+    copy.negate();
+    assert(small.isNegative() && !copy.isNegative() && copy == small * Rational{-1});
+    copy = copy;
+    copy = small;
+    assert(copy == small);
+}
+
+void normalizationTest(void) {
+
+    /* Cross-cancelled and Henrici results agree with arbitrary precision arithmetic */
+    uint32_t state = 12345;
+    auto next = [&state](void) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+    };
+    for(int idx = 0; idx < 200; ++idx) {
+	Rational r1 {next() % 1000, next() % 1000 + 1, (next() & 1) != 0};
+	Rational r2 {next() % 1000 + 1, next() % 1000 + 1, (next() & 1) != 0};
+	BigInt n1 = r1.isNegative() ? BigInt{r1.getBigNumerator()}.negate() : r1.getBigNumerator();
+	BigInt n2 = r2.isNegative() ? BigInt{r2.getBigNumerator()}.negate() : r2.getBigNumerator();
+	BigInt d1 = r1.getBigDenominator();
+	BigInt d2 = r2.getBigDenominator();
+	assert(r1 + r2 == Rational(n1 * d2 + n2 * d1, d1 * d2));
+	assert(r1 - r2 == Rational(n1 * d2 - n2 * d1, d1 * d2));
+	assert(r1 * r2 == Rational(n1 * n2, d1 * d2));
+	assert(r1 / r2 == Rational(n1 * d2, d1 * n2));
+    }
+
+    /* Deferred normalization keeps values exact and reduces them on output */
+    Rational r3 {1, 6};
+    Rational r4 {1, 3, true};
+    Rational sum;
+    {
+	Rational::DeferNormalization guard;
+	{
+	    Rational::DeferNormalization nested;
+	}
+	for(int idx = 0; idx < 12; ++idx) {
+	    sum += r3;
+	    sum -= r4 * r3;
+	}
+	assert(sum == Rational(8, 3) && !(sum < Rational(8, 3)) && sum > Rational(2));
+	assert(sum.getNumerator() == 8 && sum.getDenominator() == 3 && sum.toString() == "8/3");
+	sum -= Rational(8, 3);
+	assert(sum == Rational{} && !sum.isNegative());
+
+	/* Repeated products overflow without reduction, and are reduced instead of promoted */
+	Rational product {1};
+	for(int idx = 0; idx < 100; ++idx) {
+	    product *= Rational(6, 5);
+	    product *= Rational(5, 6);
+	}
+	assert(product.isSmall() && product == 1);
+    }
+    /* Outside of the guard, results are in lowest terms right away */
+    r3 += Rational(1, 6);
+    assert(r3.getNumerator() == 1 && r3.getDenominator() == 3);
+    r3.normalize();
+    assert(r3 == Rational(1, 3));
+}
+
+void parseTest(void) {
+
+    /* Decimals are exact */
+    assert(Rational::parse("0.125") == Rational(1, 8));
+    assert(Rational::parse("-2.75") == Rational(11, 4, true));
+    assert(Rational::parse("0.1") == Rational(1, 10));
+    assert(Rational::parse("+3.0") == 3);
+    assert(Rational::parse("00012") == 12);
+    assert(Rational::parse("-0") == 0);
+    assert(Rational::parse("+3/4") == Rational(3, 4));
+    assert(Rational::parse("-0/5") == 0);
+    std::string text {"7/21"};
+    assert(Rational{text} == Rational(1, 3));
+    assert(Rational{std::string_view{text}.substr(0, 3)} == Rational(7, 2));
+
+    /* Values beyond 64 bits */
+    assert(Rational::parse("-1208925819614629174706176/9").toString() == "-1208925819614629174706176/9");
+    assert(Rational::parse("1208925819614629174706176.5").toString() == "2417851639229258349412353/2");
+    assert(Rational::parse("0.00000000000000000000000001") == Rational(BigInt{1}, BigInt{"100000000000000000000000000"}));
+    assert(Rational::parse("18446744073709551615.5") == Rational(BigInt{"36893488147419103231"}, BigInt{2}));
+
+    /* The grammar is [-+]?digits(.digits)? or [-+]?digits/digits */
+    for(const char* invalid : {"", "+", "-", ".5", "1.", "1/", "/2", "1/2/3", "1.5/2", "--1", "1e5", " 1", "1 ", "0x10", "1/-2", "1,5"}) {
+	bool caught = false;
+	try {
+	    Rational::parse(invalid);
+	} catch(const std::exception& e) {
+	    caught = true;
+	}
+	assert(caught);
+    }
+    bool caught = false;
+    try {
+	Rational::parse("1/0");
+    } catch(const std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+}
+
 } /* anonymous */
 
 void rationalTest(void) {
@@ -452,6 +633,14 @@ void rationalTest(void) {
     std::puts("-> Passed arithmeticTest()");
     arithmeticTestNum();
     std::puts("-> Passed arithmeticTestNum()");
+    promotionTest();
+    std::puts("-> Passed promotionTest()");
+    normalizationTest();
+    std::puts("-> Passed normalizationTest()");
+    layoutTest();
+    std::puts("-> Passed layoutTest()");
+    parseTest();
+    std::puts("-> Passed parseTest()");
 
     std::puts("--- Rational Tests Passed ---");
 }
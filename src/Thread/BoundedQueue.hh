@@ -0,0 +1,90 @@
+/**
+ * @file BoundedQueue.hh
+ * @author Martin
+ * @brief File containing the blocking queue of bounded capacity connecting the stages of a pipeline
+*/
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <algorithm>
+#include <cstddef>
+
+/** First-in first-out queue shared between threads, holding at most a fixed number of items.
+  * Producers block while the queue is full and consumers while it is empty, so a fast stage can't run ahead of a slow one
+  * by more than the capacity. Once closed, no more items are accepted and consumers get the remaining items, then nothing.
+  */
+template <typename T>
+class BoundedQueue {
+
+    private:
+	/** The queued items */
+	std::deque<T> m_items;
+	/** The maximum number of queued items */
+	size_t m_capacity;
+	/** Whether the queue was closed */
+	bool m_closed = false;
+	/** Mutex guarding the items and the closed flag */
+	std::mutex m_mutex;
+	/** Condition variables producers wait on while the queue is full and consumers while it is empty */
+	std::condition_variable m_notFull;
+	std::condition_variable m_notEmpty;
+
+    public:
+	/** Constructor, creates an empty queue holding at most the given number of items (at least one) */
+	explicit BoundedQueue(size_t capacity) : m_capacity{std::max<size_t>(capacity, 1)} {}
+
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	/** Returns the maximum number of queued items */
+	size_t getCapacity(void) const {
+	    return m_capacity;
+	}
+
+	/** Returns the number of currently queued items */
+	size_t size(void) {
+	    std::lock_guard lock {m_mutex};
+	    return m_items.size();
+	}
+
+	/** Appends an item, blocking while the queue is full, returns false without queueing it if the queue was closed */
+	bool push(T item) {
+	    std::unique_lock lock {m_mutex};
+	    m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+	    if(m_closed)
+		return false;
+	    m_items.push_back(std::move(item));
+	    lock.unlock();
+	    m_notEmpty.notify_one();
+	    return true;
+	}
+
+	/** Removes the oldest item, blocking while the queue is empty, returns nothing once the queue is closed and empty */
+	std::optional<T> pop(void) {
+	    std::unique_lock lock {m_mutex};
+	    m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+	    if(m_items.empty())
+		return std::nullopt;
+	    std::optional<T> item {std::move(m_items.front())};
+	    m_items.pop_front();
+	    lock.unlock();
+	    m_notFull.notify_one();
+	    return item;
+	}
+
+	/** Closes the queue, waking all waiting producers and consumers */
+	void close(void) {
+	    {
+		std::lock_guard lock {m_mutex};
+		m_closed = true;
+	    }
+	    m_notFull.notify_all();
+	    m_notEmpty.notify_all();
+	}
+};
+
+#endif /* BOUNDED_QUEUE_H */
@@ -0,0 +1,134 @@
+/**
+ * @file Pipeline.hh
+ * @author Martin
+ * @brief File containing the ordered three-stage pipeline, a serial source, parallel workers and a serial sink
+*/
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <semaphore>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+#include "BoundedQueue.hh"
+
+/** Default capacity of the queues between the stages of a pipeline */
+#define PIPELINE_DEFAULT_CAPACITY 64
+
+/** Namespace containing the concurrent processing pipelines */
+namespace Pipeline {
+
+    /** Runs source, stage and sink concurrently over bounded queues, keeping the order of the items.
+      * The source runs on its own thread and returns items until it returns nothing, the given number of worker threads
+      * apply the stage to items as they arrive, and the sink runs on the calling thread, receiving the results in the order
+      * the source produced the items. Results that finish early wait in a reorder buffer, and the number of items between
+      * the source and the sink is limited, so memory stays bounded however slow a single item is. Throughput is then
+      * limited by the slowest stage rather than by the sum of all stages.
+      * The first exception thrown by any stage stops the pipeline and is rethrown once all threads are joined.
+      */
+    template <typename Source, typename Stage, typename Sink>
+    void runOrdered(size_t workers, Source source, Stage stage, Sink sink, size_t capacity = PIPELINE_DEFAULT_CAPACITY) {
+	using In = typename std::invoke_result_t<Source&>::value_type;
+	using Out = std::invoke_result_t<Stage&, In&&>;
+	workers = std::max<size_t>(workers, 1);
+	capacity = std::max<size_t>(capacity, 1);
+
+	/* Items are numbered by the source, so the sink can restore their order */
+	BoundedQueue<std::pair<size_t, In>> inputs {capacity};
+	BoundedQueue<std::pair<size_t, Out>> outputs {capacity};
+	/* Items between the source and the sink, which also bounds the reorder buffer */
+	const std::ptrdiff_t windowSize = static_cast<std::ptrdiff_t>((2 * capacity) + workers);
+	std::counting_semaphore<> window {windowSize};
+
+	std::atomic<bool> failed {false};
+	std::mutex errorMutex;
+	std::exception_ptr error;
+	/* Records the current exception and unblocks every stage */
+	auto fail = [&](void) {
+	    {
+		std::lock_guard lock {errorMutex};
+		if(!error)
+		    error = std::current_exception();
+		if(failed.exchange(true))
+		    return;
+	    }
+	    inputs.close();
+	    outputs.close();
+	    window.release(windowSize);
+	};
+
+	std::thread reader {[&](void) {
+	    try {
+		for(size_t idx = 0;; ++idx) {
+		    window.acquire();
+		    if(failed)
+			break;
+		    std::optional<In> item = source();
+		    if(!item || !inputs.push({idx, std::move(*item)}))
+			break;
+		}
+	    } catch(...) {
+		fail();
+	    }
+	    inputs.close();
+	}};
+
+	std::atomic<size_t> running {workers};
+	std::vector<std::thread> pool;
+	pool.reserve(workers);
+	for(size_t idx = 0; idx < workers; ++idx) {
+	    pool.emplace_back([&](void) {
+		try {
+		    while(!failed) {
+			std::optional<std::pair<size_t, In>> item = inputs.pop();
+			if(!item || !outputs.push({item->first, stage(std::move(item->second))}))
+			    break;
+		    }
+		} catch(...) {
+		    fail();
+		}
+		/* The last worker to finish ends the output */
+		if(running.fetch_sub(1) == 1)
+		    outputs.close();
+	    });
+	}
+
+	/* Hand the results to the sink in order, holding back the ones that overtook earlier items */
+	try {
+	    std::map<size_t, Out> pending;
+	    size_t next = 0;
+	    while(!failed) {
+		std::optional<std::pair<size_t, Out>> result = outputs.pop();
+		if(!result)
+		    break;
+		pending.emplace(result->first, std::move(result->second));
+		for(auto it = pending.find(next); it != pending.end() && !failed; it = pending.find(++next)) {
+		    sink(std::move(it->second));
+		    pending.erase(it);
+		    window.release();
+		}
+	    }
+	} catch(...) {
+	    fail();
+	}
+
+	reader.join();
+	for(std::thread& worker : pool) {
+	    worker.join();
+	}
+	if(error)
+	    std::rethrow_exception(error);
+    }
+
+} /* namespace Pipeline */
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,129 @@
+/**
+ * @file PipelineTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the bounded queue and the ordered pipeline
+*/
+
+#include "PipelineTest.hh"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+void boundedQueueTest(void) {
+
+    BoundedQueue<int> queue {3};
+    assert(queue.getCapacity() == 3);
+    assert(queue.push(1) && queue.push(2) && queue.push(3));
+    assert(queue.size() == 3);
+
+    /* A producer blocks on the full queue until a consumer makes room */
+    std::atomic<bool> pushed {false};
+    std::thread producer {[&queue, &pushed] {
+	queue.push(4);
+	pushed = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(!pushed);
+    assert(queue.pop() == 1);
+    producer.join();
+    assert(pushed && queue.size() == 3);
+
+    /* After closing, the remaining items are still handed out, then nothing, and pushes are refused */
+    queue.close();
+    assert(!queue.push(5));
+    assert(queue.pop() == 2 && queue.pop() == 3 && queue.pop() == 4);
+    assert(!queue.pop());
+
+    /* Closing wakes a waiting consumer */
+    BoundedQueue<std::string> empty {1};
+    std::thread consumer {[&empty] {
+	assert(!empty.pop());
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    empty.close();
+    consumer.join();
+}
+
+void orderTest(void) {
+
+    /* Results reach the sink in source order, even when later items finish first */
+    int next = 0;
+    auto source = [&next](void) -> std::optional<int> {
+	if(next == 200)
+	    return std::nullopt;
+	return next++;
+    };
+    auto stage = [](int&& value) {
+	if(value % 7 == 0)
+	    std::this_thread::sleep_for(std::chrono::microseconds(500));
+	return std::to_string(value * value);
+    };
+    std::vector<std::string> results;
+    Pipeline::runOrdered(4, source, stage, [&results](std::string&& result) { results.push_back(std::move(result)); }, 3);
+    assert(results.size() == 200);
+    for(int idx = 0; idx < 200; ++idx) {
+	assert(results[idx] == std::to_string(idx * idx));
+    }
+
+    /* An empty source and a single worker */
+    size_t calls = 0;
+    Pipeline::runOrdered(1, [](void) -> std::optional<int> { return std::nullopt; }, [](int&& value) { return value; },
+			 [&calls](int&&) { ++calls; });
+    assert(calls == 0);
+}
+
+void errorTest(void) {
+
+    /* The first exception of a stage stops the pipeline and is rethrown */
+    int next = 0;
+    auto source = [&next](void) -> std::optional<int> {
+	return next++;
+    };
+    auto stage = [](int&& value) {
+	if(value == 50)
+	    throw std::runtime_error {"Stage failed"};
+	return value;
+    };
+    int received = 0;
+    bool caught = false;
+    try {
+	Pipeline::runOrdered(3, source, stage, [&received](int&& value) { assert(value == received++); }, 4);
+    } catch(const std::exception& e) {
+	caught = std::string{e.what()} == "Stage failed";
+    }
+    assert(caught && received <= 50);
+
+    /* Also when thrown by the sink */
+    next = 0;
+    caught = false;
+    try {
+	Pipeline::runOrdered(2, source, [](int&& value) { return value; }, [](int&& value) {
+	    if(value == 10)
+		throw std::runtime_error {"Sink failed"};
+	});
+    } catch(const std::exception& e) {
+	caught = std::string{e.what()} == "Sink failed";
+    }
+    assert(caught);
+}
+
+} /* anonymous */
+
+void pipelineTest(void) {
+
+    std::puts("--- Pipeline TC Running ---");
+    boundedQueueTest();
+    std::puts("-> Passed boundedQueueTest()");
+    orderTest();
+    std::puts("-> Passed orderTest()");
+    errorTest();
+    std::puts("-> Passed errorTest()");
+    std::puts("--- Pipeline Tests Passed ---");
+}
@@ -0,0 +1,18 @@
+/**
+ * @file PipelineTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the bounded queue and the ordered pipeline
+*/
+#ifndef PIPELINE_TEST_H
+#define PIPELINE_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "BoundedQueue.hh"
+#include "Pipeline.hh"
+
+/** Function containing test cases for the bounded queue and the ordered pipeline */
+void pipelineTest(void);
+
+#endif /* PIPELINE_TEST_H */
@@ -0,0 +1,198 @@
+/**
+ * @file ThreadPool.hh
+ * @author Martin
+ * @brief File containing the persistent thread pool used to parallelize Matrix operations
+*/
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+/** Number of threads per hardware thread the global pool may be given at most */
+#define THREAD_POOL_MAX_THREADS_PER_CORE 8
+
+/** Persistent pool of worker threads, splitting index ranges between the workers and the calling thread */
+class ThreadPool {
+
+    private:
+	/** The worker threads, one fewer than the thread count as the calling thread also does work */
+	std::vector<std::thread> m_workers;
+	/** Queue of pending tasks */
+	std::deque<std::function<void(void)>> m_tasks;
+	/** Mutex guarding the task queue and the stop flag */
+	std::mutex m_mutex;
+	/** Condition variable the workers sleep on while the queue is empty */
+	std::condition_variable m_wake;
+	/** Whether the workers should exit */
+	bool m_stop = false;
+
+	/** Whether the current thread is inside a parallel section, nested sections then run serially to avoid deadlock */
+	static inline thread_local bool t_inParallel = false;
+
+	/** Loop run by each worker thread, executing tasks until the pool is stopped */
+	void workerLoop(void) {
+	    t_inParallel = true;
+	    while(true) {
+		std::function<void(void)> task;
+		{
+		    std::unique_lock lock {m_mutex};
+		    m_wake.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+		    if(m_stop && m_tasks.empty())
+			return;
+		    task = std::move(m_tasks.front());
+		    m_tasks.pop_front();
+		}
+		task();
+	    }
+	}
+
+	/** Pops and runs a single pending task on the calling thread, returns false if the queue was empty */
+	bool runPendingTask(void) {
+	    std::function<void(void)> task;
+	    {
+		std::lock_guard lock {m_mutex};
+		if(m_tasks.empty())
+		    return false;
+		task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+	    }
+	    task();
+	    return true;
+	}
+
+	/** Returns the storage of the global pool */
+	static std::unique_ptr<ThreadPool>& globalInstance(void) {
+	    static std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>(defaultThreadCount());
+	    return pool;
+	}
+
+    public:
+	/** Constructor, creates a pool using the given total number of threads (including the calling thread) */
+	explicit ThreadPool(size_t threads) {
+	    threads = std::max<size_t>(threads, 1);
+	    m_workers.reserve(threads - 1);
+	    for(size_t idx = 1; idx < threads; ++idx) {
+		m_workers.emplace_back([this] { workerLoop(); });
+	    }
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/** Destructor, finishes pending tasks and joins the workers */
+	~ThreadPool(void) {
+	    {
+		std::lock_guard lock {m_mutex};
+		m_stop = true;
+	    }
+	    m_wake.notify_all();
+	    for(std::thread& worker : m_workers) {
+		worker.join();
+	    }
+	}
+
+	/** Returns the total number of threads doing work in a parallel section */
+	size_t getThreadCount(void) const {
+	    return m_workers.size() + 1;
+	}
+
+	/** Runs body(chunkBegin, chunkEnd) over disjoint chunks covering [begin, end), with at least grain indices per chunk.
+	  * Blocks until all chunks are done, rethrowing the first exception thrown by any chunk.
+	  */
+	template <typename F>
+	void parallelFor(size_t begin, size_t end, size_t grain, const F& body) {
+	    if(end <= begin)
+		return;
+	    size_t count = end - begin;
+	    grain = std::max<size_t>(grain, 1);
+	    size_t chunks = std::min(getThreadCount(), (count + grain - 1) / grain);
+	    /* Small ranges and nested sections run on the calling thread */
+	    if(chunks <= 1 || t_inParallel) {
+		body(begin, end);
+		return;
+	    }
+	    size_t chunkSize = (count + chunks - 1) / chunks;
+	    chunks = (count + chunkSize - 1) / chunkSize;
+
+	    /* Completion state shared by all chunks of this call */
+	    std::atomic<size_t> remaining {chunks};
+	    std::mutex doneMutex;
+	    std::condition_variable done;
+	    std::exception_ptr error;
+
+	    auto runChunk = [&](size_t chunk) {
+		bool wasParallel = t_inParallel;
+		t_inParallel = true;
+		try {
+		    size_t chunkBegin = begin + chunk * chunkSize;
+		    body(chunkBegin, std::min(chunkBegin + chunkSize, end));
+		} catch(...) {
+		    std::lock_guard lock {doneMutex};
+		    if(!error)
+			error = std::current_exception();
+		}
+		t_inParallel = wasParallel;
+		/* Decrement under the lock, so the caller can't return and destroy this state before the notification */
+		std::lock_guard lock {doneMutex};
+		if(remaining.fetch_sub(1) == 1)
+		    done.notify_all();
+	    };
+
+	    /* Queue all but the first chunk, which the calling thread takes itself */
+	    {
+		std::lock_guard lock {m_mutex};
+		for(size_t chunk = 1; chunk < chunks; ++chunk) {
+		    m_tasks.emplace_back([&runChunk, chunk] { runChunk(chunk); });
+		}
+	    }
+	    m_wake.notify_all();
+	    runChunk(0);
+
+	    /* Help with pending tasks instead of idling, then wait for chunks still running on workers */
+	    while(remaining.load() > 0 && runPendingTask()) {}
+	    {
+		std::unique_lock lock {doneMutex};
+		done.wait(lock, [&remaining] { return remaining.load() == 0; });
+	    }
+	    if(error)
+		std::rethrow_exception(error);
+	}
+
+	/* --- Static members --- */
+
+	/** Returns the default thread count, the number of hardware threads available */
+	static size_t defaultThreadCount(void) {
+	    return std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	}
+
+	/** Returns the largest thread count accepted for the global pool, a few threads per hardware thread */
+	static size_t maxThreadCount(void) {
+	    return THREAD_POOL_MAX_THREADS_PER_CORE * defaultThreadCount();
+	}
+
+	/** Returns the global pool used by Matrix operations */
+	static ThreadPool& global(void) {
+	    return *globalInstance();
+	}
+
+	/** Replaces the global pool with one using the given number of threads, must not be called while the pool is in use */
+	static void setGlobalThreadCount(size_t threads) {
+	    std::unique_ptr<ThreadPool>& pool = globalInstance();
+	    if(pool->getThreadCount() != std::max<size_t>(threads, 1)) {
+		pool.reset();
+		pool = std::make_unique<ThreadPool>(threads);
+	    }
+	}
+};
+
+#endif /* THREAD_POOL_H */
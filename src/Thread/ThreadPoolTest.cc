@@ -0,0 +1,124 @@
+/**
+ * @file ThreadPoolTest.cc
+ * @author Martin
+ * @brief File containing test case implementations for the ThreadPool class
+*/
+
+#include "ThreadPoolTest.hh"
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+
+void parallelForTest(void) {
+
+    ThreadPool pool {4};
+    assert(pool.getThreadCount() == 4);
+
+    /* Every index must be visited exactly once */
+    std::vector<int> visits (10007, 0);
+    pool.parallelFor(0, visits.size(), 16, [&visits](size_t begin, size_t end) {
+	for(size_t idx = begin; idx < end; ++idx) {
+	    ++visits[idx];
+	}
+    });
+    for(int count : visits) {
+	assert(count == 1);
+    }
+
+    /* Empty and tiny ranges */
+    std::atomic<size_t> calls {0};
+    pool.parallelFor(5, 5, 1, [&calls](size_t, size_t) { ++calls; });
+    assert(calls == 0);
+    pool.parallelFor(0, 3, 100, [&calls](size_t begin, size_t end) { calls += end - begin; });
+    assert(calls == 3);
+
+    /* Nested sections run serially instead of deadlocking */
+    std::atomic<size_t> total {0};
+    pool.parallelFor(0, 8, 1, [&pool, &total](size_t begin, size_t end) {
+	for(size_t idx = begin; idx < end; ++idx) {
+	    pool.parallelFor(0, 100, 1, [&total](size_t b, size_t e) { total += e - b; });
+	}
+    });
+    assert(total == 800);
+}
+
+void exceptionTest(void) {
+
+    ThreadPool pool {3};
+    bool caught = false;
+    try {
+	pool.parallelFor(0, 300, 1, [](size_t begin, size_t) {
+	    if(begin >= 100)
+		throw std::runtime_error {"chunk failure"};
+	});
+    } catch(std::exception& e) {
+	caught = true;
+    }
+    assert(caught);
+
+    /* The pool stays usable after an exception */
+    std::atomic<size_t> count {0};
+    pool.parallelFor(0, 300, 1, [&count](size_t begin, size_t end) { count += end - begin; });
+    assert(count == 300);
+}
+
+void parallelMatrixTest(void) {
+
+    size_t oldThreads = ThreadPool::global().getThreadCount();
+    ThreadPool::setGlobalThreadCount(4);
+    assert(ThreadPool::global().getThreadCount() == 4);
+
+    /* A product large enough to be split, compared against the same product done on one thread */
+    const size_t n = 96;
+    Matrix<double> a {n, n + 3};
+    Matrix<double> b {n + 5, n};
+    for(size_t row = 0; row < a.getRows(); ++row) {
+	for(size_t col = 0; col < a.getCols(); ++col) {
+	    a.at(col, row) = static_cast<double>((row * 3 + col) % 7) - 3.0;
+	}
+    }
+    for(size_t row = 0; row < b.getRows(); ++row) {
+	for(size_t col = 0; col < b.getCols(); ++col) {
+	    b.at(col, row) = static_cast<double>((row + col * 5) % 9) - 4.0;
+	}
+    }
+    Matrix<double> parallel = a * b;
+    Matrix<double> wide = a * Matrix<double>{2 * n, n, 1.0};
+    ThreadPool::setGlobalThreadCount(1);
+    Matrix<double> serial = a * b;
+    Matrix<double> wideSerial = a * Matrix<double>{2 * n, n, 1.0};
+    assert(parallel == serial);
+    assert(wide == wideSerial);
+
+    /* Element-wise and Rational operations */
+    ThreadPool::setGlobalThreadCount(4);
+    Matrix<Rational> r1 {40, 30, "1/3"};
+    Matrix<Rational> r2 {30, 40, "3/2"};
+    Matrix<Rational> product = r1 * r2;
+    assert(product.getCols() == 30 && product.getRows() == 30 && product.at(29, 29) == 20);
+    Matrix<double> big {200, 200, 1.5};
+    big += Matrix<double>{200, 200, 0.5};
+    Matrix<double> scaled = 2.0 * big;
+    assert(big.at(199, 199) == 2.0 && scaled.at(0, 0) == 4.0 && scaled.at(199, 199) == 4.0);
+
+    ThreadPool::setGlobalThreadCount(oldThreads);
+}
+
+} /* anonymous */
+
+/** Function containing test cases for the ThreadPool class */
+void threadPoolTest(void) {
+
+    std::puts("--- ThreadPool TC Running ---");
+    parallelForTest();
+    std::puts("-> Passed parallelForTest()");
+    exceptionTest();
+    std::puts("-> Passed exceptionTest()");
+    parallelMatrixTest();
+    std::puts("-> Passed parallelMatrixTest()");
+
+    std::puts("--- ThreadPool Tests Passed ---");
+}
@@ -0,0 +1,19 @@
+/**
+ * @file ThreadPoolTest.hh
+ * @author Martin
+ * @brief File containing public test case declarations for the ThreadPool class
+*/
+#ifndef THREAD_POOL_TEST_H
+#define THREAD_POOL_TEST_H
+
+#include <iostream>
+#include <cassert>
+
+#include "ThreadPool.hh"
+#include "../Matrix/Matrix.hh"
+#include "../Rational/Rational.hh"
+
+/** Function containing test cases for the ThreadPool class */
+void threadPoolTest(void);
+
+#endif /* THREAD_POOL_TEST_H */
@@ -2,16 +2,63 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
 #include <algorithm>
 
 #include "Matrix/Matrix.hh"
 #include "Matrix/MatrixUtil.hh"
+#include "Matrix/MatrixExact.hh"
 #include "Rational/Rational.hh"
+#include "Thread/ThreadPool.hh"
+#include "IO/MatrixReader.hh"
+#include "IO/MatrixWriter.hh"
+#include "Thread/Pipeline.hh"
 
 #include "Rational/RationalTest.hh"
+#include "BigInt/BigIntTest.hh"
 #include "Matrix/MatrixTest.hh"
 #include "Matrix/MatrixUtilTest.hh"
+#include "Matrix/MatrixLUTest.hh"
+#include "Matrix/MatrixExactTest.hh"
+#include "Matrix/MatrixSoATest.hh"
+#include "Matrix/MatrixCommonDenTest.hh"
+#include "Matrix/SparseMatrixTest.hh"
+#include "Thread/ThreadPoolTest.hh"
+#include "Thread/PipelineTest.hh"
+#include "IO/MatrixReaderTest.hh"
+#include "IO/MatrixFileTest.hh"
+#include "IO/MatrixMarketTest.hh"
+#include "IO/MatrixLoaderTest.hh"
+#include "IO/MatrixWriterTest.hh"
+
+/** Elimination algorithm used by the reduction commands, set with --mode */
+MatrixReduce::Mode reduceMode = MatrixReduce::Mode::Standard;
+
+/** Format of printed matrices, set with --format */
+MatrixFormat outputFormat = MatrixFormat::Plain;
+
+/** A job of the batch mode, the matrices read for it or the error reading them */
+struct BatchJob {
+    std::vector<Matrix<Rational>> matrices;
+    std::string error;
+};
+
+/** Returns the number of matrices the given command takes in batch mode, zero for commands unavailable in batch mode */
+size_t batchArity(std::string_view command);
+
+/** Applies the batch command to the matrices of a job, returns the formatted result */
+std::string runBatchJob(std::string_view command, BatchJob& job);
+
+/** Runs the given command on every Matrix (or pair of matrices) of the input without interaction, printing the results in input order */
+int batch(std::string_view command);
+
+/** Prints the title followed by the Matrix in the output format and an empty line */
+void printMatrix(std::string_view title, const Matrix<Rational>& m);
 
 /** Asks the user to enter a Matrix and saves it into m */
 void enterMatrix(Matrix<Rational>& m);
@@ -37,6 +84,9 @@ void mul(void);
 /** Asks the user for a Matrix, prints its inverse if it exists */
 void invert(void);
 
+/** Asks the user for a square Matrix A and a Matrix B, prints the exact solution X of A * X = B */
+void solve(void);
+
 /** Runs Rational and Matrix TCs */
 void test(void);
 
@@ -45,17 +95,71 @@ void help(void);
 
 int main(int argc, char const ** argv) {
 
-    /* Display help info immediately if help asked */
+    /* Command to run in batch mode, set with --batch */
+    const char* batchCommand = nullptr;
+
+    /* Display help info immediately if help asked, apply other command line options */
     for(int i = 0; i < argc; ++i) {
 	if(std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
 	    help();
 	    return 0;
+	} else if(std::strcmp(argv[i], "--threads") == 0) {
+	    /* Set the number of threads used by Matrix operations */
+	    char* end = nullptr;
+	    /* strtoul takes a sign and wraps negative numbers around, so only digits are accepted */
+	    unsigned long threads = (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) ? std::strtoul(argv[i + 1], &end, 10) : 0;
+	    if(threads == 0 || *end != '\0' || threads > ThreadPool::maxThreadCount()) {
+		std::puts("Error: --threads expects a positive number of threads");
+		return 1;
+	    }
+	    ThreadPool::setGlobalThreadCount(threads);
+	    ++i;
+	} else if(std::strcmp(argv[i], "--mode") == 0) {
+	    /* Set the elimination algorithm used by the reduction commands */
+	    const char* mode = (i + 1 < argc) ? argv[i + 1] : "";
+	    if(std::strcmp(mode, "standard") == 0) {
+		reduceMode = MatrixReduce::Mode::Standard;
+	    } else if(std::strcmp(mode, "fraction-free") == 0) {
+		reduceMode = MatrixReduce::Mode::FractionFree;
+	    } else if(std::strcmp(mode, "modular") == 0) {
+		reduceMode = MatrixReduce::Mode::Modular;
+	    } else if(std::strcmp(mode, "batched") == 0) {
+		reduceMode = MatrixReduce::Mode::Batched;
+	    } else if(std::strcmp(mode, "common-denominator") == 0) {
+		reduceMode = MatrixReduce::Mode::CommonDenominator;
+	    } else if(std::strcmp(mode, "sparse") == 0) {
+		reduceMode = MatrixReduce::Mode::Sparse;
+	    } else {
+		std::puts("Error: --mode expects one of: standard, fraction-free, modular, batched, common-denominator, sparse");
+		return 1;
+	    }
+	    ++i;
+	} else if(std::strcmp(argv[i], "--format") == 0) {
+	    /* Set the format of printed matrices */
+	    try {
+		outputFormat = MatrixWriter::parseFormat((i + 1 < argc) ? argv[i + 1] : "");
+	    } catch(std::exception&) {
+		std::puts("Error: --format expects one of: plain, csv, json");
+		return 1;
+	    }
+	    ++i;
+	} else if(std::strcmp(argv[i], "--batch") == 0) {
+	    /* Run a single command on the whole input instead of the interactive prompt */
+	    batchCommand = (i + 1 < argc) ? argv[i + 1] : "";
+	    if(batchArity(batchCommand) == 0) {
+		std::puts("Error: --batch expects one of: ref, rref, forms, invert, add, sub, mul, solve");
+		return 1;
+	    }
+	    ++i;
 	}
     }
 
+    if(batchCommand != nullptr)
+	return batch(batchCommand);
+
     /* Intro Text */
     std::puts("=== C++ Matrix (Gauss-Jordan Elimination) Solver ===");
-    std::puts("Enter command (ref/rref/forms/add/sub/mul/invert/test/help/exit)");
+    std::puts("Enter command (ref/rref/forms/add/sub/mul/invert/solve/test/help/exit)");
 
     /* Scanning command input from the user until exit */
     bool run = true;
@@ -77,6 +181,8 @@ int main(int argc, char const ** argv) {
 	    mul();
 	} else if(userIn == "invert") {
 	    invert();
+	} else if(userIn == "solve") {
+	    solve();
 	} else if(userIn == "test") {
 	    test();
 	} else if(userIn == "help") {
@@ -95,41 +201,22 @@ int main(int argc, char const ** argv) {
 
 /* --- Function Implementations --- */
 
+void printMatrix(std::string_view title, const Matrix<Rational>& m) {
+    /* The writer keeps its buffer across matrices, and is flushed before anything else is printed */
+    static MatrixWriter output {stdout};
+    output.setFormat(outputFormat);
+    output.write(title).write(m).write("\n").flush();
+}
+
 void enterMatrix(Matrix<Rational>& m) {
+    /* The reader keeps its line buffer across matrices */
+    static MatrixReader reader {std::cin};
     bool entered = false;
     while(!entered) {
 	try {
 	    std::puts("Enter Matrix (space separated Rational numbers, new line makes a new row, type DONE on a new line to stop):");
-	    /* Going through user input row by row and saving to get full Matrix */
-	    std::string matrix;
-	    while(true) {
-		std::string row;
-		std::getline(std::cin, row);
-		if(row == "DONE" || row == "done")
-		    break;
-		matrix += row + "\n";
-	    }
-	    /* Processing user input to resize and populate Matrix */
-	    size_t rows = static_cast<size_t>(std::count(matrix.begin(), matrix.end(), '\n'));
-	    size_t cols = static_cast<size_t>(std::count(matrix.begin(), std::find(matrix.begin(), matrix.end(), '\n'), ' ')) + 1;
-	    m.resize(cols, rows);
-	    /* Go through user input to populate Matrix with the correct values */
-	    size_t col = 0, row = 0;
-	    std::string number;
-	    for(char c : matrix) {
-		if(c == '\n' || c == ' ') {
-		    m.at(col, row) = number;
-		    number = "";
-		    if(c == '\n') {
-			col = 0;
-			++row;
-		    } else {
-			++col;
-		    }
-		} else {
-		    number += c;
-		}
-	    }
+	    /* Rows are parsed as they are entered, straight into the Matrix */
+	    m = reader.read();
 	    entered = true;
 	} catch(std::exception& e) {
 	    std::printf("Error Entering Matrix: %s\nPlease Try Again!\n", e.what());
@@ -137,12 +224,115 @@ void enterMatrix(Matrix<Rational>& m) {
     }
 }
 
+size_t batchArity(std::string_view command) {
+    if(command == "ref" || command == "rref" || command == "forms" || command == "invert")
+	return 1;
+    if(command == "add" || command == "sub" || command == "mul" || command == "solve")
+	return 2;
+    return 0;
+}
+
+std::string runBatchJob(std::string_view command, BatchJob& job) {
+    if(!job.error.empty())
+	return "Error: " + job.error + "\n\n";
+    auto print = [](const Matrix<Rational>& m) {
+	std::string result;
+	MatrixWriter::append(result, m, outputFormat);
+	return result + "\n";
+    };
+    try {
+	Matrix<Rational>& m = job.matrices[0];
+	if(command == "ref")
+	    return MatrixReduce::toREF(m, reduceMode) ? print(m) : "Error Reducing Matrix to REF!\n\n";
+	if(command == "rref")
+	    return MatrixReduce::toRREF(m, reduceMode) ? print(m) : "Error Reducing Matrix to RREF!\n\n";
+	if(command == "forms") {
+	    if(!MatrixReduce::toREF(m, reduceMode))
+		return "Error Reducing Matrix to REF!\n\n";
+	    std::string result = print(m);
+	    return MatrixReduce::toRREF(m, reduceMode) ? result + print(m) : result + "Error Reducing Matrix to RREF!\n\n";
+	}
+	if(command == "invert")
+	    return MatrixReduce::invert(m) ? print(m) : "Matrix Inverse Does Not Exist, or Could Not Be Found\n\n";
+	if(command == "add")
+	    return print(m += job.matrices[1]);
+	if(command == "sub")
+	    return print(m -= job.matrices[1]);
+	if(command == "mul")
+	    return print(m *= job.matrices[1]);
+	Matrix<Rational> x;
+	return MatrixReduce::solve(m, job.matrices[1], x) ? print(x) : "No Unique Solution, A Is Not Square or Singular\n\n";
+    } catch(std::exception& e) {
+	return "Error: " + std::string{e.what()} + "\n\n";
+    }
+}
+
+int batch(std::string_view command) {
+    /* Only C stdio is used for output, so the C++ streams don't need to stay in sync with it */
+    std::ios::sync_with_stdio(false);
+    MatrixReader reader {std::cin};
+    size_t arity = batchArity(command);
+
+    /* Parsing stage, reads the matrices of one job at a time */
+    auto parse = [&](void) -> std::optional<BatchJob> {
+	BatchJob job;
+	while(job.matrices.size() < arity) {
+	    try {
+		Matrix<Rational> m = reader.read();
+		if(m.getRows() == 0 && reader.isAtEnd()) {
+		    if(job.matrices.empty() && job.error.empty())
+			return std::nullopt;
+		    /* A Matrix of the job that failed to parse keeps its own error */
+		    if(job.error.empty())
+			job.error = "Missing Matrix at the end of the input";
+		    return job;
+		}
+		job.matrices.push_back(std::move(m));
+	    } catch(std::exception& e) {
+		/* The other matrices of the job are still read, so the next job starts at the right Matrix */
+		if(job.error.empty())
+		    job.error = e.what();
+		job.matrices.emplace_back();
+	    }
+	}
+	return job;
+    };
+    /* Solving and formatting stage, run for several jobs at once */
+    auto run = [command](BatchJob&& job) {
+	return runBatchJob(command, job);
+    };
+    /* Printing stage, gets the results in input order and collects them into larger writes */
+    MatrixWriter output {stdout, outputFormat};
+    auto write = [&output](std::string&& result) {
+	output.write(result);
+    };
+
+    std::string error;
+    try {
+	Pipeline::runOrdered(ThreadPool::global().getThreadCount(), parse, run, write);
+    } catch(std::exception& e) {
+	error = e.what();
+    }
+    /* The results before an error are still printed ahead of it */
+    try {
+	output.flush();
+    } catch(std::exception& e) {
+	if(error.empty())
+	    error = e.what();
+    }
+    if(!error.empty()) {
+	std::printf("Batch Error: %s\n", error.c_str());
+	return 1;
+    }
+    return 0;
+}
+
 void ref(void) {
     Matrix<Rational> m;
     enterMatrix(m);
-    std::printf("Entered Matrix:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
-    if(MatrixReduce::toREF(m))
-        std::printf("Matrix in REF:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrix:\n", m);
+    if(MatrixReduce::toREF(m, reduceMode))
+        printMatrix("Matrix in REF:\n", m);
     else
 	std::puts("Error Reducing Matrix to REF!");
 }
@@ -150,9 +340,9 @@ void ref(void) {
 void rref(void) {
     Matrix<Rational> m;
     enterMatrix(m);
-    std::printf("Entered Matrix:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
-    if(MatrixReduce::toRREF(m))
-        std::printf("Matrix in RREF:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrix:\n", m);
+    if(MatrixReduce::toRREF(m, reduceMode))
+        printMatrix("Matrix in RREF:\n", m);
     else
 	std::puts("Error Reducing Matrix to RREF!");
 }
@@ -160,15 +350,15 @@ void rref(void) {
 void forms(void) {
     Matrix<Rational> m;
     enterMatrix(m);
-    std::printf("Entered Matrix:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
-    if(!MatrixReduce::toREF(m)) {
+    printMatrix("Entered Matrix:\n", m);
+    if(!MatrixReduce::toREF(m, reduceMode)) {
 	std::puts("Error Reducing Matrix to REF!");
 	return;
     } else {
-        std::printf("Matrix in REF:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+        printMatrix("Matrix in REF:\n", m);
     }
-    if(MatrixReduce::REFtoRREF(m))
-        std::printf("Matrix in RREF:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+    if(MatrixReduce::toRREF(m, reduceMode))
+        printMatrix("Matrix in RREF:\n", m);
     else
 	std::puts("Error Reducing Matrix to RREF!");
 }
@@ -180,10 +370,11 @@ void add(void) {
     std::puts("2.");
     Matrix<Rational> m2;
     enterMatrix(m2);
-    std::printf("Entered Matrices:\n%s\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str(), m2.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrices:\n", m1);
+    printMatrix("", m2);
     try {
         m1 += m2;
-	std::printf("Sum:\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str());
+	printMatrix("Sum:\n", m1);
     } catch(std::exception& e) {
 	std::printf("Matrix Addition Error: %s\n", e.what());
     }
@@ -196,10 +387,11 @@ void sub(void) {
     std::puts("2.");
     Matrix<Rational> m2;
     enterMatrix(m2);
-    std::printf("Entered Matrices:\n%s\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str(), m2.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrices:\n", m1);
+    printMatrix("", m2);
     try {
         m1 -= m2;
-	std::printf("Difference (Matrix1 - Matrix2):\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str());
+	printMatrix("Difference (Matrix1 - Matrix2):\n", m1);
     } catch(std::exception& e) {
 	std::printf("Matrix Subtraction Error: %s\n", e.what());
     }
@@ -212,10 +404,11 @@ void mul(void) {
     std::puts("2.");
     Matrix<Rational> m2;
     enterMatrix(m2);
-    std::printf("Entered Matrices:\n%s\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str(), m2.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrices:\n", m1);
+    printMatrix("", m2);
     try {
         m1 *= m2;
-	std::printf("Product:\n%s\n", m1.print([](Rational r) { return r.toString(); }).c_str());
+	printMatrix("Product:\n", m1);
     } catch(std::exception& e) {
 	std::printf("Matrix Multiplication Error: %s\n", e.what());
     }
@@ -224,23 +417,82 @@ void mul(void) {
 void invert(void) {
     Matrix<Rational> m;
     enterMatrix(m);
-    std::printf("Entered Matrix:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+    printMatrix("Entered Matrix:\n", m);
     if(MatrixReduce::invert(m)) {
-	std::printf("Inverse:\n%s\n", m.print([](Rational r) { return r.toString(); }).c_str());
+	printMatrix("Inverse:\n", m);
     } else {
 	std::puts("Matrix Inverse Does Not Exist, or Could Not Be Found");
     }
 }
 
+void solve(void) {
+    std::puts("A.");
+    Matrix<Rational> a;
+    enterMatrix(a);
+    std::puts("B.");
+    Matrix<Rational> b;
+    enterMatrix(b);
+    printMatrix("Entered Matrices:\n", a);
+    printMatrix("", b);
+    try {
+	Matrix<Rational> x;
+	if(MatrixReduce::solve(a, b, x))
+	    printMatrix("Solution X:\n", x);
+	else
+	    std::puts("No Unique Solution, A Is Not Square or Singular");
+    } catch(std::exception& e) {
+	std::printf("Error Solving: %s\n", e.what());
+    }
+}
+
 void test(void) {
     /* Calling all Rational test cases */
     rationalTest();
 
+    /* Calling all BigInt test cases */
+    bigIntTest();
+
     /* Calling all Matrix test cases */
     matrixTest();
 
     /* Calling all MatrixUtil test cases */
     matrixUtilTest();
+
+    /* Calling all LU factorization test cases */
+    matrixLUTest();
+
+    /* Calling all exact reduction test cases */
+    matrixExactTest();
+
+    /* Calling all structure-of-arrays Matrix test cases */
+    matrixSoATest();
+
+    /* Calling all common-denominator Matrix test cases */
+    matrixCommonDenTest();
+
+    /* Calling all sparse Matrix test cases */
+    sparseMatrixTest();
+
+    /* Calling all ThreadPool test cases */
+    threadPoolTest();
+
+    /* Calling all Pipeline test cases */
+    pipelineTest();
+
+    /* Calling all Matrix reader test cases */
+    matrixReaderTest();
+
+    /* Calling all binary Matrix file test cases */
+    matrixFileTest();
+
+    /* Calling all Matrix Market test cases */
+    matrixMarketTest();
+
+    /* Calling all parallel Matrix loader test cases */
+    matrixLoaderTest();
+
+    /* Calling all Matrix writer test cases */
+    matrixWriterTest();
 }
 
 void help(void) {
@@ -254,13 +506,23 @@ void help(void) {
 	      "   -> sub ..... subtract two matrices\n"
 	      "   -> mul ..... multiply two matrices\n"
 	      "   -> invert .. get the inverse of a given matrix\n"
+	      "   -> solve ... solve A * X = B exactly for a square matrix A\n"
 	      "   -> test .... run program utility test cases\n"
 	      "   -> help .... display this help info\n"
 	      "   -> exit .... quit the program\n"
+	      " -> Command line options:\n"
+	      "   -> --threads <N> ... use N threads for Matrix operations (default: all hardware threads, at most 8 per hardware thread)\n"
+	      "   -> --mode <M> ...... elimination used by ref/rref/forms: standard (default), fraction-free, modular, batched, common-denominator or sparse\n"
+	      "   -> --format <F> .... print matrices as plain (default), csv or json\n"
+	      "   -> --batch <C> ..... run the command C (ref, rref, forms, invert, add, sub, mul or solve) on every Matrix of the input,\n"
+	      "                        without prompts, until the end of the input; commands taking two matrices read them in pairs\n"
+	      "   -> -h, --help ...... display this help info and exit\n"
 	      " -> Entering Matrices:\n"
 	      "   -> enter rational numbers in format [-]<A>[/<B>]\n"
 	      "      (A is the numerator, B the denominator, anything in '[]' is optional, anything in '<>' is mandatory, exclude the brackets when entering numbers)\n"
 	      "   -> separate each new number in the same row with a single space, end row with a line break\n"
-	      "   -> end Matrix input by typing DONE or done on a new line"
+	      "   -> end Matrix input by typing DONE or done on a new line\n"
+	      "   -> a Matrix can also be entered in the Matrix Market format, starting with its %%MatrixMarket banner line\n"
+	      "   -> or loaded from a file by entering @<path> in place of its first row, a text file parsed in parallel or a binary Matrix file"
     );
 }